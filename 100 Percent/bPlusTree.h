@@ -0,0 +1,864 @@
+/***********************************************************************
+ * Header:
+ *    B PLUS TREE
+ * Summary:
+ *    An ordered container with the interface of BST whose nodes are
+ *    512 bytes and hold sorted arrays of elements instead of one apiece.
+ *    A find touches one node per level and there are only a handful of
+ *    levels: a hundred million ints fit in a tree four or five deep
+ *    where a binary tree is twenty-seven. The elements themselves live
+ *    only in the leaves, which are linked to each other, so iterating is
+ *    a walk along the leaves.
+ *
+ *    This will contain the class definition of:
+ *        BPlusTree           : A B+ tree
+ *        BPlusTree::iterator : An iterator through BPlusTree
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <algorithm>  // for std::max and std::move_backward
+#include <memory>     // for std::allocator
+#include <new>        // for placement new and std::launder
+#include <utility>    // for std::pair
+#include "bst.h"
+#include "nodeSearch.h"
+
+class TestBPlusTree; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************************************
+ * B PLUS TREE
+ * Inner nodes hold separators that steer a search; every element
+ * is in a leaf. Duplicates are allowed and go after their equals.
+ *****************************************************************/
+template <typename T, typename A = std::allocator<T> >
+class BPlusTree
+{
+   friend class ::TestBPlusTree; // give unit tests access to the privates
+
+public:
+   //
+   // Construct
+   //
+
+   BPlusTree() : pRoot(nullptr), pFirst(nullptr), pLast(nullptr), numElements(0) {}
+   explicit BPlusTree(const A & alloc) : pRoot(nullptr), pFirst(nullptr), pLast(nullptr),
+                                         numElements(0), alloc(alloc) {}
+   BPlusTree(const BPlusTree &  rhs);
+   BPlusTree(      BPlusTree && rhs);
+   template <typename B>
+   explicit BPlusTree(const BST <T, A, B> & rhs);
+   ~BPlusTree() { clear(); }
+
+   //
+   // Assign
+   //
+
+   BPlusTree & operator = (const BPlusTree &  rhs);
+   BPlusTree & operator = (      BPlusTree && rhs);
+   void swap(BPlusTree & rhs);
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() const noexcept { return iterator(this, pFirst, 0); }
+   iterator end()   const noexcept { return iterator(this, nullptr, 0); }
+
+   //
+   // Access
+   //
+
+   iterator find(const T & t) const;
+
+   //
+   // Insert
+   //
+
+   std::pair<iterator, bool> insert(const T &  t, bool keepUnique = false);
+   std::pair<iterator, bool> insert(      T && t, bool keepUnique = false);
+
+   //
+   // Remove
+   //
+
+   iterator erase(iterator & it);
+   void clear() noexcept;
+
+   //
+   // Status
+   //
+
+   bool   empty() const noexcept { return numElements == 0; }
+   size_t size()  const noexcept { return numElements;      }
+   A      get_allocator() const noexcept { return alloc;    }
+
+private:
+   // as many elements or children as fit in a node of nodeBytes
+   static constexpr size_t nodeBytes = 512;
+   static constexpr size_t leafCapacity =
+      std::max<size_t>(3, (nodeBytes - 32) / sizeof(T));
+   static constexpr size_t innerCapacity =
+      std::max<size_t>(3, (nodeBytes - 24) / (sizeof(T) + sizeof(void *)));
+
+   // every node but the root is kept about half full: a split inner
+   // node sends its middle separator up, so each half has one fewer
+   static constexpr size_t leafMin  = leafCapacity  / 2;
+   static constexpr size_t innerMin = (innerCapacity - 1) / 2;
+
+   struct Inner;
+   struct Node
+   {
+      Node(bool isLeaf) : pParent(nullptr), numKeys(0), isLeaf(isLeaf) {}
+      Inner * pParent;
+      unsigned short numKeys;
+      bool isLeaf;
+   };
+
+   // the elements, in order, and the leaves on either side
+   struct Leaf : public Node
+   {
+      Leaf() : Node(true), pPrev(nullptr), pNext(nullptr) {}
+      T * keys() { return std::launder(reinterpret_cast<T *>(storage)); }
+      const T * keys() const { return std::launder(reinterpret_cast<const T *>(storage)); }
+      Leaf * pPrev;
+      Leaf * pNext;
+      alignas(T) unsigned char storage[leafCapacity * sizeof(T)];
+   };
+
+   // children[i] holds what is between keys[i - 1] and keys[i]
+   struct Inner : public Node
+   {
+      Inner() : Node(false) {}
+      T * keys() { return std::launder(reinterpret_cast<T *>(storage)); }
+      const T * keys() const { return std::launder(reinterpret_cast<const T *>(storage)); }
+      Node * children[innerCapacity + 1];
+      alignas(T) unsigned char storage[innerCapacity * sizeof(T)];
+   };
+
+   // where the element after an erased one ends up
+   struct Cursor
+   {
+      Leaf * pLeaf;
+      size_t index;
+   };
+
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Leaf>  LeafAlloc;
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Inner> InnerAlloc;
+
+   template <typename U>
+   std::pair<iterator, bool> insertNode(U && t, bool keepUnique);
+   void splitLeaf(Leaf * pLeaf);
+   void insertUp(Node * pLeft, T && separator, Node * pRight);
+   void rebalanceLeaf(Leaf * pLeaf, Cursor & cursor);
+   void rebalanceInner(Inner * pInner);
+   void removeChild(Inner * pInner, size_t iKey);
+   Node * cloneNode(const Node * pSrc, Inner * pParent);
+   void deleteNode(Node * pNode);
+   size_t height() const;
+
+   Leaf  * newLeaf();
+   Inner * newInner();
+   void    deleteLeaf(Leaf * pLeaf);
+   void    deleteInner(Inner * pInner);
+
+   static size_t childIndex(const Inner * pInner, const Node * pChild);
+   template <typename U>
+   static void insertKey(T * keys, size_t num, size_t i, U && t);
+   static void eraseKey(T * keys, size_t num, size_t i);
+   static void moveKeys(T * pDest, T * pSrc, size_t num);
+
+   Node * pRoot;          // a leaf or an inner node, or nullptr when empty
+   Leaf * pFirst;         // the left-most leaf, where begin() is
+   Leaf * pLast;          // the right-most leaf, where --end() is
+   size_t numElements;    // number of elements in all the leaves
+   A alloc;               // where the nodes come from
+};
+
+/**********************************************************
+ * B PLUS TREE ITERATOR
+ * Forward and reverse iterator along the leaves
+ *********************************************************/
+template <typename T, typename A>
+class BPlusTree <T, A> :: iterator
+{
+   friend class ::TestBPlusTree; // give unit tests access to the privates
+   friend class BPlusTree <T, A>;
+public:
+   // constructors and assignment
+   iterator() : pTree(nullptr), pLeaf(nullptr), index(0) {}
+
+   // compare
+   bool operator == (const iterator & rhs) const { return pLeaf == rhs.pLeaf && index == rhs.index; }
+   bool operator != (const iterator & rhs) const { return !(*this == rhs); }
+
+   // de-reference. Cannot change because it will invalidate the tree
+   const T & operator * () const { return pLeaf->keys()[index]; }
+
+   // increment and decrement
+   iterator & operator ++ ()
+   {
+      if (++index == pLeaf->numKeys)
+      {
+         pLeaf = pLeaf->pNext;
+         index = 0;
+      }
+      return *this;
+   }
+   iterator operator ++ (int)
+   {
+      iterator old = *this;
+      ++*this;
+      return old;
+   }
+   iterator & operator -- ()
+   {
+      if (pLeaf == nullptr || index == 0)
+      {
+         pLeaf = pLeaf ? pLeaf->pPrev : pTree->pLast;
+         index = pLeaf ? pLeaf->numKeys - 1 : 0;
+      }
+      else
+         index--;
+      return *this;
+   }
+   iterator operator -- (int)
+   {
+      iterator old = *this;
+      --*this;
+      return old;
+   }
+
+private:
+   iterator(const BPlusTree * pTree, Leaf * pLeaf, size_t index) :
+      pTree(pTree), pLeaf(pLeaf), index(index) {}
+
+   const BPlusTree * pTree;
+   Leaf * pLeaf;
+   size_t index;
+};
+
+/*********************************************
+ * B PLUS TREE :: COPY CONSTRUCTOR
+ * Copy the nodes as they are: no element is compared
+ ********************************************/
+template <typename T, typename A>
+BPlusTree <T, A> :: BPlusTree(const BPlusTree & rhs) :
+   pRoot(nullptr), pFirst(nullptr), pLast(nullptr), numElements(0),
+   alloc(std::allocator_traits<A>::select_on_container_copy_construction(rhs.alloc))
+{
+   if (rhs.pRoot)
+      pRoot = cloneNode(rhs.pRoot, nullptr);
+   numElements = rhs.numElements;
+}
+
+/*********************************************
+ * B PLUS TREE :: MOVE CONSTRUCTOR
+ ********************************************/
+template <typename T, typename A>
+BPlusTree <T, A> :: BPlusTree(BPlusTree && rhs) :
+   pRoot(rhs.pRoot), pFirst(rhs.pFirst), pLast(rhs.pLast),
+   numElements(rhs.numElements), alloc(std::move(rhs.alloc))
+{
+   rhs.pRoot = nullptr;
+   rhs.pFirst = rhs.pLast = nullptr;
+   rhs.numElements = 0;
+}
+
+/*********************************************
+ * B PLUS TREE :: CONSTRUCT from a BST
+ * The elements arrive in order, so each one goes at
+ * the end of the last leaf
+ ********************************************/
+template <typename T, typename A>
+template <typename B>
+BPlusTree <T, A> :: BPlusTree(const BST <T, A, B> & rhs) :
+   pRoot(nullptr), pFirst(nullptr), pLast(nullptr), numElements(0),
+   alloc(rhs.get_allocator())
+{
+   for (auto it = rhs.begin(); it != rhs.end(); ++it)
+      insert(*it);
+}
+
+/*********************************************
+ * B PLUS TREE :: ASSIGNMENT
+ ********************************************/
+template <typename T, typename A>
+BPlusTree <T, A> & BPlusTree <T, A> :: operator = (const BPlusTree & rhs)
+{
+   if (this == &rhs)
+      return *this;
+   clear();
+   if constexpr (std::allocator_traits<A>::propagate_on_container_copy_assignment::value)
+      alloc = rhs.alloc;
+   if (rhs.pRoot)
+      pRoot = cloneNode(rhs.pRoot, nullptr);
+   numElements = rhs.numElements;
+   return *this;
+}
+
+/*********************************************
+ * B PLUS TREE :: ASSIGN-MOVE OPERATOR
+ * Take the nodes of rhs, or copy them if our allocators
+ * neither propagate nor agree and so cannot share nodes
+ ********************************************/
+template <typename T, typename A>
+BPlusTree <T, A> & BPlusTree <T, A> :: operator = (BPlusTree && rhs)
+{
+   if (this == &rhs)
+      return *this;
+   clear();
+
+   if (!std::allocator_traits<A>::propagate_on_container_move_assignment::value &&
+       !(alloc == rhs.alloc))
+   {
+      *this = rhs;
+      rhs.clear();
+      return *this;
+   }
+
+   if constexpr (std::allocator_traits<A>::propagate_on_container_move_assignment::value)
+      alloc = std::move(rhs.alloc);
+   std::swap(pRoot, rhs.pRoot);
+   std::swap(pFirst, rhs.pFirst);
+   std::swap(pLast, rhs.pLast);
+   std::swap(numElements, rhs.numElements);
+   return *this;
+}
+
+/*********************************************
+ * B PLUS TREE :: SWAP
+ ********************************************/
+template <typename T, typename A>
+void BPlusTree <T, A> :: swap(BPlusTree & rhs)
+{
+   std::swap(pRoot, rhs.pRoot);
+   std::swap(pFirst, rhs.pFirst);
+   std::swap(pLast, rhs.pLast);
+   std::swap(numElements, rhs.numElements);
+   if constexpr (std::allocator_traits<A>::propagate_on_container_swap::value)
+      std::swap(alloc, rhs.alloc);
+}
+
+/*********************************************
+ * B PLUS TREE :: FIND
+ * Steer to the first element not less than t, one
+ * node search per level, then see if it is t
+ ********************************************/
+template <typename T, typename A>
+typename BPlusTree <T, A> :: iterator BPlusTree <T, A> :: find(const T & t) const
+{
+   if (pRoot == nullptr)
+      return end();
+
+   const Node * pNode = pRoot;
+   while (!pNode->isLeaf)
+   {
+      const Inner * pInner = static_cast<const Inner *>(pNode);
+      size_t i = nodeSearch::lowerBound(pInner->keys(), pInner->numKeys, t);
+      pNode = pInner->children[i];
+   }
+
+   // separators equal to t may send us one leaf early
+   Leaf * pLeaf = const_cast<Leaf *>(static_cast<const Leaf *>(pNode));
+   size_t i = nodeSearch::lowerBound(pLeaf->keys(), pLeaf->numKeys, t);
+   if (i == pLeaf->numKeys)
+   {
+      pLeaf = pLeaf->pNext;
+      i = 0;
+   }
+   if (pLeaf && pLeaf->keys()[i] == t)
+      return iterator(this, pLeaf, i);
+   return end();
+}
+
+/*********************************************
+ * B PLUS TREE :: INSERT
+ * Insert a value, after any equal to it
+ ********************************************/
+template <typename T, typename A>
+std::pair<typename BPlusTree <T, A> :: iterator, bool> BPlusTree <T, A> :: insert(const T & t, bool keepUnique)
+{
+   return insertNode(t, keepUnique);
+}
+
+template <typename T, typename A>
+std::pair<typename BPlusTree <T, A> :: iterator, bool> BPlusTree <T, A> :: insert(T && t, bool keepUnique)
+{
+   return insertNode(std::move(t), keepUnique);
+}
+
+/*********************************************
+ * B PLUS TREE :: INSERT NODE
+ * Steer to the leaf where t belongs and put it there,
+ * splitting the leaf first if it is full
+ ********************************************/
+template <typename T, typename A>
+template <typename U>
+std::pair<typename BPlusTree <T, A> :: iterator, bool> BPlusTree <T, A> :: insertNode(U && t, bool keepUnique)
+{
+   if (keepUnique)
+   {
+      iterator it = find(t);
+      if (it != end())
+         return std::pair<iterator, bool>(it, false);
+   }
+
+   if (pRoot == nullptr)
+      pRoot = pFirst = pLast = newLeaf();
+
+   Node * pNode = pRoot;
+   while (!pNode->isLeaf)
+   {
+      Inner * pInner = static_cast<Inner *>(pNode);
+      size_t i = nodeSearch::upperBound(pInner->keys(), pInner->numKeys, t);
+      pNode = pInner->children[i];
+   }
+
+   Leaf * pLeaf = static_cast<Leaf *>(pNode);
+   size_t i = nodeSearch::upperBound(pLeaf->keys(), pLeaf->numKeys, t);
+   if (pLeaf->numKeys == leafCapacity)
+   {
+      splitLeaf(pLeaf);
+      if (i > pLeaf->numKeys)
+      {
+         i -= pLeaf->numKeys;
+         pLeaf = pLeaf->pNext;
+      }
+   }
+
+   insertKey(pLeaf->keys(), pLeaf->numKeys, i, std::forward<U>(t));
+   pLeaf->numKeys++;
+   numElements++;
+   return std::pair<iterator, bool>(iterator(this, pLeaf, i), true);
+}
+
+/*********************************************
+ * B PLUS TREE :: SPLIT LEAF
+ * Move the top half of a full leaf into a new one to
+ * its right. A copy of the new leaf's first element
+ * becomes the separator in the parent.
+ ********************************************/
+template <typename T, typename A>
+void BPlusTree <T, A> :: splitLeaf(Leaf * pLeaf)
+{
+   Leaf * pRight = newLeaf();
+   size_t numStay = pLeaf->numKeys / 2;
+   moveKeys(pRight->keys(), pLeaf->keys() + numStay, pLeaf->numKeys - numStay);
+   pRight->numKeys = pLeaf->numKeys - numStay;
+   pLeaf->numKeys = numStay;
+
+   pRight->pPrev = pLeaf;
+   pRight->pNext = pLeaf->pNext;
+   if (pLeaf->pNext)
+      pLeaf->pNext->pPrev = pRight;
+   else
+      pLast = pRight;
+   pLeaf->pNext = pRight;
+
+   insertUp(pLeaf, T(pRight->keys()[0]), pRight);
+}
+
+/*********************************************
+ * B PLUS TREE :: INSERT UP
+ * Hang pRight beside pLeft in their parent, with the
+ * separator between them. A full parent is split first
+ * and its middle separator goes up a level; a root that
+ * splits gets a new root above it.
+ ********************************************/
+template <typename T, typename A>
+void BPlusTree <T, A> :: insertUp(Node * pLeft, T && separator, Node * pRight)
+{
+   Inner * pParent = pLeft->pParent;
+   if (pParent == nullptr)
+   {
+      pParent = newInner();
+      pParent->children[0] = pLeft;
+      pLeft->pParent = pParent;
+      pRoot = pParent;
+   }
+
+   if (pParent->numKeys == innerCapacity)
+   {
+      Inner * pSplit = newInner();
+      size_t middle = pParent->numKeys / 2;
+      T up(std::move(pParent->keys()[middle]));
+      pParent->keys()[middle].~T();
+      moveKeys(pSplit->keys(), pParent->keys() + middle + 1, pParent->numKeys - middle - 1);
+      pSplit->numKeys = pParent->numKeys - middle - 1;
+      for (size_t i = 0; i <= pSplit->numKeys; i++)
+      {
+         pSplit->children[i] = pParent->children[middle + 1 + i];
+         pSplit->children[i]->pParent = pSplit;
+      }
+      pParent->numKeys = middle;
+      insertUp(pParent, std::move(up), pSplit);
+      pParent = pLeft->pParent;
+   }
+
+   size_t i = childIndex(pParent, pLeft);
+   insertKey(pParent->keys(), pParent->numKeys, i, std::move(separator));
+   for (size_t j = pParent->numKeys + 1; j > i + 1; j--)
+      pParent->children[j] = pParent->children[j - 1];
+   pParent->children[i + 1] = pRight;
+   pRight->pParent = pParent;
+   pParent->numKeys++;
+}
+
+/*********************************************
+ * B PLUS TREE :: ERASE
+ * Take the element out of its leaf. A leaf left less
+ * than half full borrows from or merges with a sibling.
+ * As with BST, it moves on to the element after the one
+ * erased, which is also returned.
+ ********************************************/
+template <typename T, typename A>
+typename BPlusTree <T, A> :: iterator BPlusTree <T, A> :: erase(iterator & it)
+{
+   if (it.pLeaf == nullptr)
+      return end();
+
+   Leaf * pLeaf = it.pLeaf;
+   eraseKey(pLeaf->keys(), pLeaf->numKeys, it.index);
+   pLeaf->numKeys--;
+   numElements--;
+
+   Cursor cursor = { pLeaf, it.index };
+   if (pLeaf == pRoot)
+   {
+      if (pLeaf->numKeys == 0)
+      {
+         deleteLeaf(pLeaf);
+         pRoot = pFirst = pLast = nullptr;
+         it = end();
+         return it;
+      }
+   }
+   else if (pLeaf->numKeys < leafMin)
+      rebalanceLeaf(pLeaf, cursor);
+
+   if (cursor.index == cursor.pLeaf->numKeys)
+      it = iterator(this, cursor.pLeaf->pNext, 0);
+   else
+      it = iterator(this, cursor.pLeaf, cursor.index);
+   return it;
+}
+
+/*********************************************
+ * B PLUS TREE :: REBALANCE LEAF
+ * Take an element from a sibling that can spare one, or
+ * else merge with a sibling. The cursor follows the
+ * element it refers to.
+ ********************************************/
+template <typename T, typename A>
+void BPlusTree <T, A> :: rebalanceLeaf(Leaf * pLeaf, Cursor & cursor)
+{
+   Inner * pParent = pLeaf->pParent;
+   size_t i = childIndex(pParent, pLeaf);
+   Leaf * pLeft  = i > 0                 ? static_cast<Leaf *>(pParent->children[i - 1]) : nullptr;
+   Leaf * pRight = i < pParent->numKeys  ? static_cast<Leaf *>(pParent->children[i + 1]) : nullptr;
+
+   if (pLeft && pLeft->numKeys > leafMin)
+   {
+      insertKey(pLeaf->keys(), pLeaf->numKeys, 0, std::move(pLeft->keys()[pLeft->numKeys - 1]));
+      pLeaf->numKeys++;
+      eraseKey(pLeft->keys(), pLeft->numKeys, pLeft->numKeys - 1);
+      pLeft->numKeys--;
+      pParent->keys()[i - 1] = pLeaf->keys()[0];
+      cursor.index++;
+   }
+   else if (pRight && pRight->numKeys > leafMin)
+   {
+      insertKey(pLeaf->keys(), pLeaf->numKeys, pLeaf->numKeys, std::move(pRight->keys()[0]));
+      pLeaf->numKeys++;
+      eraseKey(pRight->keys(), pRight->numKeys, 0);
+      pRight->numKeys--;
+      pParent->keys()[i] = pRight->keys()[0];
+   }
+   else
+   {
+      // merge the right one of the pair into the left
+      if (pLeft)
+      {
+         cursor.pLeaf = pLeft;
+         cursor.index += pLeft->numKeys;
+         pRight = pLeaf;
+         pLeaf = pLeft;
+         i--;
+      }
+      moveKeys(pLeaf->keys() + pLeaf->numKeys, pRight->keys(), pRight->numKeys);
+      pLeaf->numKeys += pRight->numKeys;
+      pRight->numKeys = 0;
+      pLeaf->pNext = pRight->pNext;
+      if (pRight->pNext)
+         pRight->pNext->pPrev = pLeaf;
+      else
+         pLast = pLeaf;
+      deleteLeaf(pRight);
+      removeChild(pParent, i);
+   }
+}
+
+/*********************************************
+ * B PLUS TREE :: REMOVE CHILD
+ * Drop separator iKey and the child to its right, which
+ * has been merged away. The root shrinks when it is
+ * down to one child; any other inner node left less
+ * than half full is rebalanced.
+ ********************************************/
+template <typename T, typename A>
+void BPlusTree <T, A> :: removeChild(Inner * pInner, size_t iKey)
+{
+   eraseKey(pInner->keys(), pInner->numKeys, iKey);
+   for (size_t j = iKey + 1; j < pInner->numKeys; j++)
+      pInner->children[j] = pInner->children[j + 1];
+   pInner->numKeys--;
+
+   if (pInner == pRoot)
+   {
+      if (pInner->numKeys == 0)
+      {
+         pRoot = pInner->children[0];
+         pRoot->pParent = nullptr;
+         deleteInner(pInner);
+      }
+   }
+   else if (pInner->numKeys < innerMin)
+      rebalanceInner(pInner);
+}
+
+/*********************************************
+ * B PLUS TREE :: REBALANCE INNER
+ * As with a leaf, but a borrowed child brings its
+ * separator down from the parent and sends one up
+ ********************************************/
+template <typename T, typename A>
+void BPlusTree <T, A> :: rebalanceInner(Inner * pInner)
+{
+   Inner * pParent = pInner->pParent;
+   size_t i = childIndex(pParent, pInner);
+   Inner * pLeft  = i > 0                ? static_cast<Inner *>(pParent->children[i - 1]) : nullptr;
+   Inner * pRight = i < pParent->numKeys ? static_cast<Inner *>(pParent->children[i + 1]) : nullptr;
+
+   if (pLeft && pLeft->numKeys > innerMin)
+   {
+      insertKey(pInner->keys(), pInner->numKeys, 0, std::move(pParent->keys()[i - 1]));
+      for (size_t j = pInner->numKeys + 1; j > 0; j--)
+         pInner->children[j] = pInner->children[j - 1];
+      pInner->children[0] = pLeft->children[pLeft->numKeys];
+      pInner->children[0]->pParent = pInner;
+      pInner->numKeys++;
+      pParent->keys()[i - 1] = std::move(pLeft->keys()[pLeft->numKeys - 1]);
+      eraseKey(pLeft->keys(), pLeft->numKeys, pLeft->numKeys - 1);
+      pLeft->numKeys--;
+   }
+   else if (pRight && pRight->numKeys > innerMin)
+   {
+      insertKey(pInner->keys(), pInner->numKeys, pInner->numKeys, std::move(pParent->keys()[i]));
+      pInner->children[pInner->numKeys + 1] = pRight->children[0];
+      pInner->children[pInner->numKeys + 1]->pParent = pInner;
+      pInner->numKeys++;
+      pParent->keys()[i] = std::move(pRight->keys()[0]);
+      eraseKey(pRight->keys(), pRight->numKeys, 0);
+      for (size_t j = 0; j < pRight->numKeys; j++)
+         pRight->children[j] = pRight->children[j + 1];
+      pRight->numKeys--;
+   }
+   else
+   {
+      // the separator comes down between the two halves
+      if (pLeft)
+      {
+         pRight = pInner;
+         pInner = pLeft;
+         i--;
+      }
+      ::new (pInner->keys() + pInner->numKeys) T(std::move(pParent->keys()[i]));
+      moveKeys(pInner->keys() + pInner->numKeys + 1, pRight->keys(), pRight->numKeys);
+      for (size_t j = 0; j <= pRight->numKeys; j++)
+      {
+         pInner->children[pInner->numKeys + 1 + j] = pRight->children[j];
+         pRight->children[j]->pParent = pInner;
+      }
+      pInner->numKeys += pRight->numKeys + 1;
+      pRight->numKeys = 0;
+      deleteInner(pRight);
+      removeChild(pParent, i);
+   }
+}
+
+/*********************************************
+ * B PLUS TREE :: CLEAR
+ * Free every node. The tree is only a few levels
+ * deep, so recursing is safe.
+ ********************************************/
+template <typename T, typename A>
+void BPlusTree <T, A> :: clear() noexcept
+{
+   if (pRoot)
+      deleteNode(pRoot);
+   pRoot = nullptr;
+   pFirst = pLast = nullptr;
+   numElements = 0;
+}
+
+template <typename T, typename A>
+void BPlusTree <T, A> :: deleteNode(Node * pNode)
+{
+   if (pNode->isLeaf)
+      deleteLeaf(static_cast<Leaf *>(pNode));
+   else
+   {
+      Inner * pInner = static_cast<Inner *>(pNode);
+      for (size_t i = 0; i <= pInner->numKeys; i++)
+         deleteNode(pInner->children[i]);
+      deleteInner(pInner);
+   }
+}
+
+/*********************************************
+ * B PLUS TREE :: CLONE NODE
+ * Copy a subtree, linking the leaves as they are made
+ * left to right onto the end of this tree's leaves
+ ********************************************/
+template <typename T, typename A>
+typename BPlusTree <T, A> :: Node * BPlusTree <T, A> :: cloneNode(const Node * pSrc, Inner * pParent)
+{
+   Node * pNode;
+   if (pSrc->isLeaf)
+   {
+      const Leaf * pSrcLeaf = static_cast<const Leaf *>(pSrc);
+      Leaf * pLeaf = newLeaf();
+      std::uninitialized_copy(pSrcLeaf->keys(), pSrcLeaf->keys() + pSrcLeaf->numKeys, pLeaf->keys());
+      pLeaf->numKeys = pSrcLeaf->numKeys;
+      pLeaf->pPrev = pLast;
+      if (pLast)
+         pLast->pNext = pLeaf;
+      else
+         pFirst = pLeaf;
+      pLast = pLeaf;
+      pNode = pLeaf;
+   }
+   else
+   {
+      const Inner * pSrcInner = static_cast<const Inner *>(pSrc);
+      Inner * pInner = newInner();
+      std::uninitialized_copy(pSrcInner->keys(), pSrcInner->keys() + pSrcInner->numKeys, pInner->keys());
+      pInner->numKeys = pSrcInner->numKeys;
+      for (size_t i = 0; i <= pInner->numKeys; i++)
+         pInner->children[i] = cloneNode(pSrcInner->children[i], pInner);
+      pNode = pInner;
+   }
+   pNode->pParent = pParent;
+   return pNode;
+}
+
+/*********************************************
+ * B PLUS TREE :: HEIGHT
+ * The number of nodes a find visits
+ ********************************************/
+template <typename T, typename A>
+size_t BPlusTree <T, A> :: height() const
+{
+   size_t h = 0;
+   for (const Node * pNode = pRoot; pNode; h++)
+      pNode = pNode->isLeaf ? nullptr : static_cast<const Inner *>(pNode)->children[0];
+   return h;
+}
+
+/*********************************************
+ * B PLUS TREE :: NEW and DELETE nodes
+ * The elements in a node are constructed and
+ * destroyed one at a time as they come and go; a
+ * node is deleted with whatever it still holds
+ ********************************************/
+template <typename T, typename A>
+typename BPlusTree <T, A> :: Leaf * BPlusTree <T, A> :: newLeaf()
+{
+   LeafAlloc leafAlloc(alloc);
+   Leaf * pLeaf = std::allocator_traits<LeafAlloc>::allocate(leafAlloc, 1);
+   return ::new (pLeaf) Leaf();
+}
+
+template <typename T, typename A>
+typename BPlusTree <T, A> :: Inner * BPlusTree <T, A> :: newInner()
+{
+   InnerAlloc innerAlloc(alloc);
+   Inner * pInner = std::allocator_traits<InnerAlloc>::allocate(innerAlloc, 1);
+   return ::new (pInner) Inner();
+}
+
+template <typename T, typename A>
+void BPlusTree <T, A> :: deleteLeaf(Leaf * pLeaf)
+{
+   std::destroy(pLeaf->keys(), pLeaf->keys() + pLeaf->numKeys);
+   pLeaf->~Leaf();
+   LeafAlloc leafAlloc(alloc);
+   std::allocator_traits<LeafAlloc>::deallocate(leafAlloc, pLeaf, 1);
+}
+
+template <typename T, typename A>
+void BPlusTree <T, A> :: deleteInner(Inner * pInner)
+{
+   std::destroy(pInner->keys(), pInner->keys() + pInner->numKeys);
+   pInner->~Inner();
+   InnerAlloc innerAlloc(alloc);
+   std::allocator_traits<InnerAlloc>::deallocate(innerAlloc, pInner, 1);
+}
+
+/*********************************************
+ * B PLUS TREE :: CHILD INDEX
+ * Which of its parent's children a node is
+ ********************************************/
+template <typename T, typename A>
+size_t BPlusTree <T, A> :: childIndex(const Inner * pInner, const Node * pChild)
+{
+   size_t i = 0;
+   while (pInner->children[i] != pChild)
+      i++;
+   assert(i <= pInner->numKeys);
+   return i;
+}
+
+/*********************************************
+ * B PLUS TREE :: INSERT KEY, ERASE KEY, MOVE KEYS
+ * Work on the first num elements of a node's array:
+ * open a gap at i, close the one at i, or move num
+ * elements to where there are none and leave none
+ ********************************************/
+template <typename T, typename A>
+template <typename U>
+void BPlusTree <T, A> :: insertKey(T * keys, size_t num, size_t i, U && t)
+{
+   if (i == num)
+   {
+      ::new (keys + num) T(std::forward<U>(t));
+      return;
+   }
+   ::new (keys + num) T(std::move(keys[num - 1]));
+   std::move_backward(keys + i, keys + num - 1, keys + num);
+   keys[i] = T(std::forward<U>(t));
+}
+
+template <typename T, typename A>
+void BPlusTree <T, A> :: eraseKey(T * keys, size_t num, size_t i)
+{
+   std::move(keys + i + 1, keys + num, keys + i);
+   keys[num - 1].~T();
+}
+
+template <typename T, typename A>
+void BPlusTree <T, A> :: moveKeys(T * pDest, T * pSrc, size_t num)
+{
+   std::uninitialized_move(pSrc, pSrc + num, pDest);
+   std::destroy(pSrc, pSrc + num);
+}
+
+} // namespace custom
@@ -0,0 +1,706 @@
+/***********************************************************************
+ * Header:
+ *    BALANCE POLICY
+ * Summary:
+ *    The ways a BST can keep itself balanced, chosen at compile time with
+ *    the third template parameter of BST. Each policy decides what the
+ *    two bits of metadata in every node mean and what to do after a node
+ *    is linked into or unlinked from the tree:
+ *
+ *        inserted(tree, pNode)   pNode was just hung as a leaf
+ *        unlink(tree, pNode)     take pNode out of the tree and rebalance
+ *        label(pNode, ...)       set the metadata of a node in a perfectly
+ *                                balanced tree being built bottom-up
+ *        restore(tree)           fix up a tree that was built or copied
+ *                                wholesale
+ *
+ *    This will contain the class definitions of:
+ *        RedBlack            : A red-black tree, the default
+ *        AVL                 : Shallower than red-black, more rotations
+ *        WAVL                : AVL while only inserting, O(1) rotations
+ *                              to erase
+ *        Treap               : Randomized, cheap updates, no metadata
+ *        Scapegoat           : No metadata, rebuilds what grows lopsided
+ *        Unbalanced          : A plain binary search tree
+ *
+ *    There is no splay tree: it restructures on every lookup, and find()
+ *    is const here so that several readers can share a tree.
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <cstdint>    // for std::uint64_t and std::uintptr_t
+#include <cmath>      // for std::log
+#include <vector>     // for std::vector
+
+namespace custom
+{
+
+/*****************************************************************
+ * RED BLACK
+ * Bit 0 of the metadata is the color. See BNode::balance() and
+ * BST::fixDoubleBlack() for the fix-ups.
+ *****************************************************************/
+struct RedBlack
+{
+   template <class Tree, class Node>
+   static void inserted(Tree & tree, Node * pNode)
+   {
+      pNode->setRed(true);
+      pNode->balance(tree.stats);
+   }
+
+   template <class Tree, class Node>
+   static void unlink(Tree & tree, Node * pNode)
+   {
+      if (pNode->pLeft && pNode->pRight)
+         tree.swapWithSuccessor(pNode);
+      Node * pChild = pNode->pLeft ? pNode->pLeft : pNode->pRight;
+      Node * pParent = pNode->pParent;
+      tree.replace(pNode, pChild);
+      if (!pNode->isRed())
+         tree.fixDoubleBlack(pChild, pParent);
+   }
+
+   // every level is black except a partly filled bottom one
+   template <class Node>
+   static void label(Node * pNode, size_t depth, size_t redDepth, size_t, size_t)
+   {
+      pNode->setRed(depth == redDepth);
+   }
+
+   template <class Tree>
+   static void restore(Tree &) {}
+};
+
+/*****************************************************************
+ * AVL
+ * The metadata is the balance factor, the height of the right
+ * subtree less that of the left: 0 is even, 1 leans left, and 2
+ * leans right.
+ *****************************************************************/
+struct AVL
+{
+   template <class Node>
+   static int lean(const Node * pNode)
+   {
+      unsigned meta = pNode->meta();
+      return meta == 1 ? -1 : (meta == 2 ? 1 : 0);
+   }
+
+   template <class Node>
+   static void setLean(Node * pNode, int lean)
+   {
+      pNode->setMeta(lean < 0 ? 1 : (lean > 0 ? 2 : 0));
+   }
+
+   /*********************************************
+    * AVL :: INSERTED
+    * Walk up until a subtree stops growing, rotating
+    * the first one that grows too tall on one side
+    ********************************************/
+   template <class Tree, class Node>
+   static void inserted(Tree & tree, Node * pNode)
+   {
+      setLean(pNode, 0);
+      for (Node * pUp = pNode->pParent; pUp; pNode = pUp, pUp = pUp->pParent)
+      {
+         if (pNode == pUp->pRight)
+         {
+            if (lean(pUp) > 0)
+            {
+               if (lean(pNode) < 0)
+                  rotateRightLeft(tree, pUp);
+               else
+                  rotateLeft(tree, pUp);
+               return;
+            }
+            if (lean(pUp) < 0)
+            {
+               setLean(pUp, 0);
+               return;
+            }
+            setLean(pUp, 1);
+         }
+         else
+         {
+            if (lean(pUp) < 0)
+            {
+               if (lean(pNode) > 0)
+                  rotateLeftRight(tree, pUp);
+               else
+                  rotateRight(tree, pUp);
+               return;
+            }
+            if (lean(pUp) > 0)
+            {
+               setLean(pUp, 0);
+               return;
+            }
+            setLean(pUp, -1);
+         }
+      }
+   }
+
+   /*********************************************
+    * AVL :: UNLINK
+    * Take the node out, then walk up while subtrees keep
+    * getting shorter, rotating where one side is now too
+    * short
+    ********************************************/
+   template <class Tree, class Node>
+   static void unlink(Tree & tree, Node * pNode)
+   {
+      if (pNode->pLeft && pNode->pRight)
+         tree.swapWithSuccessor(pNode);
+      Node * pChild = pNode->pLeft ? pNode->pLeft : pNode->pRight;
+      Node * pUp = pNode->pParent;
+      bool isLeft = pUp && pUp->pLeft == pNode;
+      tree.replace(pNode, pChild);
+
+      while (pUp)
+      {
+         Node * pGranny = pUp->pParent;
+         Node * pShorter;
+         if (isLeft)
+         {
+            if (lean(pUp) == 0)
+            {
+               setLean(pUp, 1);
+               return;
+            }
+            if (lean(pUp) < 0)
+            {
+               setLean(pUp, 0);
+               pShorter = pUp;
+            }
+            else
+            {
+               int leanSibling = lean(pUp->pRight);
+               pShorter = leanSibling < 0 ? rotateRightLeft(tree, pUp) : rotateLeft(tree, pUp);
+               if (leanSibling == 0)
+                  return;
+            }
+         }
+         else
+         {
+            if (lean(pUp) == 0)
+            {
+               setLean(pUp, -1);
+               return;
+            }
+            if (lean(pUp) > 0)
+            {
+               setLean(pUp, 0);
+               pShorter = pUp;
+            }
+            else
+            {
+               int leanSibling = lean(pUp->pLeft);
+               pShorter = leanSibling > 0 ? rotateLeftRight(tree, pUp) : rotateRight(tree, pUp);
+               if (leanSibling == 0)
+                  return;
+            }
+         }
+         isLeft = pGranny && pGranny->pLeft == pShorter;
+         pUp = pGranny;
+      }
+   }
+
+   // a subtree of n nodes built by splitting at the middle is
+   // floor(log2(n)) + 1 high, so the lean follows from the sizes
+   template <class Node>
+   static void label(Node * pNode, size_t, size_t, size_t numLeft, size_t numRight)
+   {
+      setLean(pNode, height(numRight) - height(numLeft));
+   }
+
+   template <class Tree>
+   static void restore(Tree &) {}
+
+private:
+   static int height(size_t n)
+   {
+      int h = 0;
+      for (; n; n /= 2)
+         h++;
+      return h;
+   }
+
+   // pTop's right subtree is two taller: its right child comes up
+   template <class Tree, class Node>
+   static Node * rotateLeft(Tree & tree, Node * pTop)
+   {
+      Node * pPivot = pTop->pRight;
+      pTop->rotateLeft();
+      if (tree.root == pTop)
+         tree.root = pPivot;
+      bool wasEven = lean(pPivot) == 0;     // only when erasing
+      setLean(pTop,   wasEven ? 1  : 0);
+      setLean(pPivot, wasEven ? -1 : 0);
+      tree.stats.singleRotations++;
+      return pPivot;
+   }
+
+   // pTop's left subtree is two taller: its left child comes up
+   template <class Tree, class Node>
+   static Node * rotateRight(Tree & tree, Node * pTop)
+   {
+      Node * pPivot = pTop->pLeft;
+      pTop->rotateRight();
+      if (tree.root == pTop)
+         tree.root = pPivot;
+      bool wasEven = lean(pPivot) == 0;     // only when erasing
+      setLean(pTop,   wasEven ? -1 : 0);
+      setLean(pPivot, wasEven ? 1  : 0);
+      tree.stats.singleRotations++;
+      return pPivot;
+   }
+
+   // pTop's right child leans left: its left grandchild comes up
+   template <class Tree, class Node>
+   static Node * rotateRightLeft(Tree & tree, Node * pTop)
+   {
+      Node * pRight = pTop->pRight;
+      Node * pPivot = pRight->pLeft;
+      pRight->rotateRight();
+      pTop->rotateLeft();
+      if (tree.root == pTop)
+         tree.root = pPivot;
+      int leanPivot = lean(pPivot);
+      setLean(pTop,   leanPivot > 0 ? -1 : 0);
+      setLean(pRight, leanPivot < 0 ? 1  : 0);
+      setLean(pPivot, 0);
+      tree.stats.doubleRotations++;
+      return pPivot;
+   }
+
+   // pTop's left child leans right: its right grandchild comes up
+   template <class Tree, class Node>
+   static Node * rotateLeftRight(Tree & tree, Node * pTop)
+   {
+      Node * pLeft = pTop->pLeft;
+      Node * pPivot = pLeft->pRight;
+      pLeft->rotateLeft();
+      pTop->rotateRight();
+      if (tree.root == pTop)
+         tree.root = pPivot;
+      int leanPivot = lean(pPivot);
+      setLean(pTop,  leanPivot < 0 ? 1  : 0);
+      setLean(pLeft, leanPivot > 0 ? -1 : 0);
+      setLean(pPivot, 0);
+      tree.stats.doubleRotations++;
+      return pPivot;
+   }
+};
+
+/*****************************************************************
+ * WAVL
+ * A weak AVL tree. Every node has a rank, and a child's rank is one
+ * or two less than its parent's (a missing child's is -1); a leaf's
+ * is 0. Bit 0 of the metadata is the parity of the rank, which is
+ * enough to tell a 1-child from a 2-child. Inserting does what AVL
+ * does, but erasing rotates at most twice.
+ *****************************************************************/
+struct WAVL
+{
+   template <class Node>
+   static unsigned parity(const Node * pNode)
+   {
+      return pNode ? (pNode->meta() & 1) : 1;
+   }
+
+   // the rank differences are 1 or 2, so the parities tell them apart
+   template <class Node>
+   static bool isTwoChild(const Node * pChild, const Node * pParent)
+   {
+      return parity(pChild) == parity(pParent);
+   }
+
+   /*********************************************
+    * WAVL :: INSERTED
+    * The new leaf may have its parent's rank. Promote
+    * parents while their other child is a 1-child, then
+    * rotate once or twice to settle it
+    ********************************************/
+   template <class Tree, class Node>
+   static void inserted(Tree & tree, Node * pNode)
+   {
+      for (Node * pUp = pNode->pParent; pUp; pNode = pUp, pUp = pUp->pParent)
+      {
+         if (!isTwoChild(pNode, pUp))           // a 1-child: all is well
+            return;
+         Node * pSibling = pUp->pLeft == pNode ? pUp->pRight : pUp->pLeft;
+         if (!isTwoChild(pSibling, pUp))
+         {
+            rerank(pUp);                        // promote, and look higher
+            continue;
+         }
+
+         Node * pInner = pUp->pLeft == pNode ? pNode->pRight : pNode->pLeft;
+         if (isTwoChild(pInner, pNode))
+         {
+            raise(tree, pNode);
+            rerank(pUp);                        // demote
+            tree.stats.singleRotations++;
+         }
+         else
+         {
+            raise(tree, pInner);
+            raise(tree, pInner);
+            rerank(pInner);                     // promote
+            rerank(pNode);                      // demote
+            rerank(pUp);                        // demote
+            tree.stats.doubleRotations++;
+         }
+         return;
+      }
+   }
+
+   /*********************************************
+    * WAVL :: UNLINK
+    * Take the node out. What replaces it is one rank
+    * lower, so if it was a 2-child it is now a 3-child:
+    * demote parents while that moves the problem up, then
+    * rotate once or twice to settle it
+    ********************************************/
+   template <class Tree, class Node>
+   static void unlink(Tree & tree, Node * pNode)
+   {
+      if (pNode->pLeft && pNode->pRight)
+         tree.swapWithSuccessor(pNode);
+      Node * pChild = pNode->pLeft ? pNode->pLeft : pNode->pRight;
+      Node * pUp = pNode->pParent;
+      if (pUp == nullptr)
+      {
+         tree.replace(pNode, pChild);
+         return;
+      }
+      bool isLeft = pUp->pLeft == pNode;
+      bool isThree = isTwoChild(pNode, pUp);
+      tree.replace(pNode, pChild);
+
+      // a parent left with no children had rank 1, but a leaf's is 0
+      if (!pUp->pLeft && !pUp->pRight)
+      {
+         Node * pGranny = pUp->pParent;
+         isThree = pGranny && isTwoChild(pUp, pGranny);
+         isLeft = pGranny && pGranny->pLeft == pUp;
+         rerank(pUp);                           // demote
+         pUp = pGranny;
+      }
+
+      while (isThree)
+      {
+         Node * pSibling = isLeft ? pUp->pRight : pUp->pLeft;
+         Node * pGranny = pUp->pParent;
+         bool wasTwo = pGranny && isTwoChild(pUp, pGranny);
+         if (isTwoChild(pSibling, pUp))
+            rerank(pUp);                        // demote
+         else if (isTwoChild(pSibling->pLeft, pSibling) &&
+                  isTwoChild(pSibling->pRight, pSibling))
+         {
+            rerank(pSibling);                   // demote both
+            rerank(pUp);
+         }
+         else
+         {
+            rotateErase(tree, pUp, pSibling, isLeft);
+            return;
+         }
+         isThree = wasTwo;
+         isLeft = pGranny && pGranny->pLeft == pUp;
+         pUp = pGranny;
+      }
+   }
+
+   // a subtree built by splitting at the middle is an AVL tree, and
+   // the rank of each node is its height less one
+   template <class Node>
+   static void label(Node * pNode, size_t, size_t, size_t numLeft, size_t numRight)
+   {
+      size_t rank = 0;
+      for (size_t n = numLeft + numRight + 1; n > 1; n /= 2)
+         rank++;
+      pNode->setMeta(rank & 1);
+   }
+
+   template <class Tree>
+   static void restore(Tree &) {}
+
+private:
+   // promote or demote by one: only the parity is kept
+   template <class Node>
+   static void rerank(Node * pNode)
+   {
+      pNode->setMeta(pNode->meta() ^ 1);
+   }
+
+   // trade places with the parent
+   template <class Tree, class Node>
+   static void raise(Tree & tree, Node * pNode)
+   {
+      Node * pParent = pNode->pParent;
+      if (pParent->pLeft == pNode)
+         pParent->rotateRight();
+      else
+         pParent->rotateLeft();
+      if (tree.root == pParent)
+         tree.root = pNode;
+   }
+
+   // the 3-child's sibling is a 1-child with a 1-child of its own
+   template <class Tree, class Node>
+   static void rotateErase(Tree & tree, Node * pUp, Node * pSibling, bool isLeft)
+   {
+      Node * pOuter = isLeft ? pSibling->pRight : pSibling->pLeft;
+      Node * pInner = isLeft ? pSibling->pLeft  : pSibling->pRight;
+      if (!isTwoChild(pOuter, pSibling))
+      {
+         raise(tree, pSibling);
+         rerank(pSibling);                      // promote
+         if (pUp->pLeft || pUp->pRight)
+            rerank(pUp);                        // demote, or twice for a leaf
+         tree.stats.singleRotations++;
+      }
+      else
+      {
+         raise(tree, pInner);
+         raise(tree, pInner);
+         rerank(pSibling);                      // demote; the others move by two
+         tree.stats.doubleRotations++;
+      }
+   }
+};
+
+/*****************************************************************
+ * TREAP
+ * A binary search tree that is also a heap on a random priority.
+ * The priority is a hash of the node's address, so it costs no
+ * space, but a copied node has a new one: copies are re-heaped.
+ *****************************************************************/
+struct Treap
+{
+   static std::uint64_t priority(const void * p)
+   {
+      std::uint64_t x = reinterpret_cast<std::uintptr_t>(p);
+      x ^= x >> 33;
+      x *= 0xff51afd7ed558ccdULL;
+      x ^= x >> 33;
+      x *= 0xc4ceb9fe1a85ec53ULL;
+      x ^= x >> 33;
+      return x;
+   }
+
+   // rotate the new leaf up past every parent of lower priority
+   template <class Tree, class Node>
+   static void inserted(Tree & tree, Node * pNode)
+   {
+      while (pNode->pParent && priority(pNode->pParent) < priority(pNode))
+         raise(tree, pNode);
+   }
+
+   // rotate the node down until it has at most one child
+   template <class Tree, class Node>
+   static void unlink(Tree & tree, Node * pNode)
+   {
+      while (pNode->pLeft && pNode->pRight)
+         raise(tree, priority(pNode->pLeft) > priority(pNode->pRight) ?
+                     pNode->pLeft : pNode->pRight);
+      tree.replace(pNode, pNode->pLeft ? pNode->pLeft : pNode->pRight);
+   }
+
+   template <class Node>
+   static void label(Node *, size_t, size_t, size_t, size_t) {}
+
+   // heap the whole tree, bottom-up
+   template <class Tree>
+   static void restore(Tree & tree)
+   {
+      if (tree.root == nullptr)
+         return;
+      heapify(tree, tree.root);
+      while (tree.root->pParent)
+         tree.root = tree.root->pParent;
+   }
+
+private:
+   // trade places with the parent
+   template <class Tree, class Node>
+   static void raise(Tree & tree, Node * pNode)
+   {
+      Node * pParent = pNode->pParent;
+      if (pParent->pLeft == pNode)
+         pParent->rotateRight();
+      else
+         pParent->rotateLeft();
+      if (tree.root == pParent)
+         tree.root = pNode;
+      tree.stats.singleRotations++;
+   }
+
+   template <class Tree, class Node>
+   static void heapify(Tree & tree, Node * pNode)
+   {
+      if (pNode == nullptr)
+         return;
+      heapify(tree, pNode->pLeft);
+      heapify(tree, pNode->pRight);
+      while (true)
+      {
+         Node * pChild = pNode->pLeft;
+         if (pNode->pRight && (!pChild || priority(pChild) < priority(pNode->pRight)))
+            pChild = pNode->pRight;
+         if (!pChild || priority(pChild) < priority(pNode))
+            return;
+         raise(tree, pChild);
+      }
+   }
+};
+
+/*****************************************************************
+ * SCAPEGOAT
+ * No metadata at all. A new leaf deeper than log3/2(n) has an
+ * ancestor with more than 2/3 of its subtree on one side: that
+ * subtree is rebuilt perfectly balanced. Once erasing leaves fewer
+ * than 2/3 of the most the tree held since it was last rebuilt,
+ * the whole tree is rebuilt.
+ *****************************************************************/
+struct Scapegoat
+{
+   template <class Tree, class Node>
+   static void inserted(Tree & tree, Node * pNode)
+   {
+      if (tree.maxElements < tree.numElements)
+         tree.maxElements = tree.numElements;
+
+      size_t depth = 0;
+      for (Node * pUp = pNode->pParent; pUp; pUp = pUp->pParent)
+         depth++;
+      if ((double)depth <= std::log((double)tree.numElements) / std::log(1.5))
+         return;
+
+      // the lowest ancestor that is too lopsided
+      size_t numBelow = 1;
+      for (Node * pUp = pNode->pParent; pUp; pNode = pUp, pUp = pUp->pParent)
+      {
+         size_t numUp = numBelow + 1 + count(pUp->pLeft == pNode ? pUp->pRight : pUp->pLeft);
+         if (3 * numBelow > 2 * numUp)
+         {
+            rebuild(tree, pUp, numUp);
+            return;
+         }
+         numBelow = numUp;
+      }
+   }
+
+   template <class Tree, class Node>
+   static void unlink(Tree & tree, Node * pNode)
+   {
+      if (pNode->pLeft && pNode->pRight)
+         tree.swapWithSuccessor(pNode);
+      tree.replace(pNode, pNode->pLeft ? pNode->pLeft : pNode->pRight);
+
+      size_t numLeft = tree.numElements - 1;
+      if (3 * numLeft < 2 * tree.maxElements)
+      {
+         if (tree.root)
+            rebuild(tree, tree.root, numLeft);
+         tree.maxElements = numLeft;
+      }
+   }
+
+   template <class Node>
+   static void label(Node *, size_t, size_t, size_t, size_t) {}
+
+   template <class Tree>
+   static void restore(Tree & tree)
+   {
+      tree.maxElements = tree.numElements;
+   }
+
+private:
+   template <class Node>
+   static size_t count(const Node * pNode)
+   {
+      return pNode ? 1 + count((const Node *)pNode->pLeft) + count((const Node *)pNode->pRight) : 0;
+   }
+
+   /*********************************************
+    * SCAPEGOAT :: REBUILD
+    * Hang the n nodes of the subtree under pTop again,
+    * splitting at the middle each time
+    ********************************************/
+   template <class Tree, class Node>
+   static void rebuild(Tree & tree, Node * pTop, size_t n)
+   {
+      std::vector<Node *> nodes;
+      nodes.reserve(n);
+      collect(pTop, nodes);
+
+      Node * pUp = pTop->pParent;
+      bool isLeft = pUp && pUp->pLeft == pTop;
+      Node * pNew = hang(nodes, 0, nodes.size(), pUp);
+      if (pUp == nullptr)
+         tree.root = pNew;
+      else if (isLeft)
+         pUp->pLeft = pNew;
+      else
+         pUp->pRight = pNew;
+      tree.recount(pNew);
+      tree.stats.rebuilds++;
+   }
+
+   template <class Node>
+   static void collect(Node * pNode, std::vector<Node *> & nodes)
+   {
+      if (pNode == nullptr)
+         return;
+      collect((Node *)pNode->pLeft, nodes);
+      nodes.push_back(pNode);
+      collect((Node *)pNode->pRight, nodes);
+   }
+
+   template <class Node>
+   static Node * hang(const std::vector<Node *> & nodes, size_t lo, size_t hi, Node * pParent)
+   {
+      if (lo == hi)
+         return nullptr;
+      size_t middle = lo + (hi - lo) / 2;
+      Node * pNode = nodes[middle];
+      pNode->pParent = pParent;
+      pNode->pLeft = hang(nodes, lo, middle, pNode);
+      pNode->pRight = hang(nodes, middle + 1, hi, pNode);
+      return pNode;
+   }
+};
+
+/*****************************************************************
+ * UNBALANCED
+ * Nothing is done to keep the tree balanced. A baseline to
+ * measure the others against.
+ *****************************************************************/
+struct Unbalanced
+{
+   template <class Tree, class Node>
+   static void inserted(Tree &, Node *) {}
+
+   template <class Tree, class Node>
+   static void unlink(Tree & tree, Node * pNode)
+   {
+      if (pNode->pLeft && pNode->pRight)
+         tree.swapWithSuccessor(pNode);
+      tree.replace(pNode, pNode->pLeft ? pNode->pLeft : pNode->pRight);
+   }
+
+   template <class Node>
+   static void label(Node *, size_t, size_t, size_t, size_t) {}
+
+   template <class Tree>
+   static void restore(Tree &) {}
+};
+
+} // namespace custom
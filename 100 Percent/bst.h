@@ -28,9 +28,28 @@
 #include <cassert>
 #include <utility>
 #include <memory>     // for std::allocator
+#include <memory_resource> // for std::pmr::polymorphic_allocator
 #include <functional> // for std::less
 #include <utility>    // for std::pair
+#include <new>        // for placement new and std::launder
+#include <cstring>    // for std::memcpy
+#include <cstdint>    // for std::uintptr_t
+#include <type_traits>// for std::is_trivially_destructible
+#include <iterator>   // for std::distance
+#include <algorithm>  // for std::is_sorted, std::sort, std::unique
+#include <vector>     // for std::vector
+#include <execution>  // for std::execution::par
+#include <future>     // for std::async
+#include <thread>     // for std::thread::hardware_concurrency
+#include <mutex>      // for std::mutex
+#include <atomic>     // for std::atomic
 #include <stdio.h>
+#ifdef _MSC_VER
+#include <xmmintrin.h>// for _mm_prefetch
+#endif
+#include "reclaimer.h"
+#include "balancePolicy.h"
+#include "frozenSet.h"
 class TestBST; // forward declaration for unit tests
 class TestMap;
 class TestSet;
@@ -43,11 +62,37 @@ namespace custom
    template <class KK, class VV>
    class map;
 
+/*****************************************************************
+ * SORTED TAG
+ * Promises that a range is already in ascending order
+ *****************************************************************/
+struct sorted_tag_t
+{
+   explicit sorted_tag_t() = default;
+};
+inline constexpr sorted_tag_t sorted_tag{};
+
+/*****************************************************************
+ * IS THREE WAY
+ * A comparator that answers less, equal or greater in one call says
+ * so with a member typedef is_three_way, the way is_transparent says
+ * it takes any key. Its answer is compared with 0. Any other
+ * comparator is a less-than, whatever type it returns.
+ *****************************************************************/
+template <class C, class = void>
+struct is_three_way : std::false_type {};
+
+template <class C>
+struct is_three_way <C, std::void_t<typename C::is_three_way> > : std::true_type {};
+
 /*****************************************************************
  * BINARY SEARCH TREE
- * Create a Binary Search Tree
+ * Create a Binary Search Tree. Nodes come from slabs that A, rebound,
+ * must align to their own size, as alignof() asks; an allocator that
+ * ignores over-alignment makes insert throw std::bad_alloc.
  *****************************************************************/
-template <typename T>
+template <typename T, typename A = std::allocator<T>, typename B = RedBlack,
+          typename C = std::less<T>, bool S = false>
 class BST
 {
    friend class ::TestBST; // give unit tests access to the privates
@@ -62,15 +107,21 @@ class BST
 
    template <class KK, class VV>
    friend void swap(map<KK, VV>& lhs, map<KK, VV>& rhs);
+
+   friend B;                  // the balance policy rearranges the nodes
 public:
    //
    // Construct
    //
 
    BST();
+   explicit BST(const A & alloc);
+   explicit BST(const C & comp, const A & alloc = A());
    BST(const BST &  rhs);
    BST(      BST && rhs);
    BST(const std::initializer_list<T>& il);
+   template <class Iterator>
+   BST(Iterator first, Iterator last, sorted_tag_t, const A & alloc = A());
    ~BST();
 
    //
@@ -78,8 +129,14 @@ public:
    //
 
    BST & operator = (const BST &  rhs);
+   template <class ExecutionPolicy>
+   BST & assign(const BST & rhs, ExecutionPolicy && policy);
    BST & operator = (      BST && rhs);
    BST & operator = (const std::initializer_list<T>& il);
+   template <class Iterator>
+   void assign_sorted(Iterator first, Iterator last);
+   template <class Iterator, class ExecutionPolicy>
+   void build(Iterator first, Iterator last, ExecutionPolicy && policy, bool keepUnique = false);
    void swap(BST & rhs);
 
    //
@@ -88,13 +145,56 @@ public:
 
    class iterator;
    iterator   begin() const noexcept;
-   iterator   end()   const noexcept { return iterator(nullptr); }
+   iterator   end()   const noexcept { return iterator(nullptr, this); }
 
    //
    // Access
    //
 
    iterator find(const T& t);
+   iterator lower_bound(const T & t) const { return iterator(lowerBoundNode(t), this); }
+   iterator upper_bound(const T & t) const { return iterator(upperBoundNode(t), this); }
+   std::pair<iterator, iterator> equal_range(const T & t) const
+   {
+      return std::pair<iterator, iterator>(lower_bound(t), upper_bound(t));
+   }
+   template <class Fn>
+   void     for_each_in_range(const T & lo, const T & hi, Fn fn) const { forEachIn(lo, hi, fn); }
+   size_t   count(const T & t) const;
+   bool     contains(const T & t) const { return findNode(t) != nullptr; }
+   void find_batch(const T * keys, size_t num, iterator * out);
+   frozen_set<T, A> freeze() const;
+
+   // with a transparent comparator such as std::less<>, look up by
+   // anything it compares with T, without making a T
+   template <class K, class CC = C, class = typename CC::is_transparent>
+   iterator find(const K & k)              { return iterator(findNode(k), this); }
+   template <class K, class CC = C, class = typename CC::is_transparent>
+   iterator lower_bound(const K & k) const { return iterator(lowerBoundNode(k), this); }
+   template <class K, class CC = C, class = typename CC::is_transparent>
+   iterator upper_bound(const K & k) const { return iterator(upperBoundNode(k), this); }
+   template <class K, class CC = C, class = typename CC::is_transparent>
+   std::pair<iterator, iterator> equal_range(const K & k) const
+   {
+      return std::pair<iterator, iterator>(lower_bound(k), upper_bound(k));
+   }
+   template <class K, class Fn, class CC = C, class = typename CC::is_transparent>
+   void     for_each_in_range(const K & lo, const K & hi, Fn fn) const { forEachIn(lo, hi, fn); }
+   template <class K, class CC = C, class = typename CC::is_transparent>
+   size_t   count(const K & k) const;
+   template <class K, class CC = C, class = typename CC::is_transparent>
+   bool     contains(const K & k) const    { return findNode(k) != nullptr; }
+
+   //
+   // Order statistics: only when S keeps the size of every subtree
+   //
+
+   iterator       select(size_t k) const;
+   size_t         rank(const T & t) const  { return rankOf(t); }
+   size_t         count_range(const T & lo, const T & hi) const;
+   std::ptrdiff_t distance(iterator first, iterator last) const;
+   template <class K, class CC = C, class = typename CC::is_transparent>
+   size_t         rank(const K & k) const  { return rankOf(k); }
 
    // 
    // Insert
@@ -103,12 +203,43 @@ public:
    std::pair<iterator, bool> insert(const T&  t, bool keepUnique = false);
    std::pair<iterator, bool> insert(      T&& t, bool keepUnique = false);
 
+   // as close as possible before hint: next to it costs O(1)
+   iterator insert(iterator hint, const T&  t, bool keepUnique = false);
+   iterator insert(iterator hint,       T&& t, bool keepUnique = false);
+
    //
    // Remove
    // 
 
    iterator erase(iterator& it);
+   size_t   erase(const T & t);
+   template <class K, class CC = C, class = typename CC::is_transparent,
+             class = std::enable_if_t<!std::is_convertible_v<K, iterator> > >
+   size_t   erase(const K & k);
    void   clear() noexcept;
+   void   release_async();
+
+   //
+   // Rebalancing cost: what insert and erase did to stay balanced
+   //
+
+   struct BalanceStats
+   {
+      size_t recolors = 0;          // red-black only: red aunts or siblings pushed up
+      size_t singleRotations = 0;
+      size_t doubleRotations = 0;
+      size_t rebuilds = 0;          // scapegoat only: subtrees hung again
+   };
+   const BalanceStats & balanceStats() const { return stats; }
+   void   resetBalanceStats()               { stats = BalanceStats(); }
+
+   //
+   // Node handles: move elements between trees without reallocating
+   //
+
+   class node_type;
+   node_type extract(iterator it);
+   std::pair<iterator, bool> insert(node_type && node, bool keepUnique = false);
 
    // 
    // Status
@@ -116,37 +247,144 @@ public:
 
    bool   empty() const noexcept { return numElements <=0 ? true: false; }
    size_t size()  const noexcept { return numElements;   }
+   A      get_allocator() const noexcept { return alloc;  }
+   C      key_comp()      const           { return comp;   }
+
+   //
+   // Node recycling: erased nodes are kept for the next insert, up
+   // to a slab's worth unless limitRecycled() says otherwise
+   //
+
+   void   shrink_to_fit();
+   void   limitRecycled(size_t n)   { pool()->limitFree(n); }
+   size_t numRecycled()   const     { return pPool ? pPool->recycled()   : 0; }
+   size_t numSlabAllocs() const     { return pPool ? pPool->slabAllocs() : 0; }
+   size_t numFreeNodes()  const     { return pPool ? pPool->sizeFree()   : 0; }
    
 
 private:
 
    class BNode;
+   class Pool;
+   typedef std::allocator_traits<A> Traits;
+
+   // what a node knows of the size of its subtree: nothing, unless S
+   struct Counted   { size_t numNodes = 1; };
+   struct Uncounted { };
    BNode * root;              // root node of the binary search tree
    size_t numElements;        // number of elements currently in the tree
+   Pool * pPool;              // slabs the nodes of this tree are carved from
+   A alloc;                   // where new slabs come from
+   C comp;                    // orders the elements
+   bool hasForeignNodes;      // holds nodes from another tree's pool
+   BalanceStats stats;        // rebalancing done by this tree so far
+   BNode * pMax = nullptr;    // the largest node, where appends go
+   size_t maxElements = 0;    // most held since the last rebuild (Scapegoat)
+
+   // a comparator that answers less, equal or greater at once
+   // rather than only less, as std::less does. See is_three_way.
+   static constexpr bool isThreeWay = is_three_way<C>::value;
+   template <class L, class R>
+   static bool less(const C & comp, const L & lhs, const R & rhs)
+   {
+      if constexpr (isThreeWay)
+         return comp(lhs, rhs) < 0;
+      else
+         return comp(lhs, rhs);
+   }
+
+   Pool * pool();
+   BNode * findParent(const T & t, bool keepUnique, BNode *& pParent, bool & isLeft) const;
+   template <class K>
+   BNode * findNode(const K & k) const;
+   template <class K>
+   BNode * lowerBoundNode(const K & k) const;
+   template <class K>
+   BNode * upperBoundNode(const K & k) const;
+   template <class K, class Fn>
+   void forEachIn(const K & lo, const K & hi, Fn & fn) const;
+   template <class K>
+   size_t countFrom(BNode * pNode, const K & k) const;
+   template <class K>
+   size_t eraseAll(const K & k);
+   template <typename U>
+   std::pair<iterator, bool> insertNode(U && t, bool keepUnique);
+   template <typename U>
+   iterator insertHinted(iterator hint, U && t, bool keepUnique);
+   template <class Iterator>
+   BNode * buildSorted(Iterator & it, size_t n, size_t depth, size_t redDepth);
+   static void sortParallel(T * pBegin, T * pEnd, size_t numSplits, const C & comp = C());
+   static BNode * buildSlots(T * values, size_t lo, size_t hi, size_t depth,
+                             size_t redDepth, void * pRun, size_t numSplits);
+   static size_t redDepthFor(size_t n);
+   template <class ExecutionPolicy>
+   static size_t numSplitsFor();
+   static void assignSubtree(BNode *& pDest, const BNode * pSrc, Pool * pPool,
+                             std::mutex & poolLock, size_t numSplits, size_t numEstimate);
+   void clone(const BST & rhs);
+   static BNode * cloneNode(const BNode * pSrc, void * pSlot);
+   void link(BNode * pNode, BNode * pParent, bool isLeft);
+   void unlink(BNode * pNode);
+   void swapWithSuccessor(BNode * pNode);
+   void replace(BNode * pOld, BNode * pNew);
+   void relink(BNode * pOld, BNode * pNew);
+   void restore();
+   static void countSubtrees(BNode * pRoot);
+   static void recount(BNode * pRoot)
+   {
+      if constexpr (S)
+         countSubtrees(pRoot);
+   }
+   static size_t sizeOf(const BNode * pNode)
+   {
+      if constexpr (S)
+         return pNode ? pNode->numNodes : 0;
+      else
+         return 0;
+   }
+   template <class K>
+   size_t rankOf(const K & k) const;
+   static size_t position(const BNode * pNode);
+   void fixDoubleBlack(BNode * pNode, BNode * pParent);
+   static void prefetch(const void * p);
 };
 
+namespace pmr
+{
+   // a BST whose nodes come from a std::pmr::memory_resource
+   template <typename T, typename B = RedBlack, typename C = std::less<T> >
+   using BST = custom::BST <T, std::pmr::polymorphic_allocator<T>, B, C>;
+}
+
+namespace ranked
+{
+   // a BST that knows the size of every subtree, for select() and rank()
+   template <typename T, typename B = RedBlack, typename C = std::less<T> >
+   using BST = custom::BST <T, std::allocator<T>, B, C, true>;
+}
+
 
 /*****************************************************************
  * BINARY NODE
  * A single node in a binary tree. Note that the node does not know
  * anything about the properties of the tree so no validation can be done.
  *****************************************************************/
-template <typename T>
-class BST <T> :: BNode
+template <typename T, typename A, typename B, typename C, bool S>
+class BST <T, A, B, C, S> :: BNode : public std::conditional_t<S, Counted, Uncounted>
 {
 public:
    //
    // Construct
    //
-   BNode(): pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(0), isRed(NULL)
+   BNode(): pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(0)
    {
   
    }
-   BNode(const T &  t):pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(t), isRed(NULL)
+   BNode(const T &  t):pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(t)
    {
 
    }
-   BNode(T && t): pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(std::move(t)), isRed(NULL)
+   BNode(T && t): pLeft(nullptr), pRight(nullptr), pParent(nullptr), data(std::move(t))
    {
    }
 
@@ -160,12 +398,36 @@ public:
    void addLeft(       T && t);
    void addRight(      T && t);
    
-   void clear(BNode  * &pThis);
-   void assign(BNode *&pDest, const BNode *pSrc);
+   static void clear(BNode  * &pThis, Pool * pLocal = nullptr);
+   static void dispose(BNode * pNode, Pool * pLocal);
+   template <class Visit>
+   static BNode * teardown(BNode * pNode, Visit visit, size_t limit = (size_t)-1);
+   static void assign(BNode *&pDest, const BNode *pSrc, Pool * pPool);
+
+   //
+   // Allocate: nodes live in the slabs of a Pool
+   //
+   static void * operator new   (size_t size);
+   static void * operator new   (size_t size, Pool * pPool);
+   static void   operator delete(void * p);
+   static void   operator delete(void * p, Pool * pPool);
+
+   //
+   // Balance: the tree above is kept linked; the caller
+   // tracks the root
+   //
+   void rotateLeft();
+   void rotateRight();
+   void balance(BalanceStats & stats);
 
    // 
    // Status
    //
+   bool isRed() const          { return pParent.isRed(); }
+   void setRed(bool red)       { pParent.setRed(red);    }
+   unsigned meta() const       { return pParent.meta();  }
+   void setMeta(unsigned meta) { pParent.setMeta(meta);  }
+   static bool isRed(const BNode * pNode) { return pNode && pNode->isRed(); }
    bool isRightChild(BNode * pNode) const {
       if(pNode->pRight == nullptr && pNode->pParent->pRight == pNode)
          return true;
@@ -179,22 +441,254 @@ public:
       return false;
    }
 
+#ifdef DEBUG
+   //
+   // Verify
+   //
+   std::pair <T,T> verifyBTree() const;
+   int findDepth() const;
+   bool verifyRedBlack(int depth) const;
+   int computeSize() const;
+#endif // DEBUG
+
    //
    // Data
    //
+   class ParentLink;
    T data;                  // Actual data stored in the BNode
    BNode* pLeft;          // Left child - smaller
    BNode* pRight;         // Right child - larger
-   BNode* pParent;        // Parent
-   bool isRed;              // Red-black balancing stuff
+   ParentLink pParent;    // Parent, with the balance metadata in the low bits
+};
+
+/*****************************************************************
+ * PARENT LINK
+ * A pointer to the parent node that also carries two bits of balance
+ * metadata (for red-black, the color) in its otherwise unused low bits.
+ * It reads and assigns like a BNode *; assigning a new parent leaves
+ * the metadata alone.
+ *****************************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+class BST <T, A, B, C, S> :: BNode :: ParentLink
+{
+public:
+   ParentLink(BNode * p = nullptr) : bits(reinterpret_cast<std::uintptr_t>(p)) {}
+   ParentLink(const ParentLink & rhs) = default;
+
+   ParentLink & operator = (BNode * p)
+   {
+      bits = reinterpret_cast<std::uintptr_t>(p) | (bits & META);
+      return *this;
+   }
+   ParentLink & operator = (const ParentLink & rhs)
+   {
+      return *this = rhs.get();
+   }
+
+   BNode * get()          const { return reinterpret_cast<BNode *>(bits & ~META); }
+   operator BNode * ()    const { return get(); }
+   BNode * operator -> () const { return get(); }
+
+   bool isRed() const     { return (bits & RED) != 0; }
+   void setRed(bool red)  { bits = (bits & ~RED) | (red ? RED : 0); }
+   unsigned meta() const  { return (unsigned)(bits & META); }
+   void setMeta(unsigned meta) { bits = (bits & ~META) | (meta & META); }
+
+private:
+   static const std::uintptr_t RED  = 1;
+   static const std::uintptr_t META = 3;   // the bits the balance policy owns
+   std::uintptr_t bits;
+};
+
+/*****************************************************************
+ * NODE POOL
+ * A slab allocator for the nodes of one tree. Nodes are carved out of
+ * slabs that are aligned to their own size, so any node can find the
+ * slab (and therefore the pool) it came from by masking its address.
+ * Released nodes go on an intrusive free list kept by their run of
+ * slabs and are handed out again before a new slab is allocated. Runs
+ * with free nodes are kept ahead of those without, so the first run
+ * always has one if any does, and a run whose last node comes back can
+ * be handed back to the allocator without looking at any other.
+ *
+ * Only the tree that owns the pool touches it directly. A node that
+ * moved to another tree, or sits in a node handle, may be freed on
+ * another thread: it goes on a locked list of remote frees that the
+ * owner takes back when it runs out of free nodes. Once the owner is
+ * gone, remote frees take the lock and release the node themselves.
+ *****************************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+class BST <T, A, B, C, S> :: Pool
+{
+   friend class ::TestBST; // give unit tests access to the privates
+public:
+   Pool(const A & alloc) : slabAlloc(alloc), pSlabs(nullptr), pLastRun(nullptr),
+            pBump(nullptr), pBumpEnd(nullptr), pBumpSlab(nullptr), pBumpLast(nullptr),
+            numLive(0), numFree(0),
+            freeLimit(nodesPerSlab()), numSlabAllocs(0), numRecycled(0),
+            isDetached(false) {}
+   ~Pool() { releaseAll(); }
+   Pool(const Pool &) = delete;
+   Pool & operator = (const Pool &) = delete;
+
+   static Pool * create(const A & alloc);
+   static void   destroy(Pool * pPool);
+
+   void * allocate();
+   void   reserve(size_t n);
+   void * claim(size_t n);
+   void   release(void * p);
+   void   releaseRemote(void * p);
+   void   drain();
+   void   releaseAll();
+   void   releaseEmptySlabs();
+   bool   releaseRun();
+   void   detach();
+
+   // the pool a given node was allocated from
+   static Pool * owner(const void * p)
+   {
+      return Slab::of(p)->pPool;
+   }
+
+   // where the i-th node of a claimed run lives
+   static void * slot(void * pRun, size_t i)
+   {
+      return static_cast<Slab *>(pRun)[i / nodesPerSlab()].nodes + i % nodesPerSlab() * sizeof(BNode);
+   }
+
+   // nodes created outside of a tree come from here
+   static Pool & fallback()
+   {
+      static Pool pool{A()};
+      return pool;
+   }
+
+   size_t size()          const { return numLive;       }
+   size_t sizeFree()      const { return numFree;       }
+   size_t slabAllocs()    const { return numSlabAllocs; }
+   size_t recycled()      const { return numRecycled;   }
+   bool   canRecycle(size_t n) const { return numFree + n <= freeLimit; }
+   void   limitFree(size_t n)
+   {
+      freeLimit = n;
+      if (numFree > freeLimit)
+         releaseEmptySlabs();
+   }
+
+private:
+   // one slab is at least a page and holds at least sixteen nodes
+   static constexpr size_t slabBytes()
+   {
+      size_t bytes = 4096;
+      while (bytes < 64 + 16 * sizeof(BNode))
+         bytes *= 2;
+      return bytes;
+   }
+
+   struct Free
+   {
+      Free * pNext;
+   };
+
+   // slabs are allocated in runs of one or more side by side and
+   // go back to the allocator a whole run at a time. All but the
+   // first two members are kept by the first slab for the run.
+   struct alignas(slabBytes()) Slab
+   {
+      Pool * pPool;         // pool that owns this slab
+      Slab * pRun;          // first slab of the run this one belongs to
+      Slab * pNext;         // next run in the pool
+      Slab * pPrev;         // previous run in the pool
+      size_t numSlabs;      // length of the run
+      size_t numLive;       // nodes in the run still in use
+      Free * pFree;         // nodes of the run released back to the pool
+      size_t numFree;       // nodes on pFree
+
+      static Slab * of(const void * p)
+      {
+         return reinterpret_cast<Slab *>(
+            reinterpret_cast<std::uintptr_t>(p) & ~(std::uintptr_t)(slabBytes() - 1));
+      }
+
+      alignas(BNode) unsigned char nodes[(slabBytes() - 64) / sizeof(BNode) * sizeof(BNode)];
+   };
+   static_assert(sizeof(Slab) == slabBytes(), "a slab must fill its alignment exactly");
+   typedef typename Traits::template rebind_alloc<Slab> SlabAlloc;
+   typedef typename Traits::template rebind_alloc<Pool> PoolAlloc;
+
+   static constexpr size_t nodesPerSlab() { return sizeof(Slab::nodes) / sizeof(BNode); }
+   void grow(size_t numSlabs);
+   void carve(Slab * pSlab);
+   void dropRun(Slab * pRun);
+   void unlinkRun(Slab * pRun);
+   void pushFront(Slab * pRun);
+   void pushBack(Slab * pRun);
+
+   SlabAlloc slabAlloc;     // the tree's allocator, rebound to slabs
+   Slab * pSlabs;           // every run of slabs, those with free nodes first
+   Slab * pLastRun;         // the end of that list
+   unsigned char * pBump;   // next never-used node in the newest slab
+   unsigned char * pBumpEnd;
+   Slab * pBumpSlab;        // the slab pBump points into
+   Slab * pBumpLast;        // the last slab of the newest run
+   size_t numLive;          // nodes handed out and not yet released
+   size_t numFree;          // nodes waiting on the free list
+   size_t freeLimit;        // past this, empty slabs go back; one slab's worth at first
+   size_t numSlabAllocs;    // trips to the allocator for a new slab
+   size_t numRecycled;      // allocations served from the free list
+   bool isDetached;         // the tree is gone; free when the last node is
+   std::mutex remoteLock;   // guards pRemote, and everything once detached
+   Free * pRemote = nullptr;// nodes freed by other trees, not yet taken back
+   std::atomic<bool> hasRemote{ false };
+#ifdef DEBUG
+   size_t numRunVisits = 0; // runs looked at to give slabs back
+#endif // DEBUG
+};
+
+/**********************************************************
+ * NODE HANDLE
+ * Owns a node that has been extracted from a tree. The node
+ * goes back to its own pool when the handle is destroyed,
+ * as a remote free since the handle may be on any thread.
+ *********************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+class BST <T, A, B, C, S> :: node_type
+{
+   friend class ::TestBST; // give unit tests access to the privates
+   friend class BST <T, A, B, C, S>;
+public:
+   node_type() : pNode(nullptr) {}
+   node_type(node_type && rhs) noexcept : pNode(rhs.pNode) { rhs.pNode = nullptr; }
+   node_type & operator = (node_type && rhs) noexcept
+   {
+      if (this != &rhs)
+      {
+         delete pNode;
+         pNode = rhs.pNode;
+         rhs.pNode = nullptr;
+      }
+      return *this;
+   }
+   ~node_type() { delete pNode; }
+
+   bool empty() const noexcept        { return pNode == nullptr; }
+   explicit operator bool() const noexcept { return pNode != nullptr; }
+
+   // the element can change while it is outside of any tree
+   T & value() const                  { return pNode->data; }
+
+private:
+   explicit node_type(BNode * pNode) : pNode(pNode) {}
+   BNode * pNode;
 };
 
 /**********************************************************
  * BINARY SEARCH TREE ITERATOR
  * Forward and reverse iterator through a BST
  *********************************************************/
-template <typename T>
-class BST <T> :: iterator
+template <typename T, typename A, typename B, typename C, bool S>
+class BST <T, A, B, C, S> :: iterator
 {
    friend class ::TestBST; // give unit tests access to the privates
    friend class ::TestMap;
@@ -207,17 +701,18 @@ class BST <T> :: iterator
    friend class set; 
 public:
    // constructors and assignment
-   iterator(BNode * p = nullptr) : pNode(p)
+   iterator(BNode * p = nullptr, const BST * pTree = nullptr) : pNode(p), pTree(pTree)
    {
 
    }
-   iterator(const iterator & rhs): pNode(nullptr)
+   iterator(const iterator & rhs): pNode(nullptr), pTree(nullptr)
    {
       *this = rhs;
    }
    iterator & operator = (const iterator & rhs)
    {
       pNode = rhs.pNode;
+      pTree = rhs.pTree;
       return *this;
    }
 
@@ -239,28 +734,31 @@ public:
 
    // increment and decrement
    iterator & operator ++ ();
-   iterator   operator ++ (int postfix)
+   iterator   operator ++ (int)
    {
       iterator old = *this;
-      
-//      if(pNode->pLeft != NULL)
-//         pNode = pNode-> pLeft;
-      
+      ++*this;
       return old;
    }
    iterator & operator -- ();
-   iterator   operator -- (int postfix)
+   iterator   operator -- (int)
    {
-      return *this;;
+      iterator old = *this;
+      --*this;
+      return old;
    }
 
    // must give friend status to remove so it can call getNode() from it
-   friend BST <T> :: iterator BST <T> :: erase(iterator & it);
+   friend BST <T, A, B, C, S> :: iterator BST <T, A, B, C, S> :: erase(iterator & it);
+   friend class BST <T, A, B, C, S>;
 
 private:
    
     // the node
     BNode * pNode;
+
+    // the tree, so that backing up from end() finds the largest
+    const BST * pTree;
 };
 
 
@@ -276,8 +774,30 @@ private:
  /*********************************************
   * BST :: DEFAULT CONSTRUCTOR
   ********************************************/
-template <typename T>
-BST <T> ::BST(): numElements(0), root(NULL)
+template <typename T, typename A, typename B, typename C, bool S>
+BST <T, A, B, C, S> ::BST(): root(NULL), numElements(0), pPool(nullptr), alloc(),
+   hasForeignNodes(false)
+{
+}
+
+/*********************************************
+ * BST :: ALLOCATOR CONSTRUCTOR
+ * An empty tree whose nodes will come from alloc. A
+ * std::pmr::memory_resource * converts to a pmr allocator.
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+BST <T, A, B, C, S> ::BST(const A & alloc): root(nullptr), numElements(0), pPool(nullptr), alloc(alloc),
+   hasForeignNodes(false)
+{
+}
+
+/*********************************************
+ * BST :: COMPARATOR CONSTRUCTOR
+ * An empty tree ordered by comp
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+BST <T, A, B, C, S> ::BST(const C & comp, const A & alloc): root(nullptr), numElements(0), pPool(nullptr),
+   alloc(alloc), comp(comp), hasForeignNodes(false)
 {
 }
 
@@ -285,35 +805,68 @@ BST <T> ::BST(): numElements(0), root(NULL)
  * BST :: COPY CONSTRUCTOR
  * Copy one tree to another
  ********************************************/
-template <typename T>
-BST <T> :: BST ( const BST<T>& rhs) : numElements(0), root(nullptr)
+template <typename T, typename A, typename B, typename C, bool S>
+BST <T, A, B, C, S> :: BST ( const BST <T, A, B, C, S>& rhs) : root(nullptr), numElements(0), pPool(nullptr),
+   alloc(Traits::select_on_container_copy_construction(rhs.alloc)), comp(rhs.comp),
+   hasForeignNodes(false)
 {
-    // Allocate the Node
-      *this = rhs;
+   clone(rhs);
+}
+
+/*********************************************
+ * BST :: INITIALIZER LIST CONSTRUCTOR
+ * Create a BST holding the values in the list
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+BST <T, A, B, C, S> :: BST(const std::initializer_list<T>& il) : root(nullptr), numElements(0),
+   pPool(nullptr), alloc(), hasForeignNodes(false)
+{
+   *this = il;
+}
 
+/*********************************************
+ * BST :: SORTED RANGE CONSTRUCTOR
+ * Create a balanced BST from a range that is already
+ * in order. See assign_sorted().
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <class Iterator>
+BST <T, A, B, C, S> :: BST(Iterator first, Iterator last, sorted_tag_t, const A & alloc) :
+   root(nullptr), numElements(0), pPool(nullptr), alloc(alloc), hasForeignNodes(false)
+{
+   assign_sorted(first, last);
 }
 
 /*********************************************
  * BST :: MOVE CONSTRUCTOR
  * Move one tree to another
  ********************************************/
-template <typename T>
-BST <T> :: BST(BST <T> && rhs): numElements(0), root(NULL)
+template <typename T, typename A, typename B, typename C, bool S>
+BST <T, A, B, C, S> :: BST(BST <T, A, B, C, S> && rhs): root(NULL), numElements(0), pPool(nullptr),
+   alloc(std::move(rhs.alloc)), comp(rhs.comp), hasForeignNodes(rhs.hasForeignNodes)
 {
    root = rhs.root;
    numElements = rhs.numElements;
+   pPool = rhs.pPool;
+   pMax = rhs.pMax;
+   maxElements = rhs.maxElements;
    
    rhs.root = nullptr;
    rhs.numElements = 0;
+   rhs.pPool = nullptr;
+   rhs.pMax = nullptr;
+   rhs.hasForeignNodes = false;
 }
 
 /*********************************************
  * BST :: DESTRUCTOR
  ********************************************/
-template <typename T>
-BST <T> :: ~BST()
+template <typename T, typename A, typename B, typename C, bool S>
+BST <T, A, B, C, S> :: ~BST()
 {
-
+   clear();
+   if (pPool)
+      pPool->detach();
 }
 
 
@@ -321,467 +874,2311 @@ BST <T> :: ~BST()
  * BST :: ASSIGNMENT OPERATOR
  * Copy one tree to another
  ********************************************/
-template <typename T>
-BST <T> & BST <T> :: operator = (const BST <T> & rhs)
+template <typename T, typename A, typename B, typename C, bool S>
+BST <T, A, B, C, S> & BST <T, A, B, C, S> :: operator = (const BST <T, A, B, C, S> & rhs)
+{
+   return assign(rhs, std::execution::seq);
+}
+
+/*********************************************
+ * BST :: ASSIGN with an EXECUTION POLICY
+ * Copy one tree to another, reusing the nodes already
+ * here. With a parallel policy, large subtrees are copied
+ * concurrently; see assignSubtree().
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <class ExecutionPolicy>
+BST <T, A, B, C, S> & BST <T, A, B, C, S> :: assign(const BST <T, A, B, C, S> & rhs, ExecutionPolicy &&)
 {
-   root->assign(root, rhs.root);
+   static_assert(std::is_execution_policy_v<std::decay_t<ExecutionPolicy> >,
+                 "assign() takes a std::execution policy");
+   if (this == &rhs)
+      return *this;
+
+   // take on the other tree's allocator: our nodes cannot be reused
+   if constexpr (Traits::propagate_on_container_copy_assignment::value)
+      if (!(alloc == rhs.alloc))
+      {
+         clear();
+         if (pPool)
+            pPool->detach();
+         pPool = nullptr;
+         alloc = rhs.alloc;
+      }
+
+   size_t numSplits = numSplitsFor<ExecutionPolicy>();
+   if (numSplits == 0 || rhs.root == nullptr)
+      BNode::assign(root, rhs.root, rhs.root ? pool() : pPool);
+   else
+   {
+      std::mutex poolLock;
+      assignSubtree(root, rhs.root, pool(), poolLock, numSplits, rhs.numElements);
+   }
    numElements = rhs.numElements;
+   comp = rhs.comp;
+   restore();
    return *this;
 }
 
+/*********************************************
+ * BST :: ASSIGN SUBTREE
+ * Copy pSrc onto pDest as BNode::assign() does, but hand
+ * the left subtree to another thread while this one does
+ * the right, numSplits levels deep. A subtree expected to
+ * hold fewer than a few thousand nodes is not worth a
+ * thread. The pool is shared, so it is only touched while
+ * holding poolLock; reused nodes never need it.
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: assignSubtree(BNode *& pDest, const BNode * pSrc, Pool * pPool,
+                                 std::mutex & poolLock, size_t numSplits, size_t numEstimate)
+{
+   if (pSrc == nullptr)
+   {
+      if (pDest)
+      {
+         std::lock_guard<std::mutex> guard(poolLock);
+         BNode::clear(pDest, pPool);
+      }
+      return;
+   }
+
+   if (pDest == nullptr)
+   {
+      void * pSlot;
+      {
+         std::lock_guard<std::mutex> guard(poolLock);
+         pSlot = pPool->allocate();
+      }
+      pDest = ::new (pSlot) BNode(pSrc->data);
+   }
+   else
+      pDest->data = pSrc->data;
+   pDest->setMeta(pSrc->meta());
+
+   if (numSplits > 0 && numEstimate >= 4096)
+   {
+      auto left = std::async(std::launch::async, [&]()
+      {
+         assignSubtree(pDest->pLeft, pSrc->pLeft, pPool, poolLock, numSplits - 1, numEstimate / 2);
+      });
+      assignSubtree(pDest->pRight, pSrc->pRight, pPool, poolLock, numSplits - 1, numEstimate / 2);
+      left.get();
+   }
+   else
+   {
+      assignSubtree(pDest->pLeft,  pSrc->pLeft,  pPool, poolLock, 0, 0);
+      assignSubtree(pDest->pRight, pSrc->pRight, pPool, poolLock, 0, 0);
+   }
+
+   if (pDest->pLeft)
+      pDest->pLeft->pParent = pDest;
+   if (pDest->pRight)
+      pDest->pRight->pParent = pDest;
+}
+
 /*********************************************
  * BST :: ASSIGNMENT OPERATOR with INITIALIZATION LIST
  * Copy nodes onto a BTree
  ********************************************/
-template <typename T>
-BST <T> & BST <T> :: operator = (const std::initializer_list<T>& il)
+template <typename T, typename A, typename B, typename C, bool S>
+BST <T, A, B, C, S> & BST <T, A, B, C, S> :: operator = (const std::initializer_list<T>& il)
 {
+   if (std::is_sorted(il.begin(), il.end(),
+                      [this](const T & lhs, const T & rhs) { return less(comp, lhs, rhs); }))
+      assign_sorted(il.begin(), il.end());
+   else
+   {
+      clear();
+      for (const T & t : il)
+         insert(t);
+   }
    return *this;
 }
 
 /*********************************************
- * BST :: ASSIGN-MOVE OPERATOR
- * Move one tree to another
+ * BST :: ASSIGN SORTED
+ * Replace the contents with a range that is already in
+ * ascending order. Every node is reserved up front and
+ * the tree is built bottom-up in one pass without any
+ * comparisons, so this is O(n). The result is perfectly
+ * balanced and a valid red-black tree: every level is
+ * black except a partly filled bottom level, which is red.
  ********************************************/
-template <typename T>
-BST <T> & BST <T> :: operator = (BST <T> && rhs)
+template <typename T, typename A, typename B, typename C, bool S>
+template <class Iterator>
+void BST <T, A, B, C, S> :: assign_sorted(Iterator first, Iterator last)
 {
    clear();
-   
-   swap(rhs);
-   return *this;
+   size_t n = std::distance(first, last);
+   if (n == 0)
+      return;
+   pool()->reserve(n);
+
+   root = buildSorted(first, n, 0, redDepthFor(n));
+   root->pParent = nullptr;
+   numElements = n;
+   restore();
 }
+
 /*********************************************
- * BST :: SWAP
- * Swap two trees
+ * BST :: CLONE
+ * Copy the shape and colors of another tree into this
+ * empty one. The nodes come from one run of slabs,
+ * in pre-order, and the walk follows the parent links
+ * instead of recursing, so no depth is too deep and no
+ * element is ever compared.
  ********************************************/
-template <typename T>
-void BST <T> :: swap (BST <T>& rhs)
-{
-   BNode * tempRoot = rhs.root;
-   rhs.root = root;
-   root = tempRoot;
-   
-   size_t tempElements = rhs.numElements;
-   rhs.numElements = numElements;
-   numElements = tempElements;
-}
-/*****************************************************
- * BST :: INSERT
- * Insert a node at a given location in the tree
- ****************************************************/
-template <typename T>
-std::pair<typename BST <T> :: iterator, bool> BST <T> :: insert(const T & t, bool keepUnique)
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: clone(const BST & rhs)
 {
-   BNode* currentNode = root;
-   bool found = false;
-   
-   while (!found && currentNode != nullptr)
+   assert(root == nullptr);
+   if (rhs.root == nullptr)
+      return;
+
+   size_t n = rhs.numElements;
+   void * pRun = pool()->claim(n);
+   size_t i = 0;
+   const BNode * pSrc = rhs.root;
+   BNode * pDest = root = cloneNode(pSrc, Pool::slot(pRun, i++));
+   root->pParent = nullptr;
+
+   // a null child in the copy that is not null in the source
+   // is a subtree still to visit
+   while (pDest)
    {
-      if (keepUnique == false)
+      BNode * pChild = nullptr;
+      if (pSrc->pLeft && !pDest->pLeft)
       {
-         BNode* newNode = new BNode(t);
-         if (newNode->data < currentNode->data)
-         {
-
-            currentNode->pLeft = newNode;
-            newNode->pParent = root;
-            numElements += 1;
-            found = true;
-            std::pair<iterator, bool> pairReturn( newNode, true);
-            return pairReturn;
+         assert(i < n);
+         pSrc = pSrc->pLeft;
+         pChild = pDest->pLeft = cloneNode(pSrc, Pool::slot(pRun, i++));
+      }
+      else if (pSrc->pRight && !pDest->pRight)
+      {
+         assert(i < n);
+         pSrc = pSrc->pRight;
+         pChild = pDest->pRight = cloneNode(pSrc, Pool::slot(pRun, i++));
+      }
 
-         }
-         else
-         {
-            currentNode->pRight = newNode;
-            newNode->pParent = root;
-            numElements += 1;
-            found = true;
-            std::pair<iterator, bool> pairReturn( newNode, true);
-            return pairReturn;
-         }
+      if (pChild)
+      {
+         pChild->pParent = pDest;
+         pDest = pChild;
       }
       else
       {
-         if (t == currentNode->data)
-         {
-            found = true;
-            std::pair<iterator, bool> pairReturn( currentNode, false);
-            return pairReturn;
-         }
-         else if (t < currentNode->data)
-         {
-            if (currentNode->pLeft != nullptr)
-            {
-               currentNode = currentNode->pLeft;
-            }
-         }
-         else
-         {
-            if (currentNode->pRight != nullptr)
-            {
-               currentNode = currentNode->pRight;
-            }
-         }
+         pSrc  = pSrc->pParent;
+         pDest = pDest->pParent;
       }
+   }
 
+   assert(i == n);
+   numElements = n;
+   restore();
+}
 
+/*********************************************
+ * BST :: CLONE NODE
+ * Copy the element and color of one node into a slot.
+ * Nodes of trivially copyable elements are copied whole.
+ * The links are left null.
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: BNode * BST <T, A, B, C, S> :: cloneNode(const BNode * pSrc, void * pSlot)
+{
+   BNode * pNode;
+   if constexpr (std::is_trivially_copyable_v<T>)
+   {
+      std::memcpy(pSlot, pSrc, sizeof(BNode));
+      pNode = std::launder(static_cast<BNode *>(pSlot));
+      pNode->pParent = nullptr;
    }
-   
-   std::pair<iterator, bool> pairReturn(end(), false);
-   return pairReturn;
+   else
+   {
+      pNode = ::new (pSlot) BNode(pSrc->data);
+      pNode->setMeta(pSrc->meta());
+   }
+   pNode->pLeft  = nullptr;
+   pNode->pRight = nullptr;
+   return pNode;
 }
 
-template <typename T>
-std::pair<typename BST <T> ::iterator, bool> BST <T> ::insert(T && t, bool keepUnique)
+/*********************************************
+ * BST :: RED DEPTH FOR
+ * In a perfectly balanced tree of n nodes, the depth whose
+ * nodes are red: the bottom level if it is partly filled,
+ * otherwise none at all
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+size_t BST <T, A, B, C, S> :: redDepthFor(size_t n)
 {
-   BNode* currentNode = root;
-   bool found = false;
-   
-   while (!found && currentNode != nullptr)
-   {
-      if (keepUnique == false)
-      {
-    
-         if (t < currentNode->data)
-         {
-            BNode* newNode = new BNode(std::move(t));
-            currentNode->pLeft = newNode;
-            newNode->pParent = root;
-            numElements += 1;
-            found = true;
-            std::pair<iterator, bool> pairReturn( newNode, true);
-            return pairReturn;
+   // the depth of the bottom level: floor(log2(n))
+   size_t height = 0;
+   while (((size_t)2 << height) <= n)
+      height++;
+   bool isFull = n + 1 == ((size_t)2 << height);
+   return isFull ? (size_t)-1 : height;
+}
 
+/*********************************************
+ * BST :: BUILD
+ * Replace the contents with a range in any order. The
+ * values are sorted, duplicates dropped if keepUnique,
+ * and a balanced red-black tree is hung over them as in
+ * assign_sorted(). With a parallel execution policy the
+ * sort and the construction of subtrees are spread over
+ * the cores. Every node has its own slot in one run of
+ * slabs claimed up front, so the threads never share
+ * the pool or each other's nodes.
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <class Iterator, class ExecutionPolicy>
+void BST <T, A, B, C, S> :: build(Iterator first, Iterator last, ExecutionPolicy &&, bool keepUnique)
+{
+   static_assert(std::is_execution_policy_v<std::decay_t<ExecutionPolicy> >,
+                 "build() takes a std::execution policy");
+   std::vector<T, A> values(first, last, alloc);
+   size_t numSplits = numSplitsFor<ExecutionPolicy>();
+
+   sortParallel(values.data(), values.data() + values.size(), numSplits, comp);
+   if (keepUnique)
+      values.erase(std::unique(values.begin(), values.end(),
+                   [this](const T & lhs, const T & rhs) { return !less(comp, lhs, rhs); }),
+                   values.end());
+
+   clear();
+   size_t n = values.size();
+   if (n == 0)
+      return;
+   void * pRun = pool()->claim(n);
+   root = buildSlots(values.data(), 0, n, 0, redDepthFor(n), pRun, numSplits);
+   root->pParent = nullptr;
+   numElements = n;
+   restore();
+}
+
+/*********************************************
+ * BST :: NUM SPLITS FOR
+ * How many times to halve the work so every core has
+ * some: log2(cores) for a parallel policy, none otherwise
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <class ExecutionPolicy>
+size_t BST <T, A, B, C, S> :: numSplitsFor()
+{
+   size_t numSplits = 0;
+   if constexpr (!std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::sequenced_policy>)
+      for (size_t cores = std::thread::hardware_concurrency(); cores > 1; cores /= 2)
+         numSplits++;
+   return numSplits;
+}
+
+/*********************************************
+ * BST :: SORT PARALLEL
+ * Sort the halves concurrently and merge them, numSplits
+ * levels deep. Small ranges are not worth a thread.
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: sortParallel(T * pBegin, T * pEnd, size_t numSplits, const C & comp)
+{
+   auto isLess = [&comp](const T & lhs, const T & rhs) { return less(comp, lhs, rhs); };
+   if (numSplits == 0 || pEnd - pBegin < 4096)
+   {
+      std::sort(pBegin, pEnd, isLess);
+      return;
+   }
+
+   T * pMiddle = pBegin + (pEnd - pBegin) / 2;
+   auto left = std::async(std::launch::async, sortParallel, pBegin, pMiddle, numSplits - 1,
+                          std::cref(comp));
+   sortParallel(pMiddle, pEnd, numSplits - 1, comp);
+   left.get();
+   std::inplace_merge(pBegin, pMiddle, pEnd, isLess);
+}
+
+/*********************************************
+ * BST :: BUILD SLOTS
+ * Build a subtree from the sorted values [lo, hi), each
+ * moved into node slot i of the claimed run. The left
+ * subtree is built on its own thread numSplits levels deep.
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: BNode * BST <T, A, B, C, S> :: buildSlots(T * values, size_t lo, size_t hi,
+   size_t depth, size_t redDepth, void * pRun, size_t numSplits)
+{
+   if (lo == hi)
+      return nullptr;
+
+   size_t middle = lo + (hi - lo - 1) / 2;
+   BNode * pLeft;
+   BNode * pRight;
+   if (numSplits > 0 && hi - lo >= 4096)
+   {
+      auto left = std::async(std::launch::async, buildSlots, values, lo, middle,
+                             depth + 1, redDepth, pRun, numSplits - 1);
+      pRight = buildSlots(values, middle + 1, hi, depth + 1, redDepth, pRun, numSplits - 1);
+      pLeft = left.get();
+   }
+   else
+   {
+      pLeft  = buildSlots(values, lo, middle, depth + 1, redDepth, pRun, 0);
+      pRight = buildSlots(values, middle + 1, hi, depth + 1, redDepth, pRun, 0);
+   }
+
+   BNode * pNode = ::new (Pool::slot(pRun, middle)) BNode(std::move(values[middle]));
+   B::label(pNode, depth, redDepth, middle - lo, hi - middle - 1);
+   pNode->pLeft  = pLeft;
+   pNode->pRight = pRight;
+   if (pLeft)
+      pLeft->pParent = pNode;
+   if (pRight)
+      pRight->pParent = pNode;
+   return pNode;
+}
+
+/*********************************************
+ * BST :: BUILD SORTED
+ * Build a subtree from the next n values of the range,
+ * rooted at the middle one. The balance policy labels each
+ * node; for red-black, nodes at redDepth are red.
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <class Iterator>
+typename BST <T, A, B, C, S> :: BNode * BST <T, A, B, C, S> :: buildSorted(Iterator & it, size_t n,
+                                                          size_t depth, size_t redDepth)
+{
+   if (n == 0)
+      return nullptr;
+
+   size_t numLeft = (n - 1) / 2;
+   BNode * pLeft = buildSorted(it, numLeft, depth + 1, redDepth);
+   BNode * pNode = new (pPool) BNode(*it);
+   ++it;
+   B::label(pNode, depth, redDepth, numLeft, n - 1 - numLeft);
+   pNode->pLeft = pLeft;
+   if (pLeft)
+      pLeft->pParent = pNode;
+   pNode->pRight = buildSorted(it, n - 1 - numLeft, depth + 1, redDepth);
+   if (pNode->pRight)
+      pNode->pRight->pParent = pNode;
+   return pNode;
+}
+
+/*********************************************
+ * BST :: ASSIGN-MOVE OPERATOR
+ * Move one tree to another
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+BST <T, A, B, C, S> & BST <T, A, B, C, S> :: operator = (BST <T, A, B, C, S> && rhs)
+{
+   clear();
+
+   // allocators that neither propagate nor agree cannot share nodes
+   if (!Traits::propagate_on_container_move_assignment::value && !(alloc == rhs.alloc))
+   {
+      *this = rhs;
+      rhs.clear();
+      return *this;
+   }
+
+   if constexpr (Traits::propagate_on_container_move_assignment::value)
+      alloc = rhs.alloc;
+   std::swap(root, rhs.root);
+   std::swap(numElements, rhs.numElements);
+   std::swap(pPool, rhs.pPool);
+   std::swap(pMax, rhs.pMax);
+   std::swap(maxElements, rhs.maxElements);
+   std::swap(hasForeignNodes, rhs.hasForeignNodes);
+   comp = rhs.comp;
+   return *this;
+}
+/*********************************************
+ * BST :: SWAP
+ * Swap two trees
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: swap (BST <T, A, B, C, S>& rhs)
+{
+   BNode * tempRoot = rhs.root;
+   rhs.root = root;
+   root = tempRoot;
+   
+   size_t tempElements = rhs.numElements;
+   rhs.numElements = numElements;
+   numElements = tempElements;
+
+   Pool * tempPool = rhs.pPool;
+   rhs.pPool = pPool;
+   pPool = tempPool;
+
+   BNode * tempMax = rhs.pMax;
+   rhs.pMax = pMax;
+   pMax = tempMax;
+
+   size_t tempMaxElements = rhs.maxElements;
+   rhs.maxElements = maxElements;
+   maxElements = tempMaxElements;
+
+   bool tempForeign = rhs.hasForeignNodes;
+   rhs.hasForeignNodes = hasForeignNodes;
+   hasForeignNodes = tempForeign;
+
+   std::swap(comp, rhs.comp);
+
+   if constexpr (Traits::propagate_on_container_swap::value)
+      std::swap(alloc, rhs.alloc);
+   else
+      assert(alloc == rhs.alloc);
+}
+
+/*********************************************
+ * BST :: SHRINK TO FIT
+ * Give every slab that holds no live nodes back to the allocator
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: shrink_to_fit()
+{
+   if (pPool)
+      pPool->releaseEmptySlabs();
+}
+
+/*********************************************
+ * BST :: POOL
+ * The slab allocator for this tree, created on first use
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: Pool * BST <T, A, B, C, S> :: pool()
+{
+   if (pPool == nullptr)
+      pPool = Pool::create(alloc);
+   return pPool;
+}
+/*****************************************************
+ * BST :: INSERT
+ * Insert a node at a given location in the tree
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+std::pair<typename BST <T, A, B, C, S> :: iterator, bool> BST <T, A, B, C, S> :: insert(const T & t, bool keepUnique)
+{
+   return insertNode(t, keepUnique);
+}
+
+template <typename T, typename A, typename B, typename C, bool S>
+std::pair<typename BST <T, A, B, C, S> ::iterator, bool> BST <T, A, B, C, S> ::insert(T && t, bool keepUnique)
+{
+   return insertNode(std::move(t), keepUnique);
+}
+
+/*****************************************************
+ * BST :: INSERT NODE
+ * Walk down to the leaf where t belongs and hang a new
+ * node from the tree's pool there. Duplicates go right.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <typename U>
+std::pair<typename BST <T, A, B, C, S> ::iterator, bool> BST <T, A, B, C, S> ::insertNode(U && t, bool keepUnique)
+{
+   BNode * pParent;
+   bool isLeft;
+   BNode * pSame = findParent(t, keepUnique, pParent, isLeft);
+   if (pSame)
+      return std::pair<iterator, bool>(iterator(pSame, this), false);
+
+   BNode * newNode = new (pool()) BNode(std::forward<U>(t));
+   link(newNode, pParent, isLeft);
+   return std::pair<iterator, bool>(iterator(newNode, this), true);
+}
+
+/*****************************************************
+ * BST :: INSERT with a HINT
+ * Insert t as close as possible before hint. When t
+ * belongs between hint and the one before it, the new
+ * node hangs from whichever of the two has the free
+ * side: no walk from the root, two comparisons.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: iterator BST <T, A, B, C, S> :: insert(iterator hint, const T & t, bool keepUnique)
+{
+   return insertHinted(hint, t, keepUnique);
+}
+
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: iterator BST <T, A, B, C, S> :: insert(iterator hint, T && t, bool keepUnique)
+{
+   return insertHinted(hint, std::move(t), keepUnique);
+}
+
+/*****************************************************
+ * BST :: INSERT HINTED
+ * pNext is the hint and pPrev the one before it; at the
+ * end, pPrev is the largest. If pNext has a left child,
+ * pPrev is the bottom right of it and has no right child.
+ * A hint in the wrong place costs the usual walk.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <typename U>
+typename BST <T, A, B, C, S> :: iterator BST <T, A, B, C, S> :: insertHinted(iterator hint, U && t, bool keepUnique)
+{
+   BNode * pNext = hint.pNode;
+   BNode * pPrev = pNext ? (--iterator(pNext)).pNode : pMax;
+
+   if ((pPrev == nullptr || !less(comp, t, pPrev->data)) &&
+       (pNext == nullptr || !less(comp, pNext->data, t)))
+   {
+      if (keepUnique && pPrev && !less(comp, pPrev->data, t))
+         return iterator(pPrev, this);
+      if (keepUnique && pNext && !less(comp, t, pNext->data))
+         return iterator(pNext, this);
+
+      BNode * newNode = new (pool()) BNode(std::forward<U>(t));
+      if (pNext && pNext->pLeft == nullptr)
+         link(newNode, pNext, true /*isLeft*/);
+      else
+         link(newNode, pPrev, false /*isLeft*/);
+      return iterator(newNode, this);
+   }
+
+   return insertNode(std::forward<U>(t), keepUnique).first;
+}
+
+/*****************************************************
+ * BST :: FIND PARENT
+ * The node a new t hangs from, and on which side. Each
+ * level costs one comparison: t goes left of anything
+ * greater and right of the rest. The last node it went
+ * right of is the largest not greater than t, so with
+ * keepUnique one more comparison tells whether t is
+ * already there; that node is returned, else nullptr.
+ * A three-way comparator knows equal at once.
+ * Anything not less than the largest is an append and
+ * goes right of it without walking down at all.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: BNode * BST <T, A, B, C, S> :: findParent(const T & t, bool keepUnique,
+                                                                BNode *& pParent, bool & isLeft) const
+{
+   BNode * pNotGreater = nullptr;
+   pParent = nullptr;
+   isLeft = false;
+
+   if (pMax)
+   {
+      if constexpr (isThreeWay)
+      {
+         auto order = comp(t, pMax->data);
+         if (keepUnique && order == 0)
+            return pMax;
+         if (order >= 0)
+         {
+            pParent = pMax;
+            return nullptr;
          }
+      }
+      else if (!comp(t, pMax->data))
+      {
+         if (keepUnique && !comp(pMax->data, t))
+            return pMax;
+         pParent = pMax;
+         return nullptr;
+      }
+   }
+
+   for (BNode * currentNode = root; currentNode != nullptr;
+        currentNode = isLeft ? currentNode->pLeft : currentNode->pRight)
+   {
+      pParent = currentNode;
+      if constexpr (isThreeWay)
+      {
+         auto order = comp(t, currentNode->data);
+         if (keepUnique && order == 0)
+            return currentNode;
+         isLeft = order < 0;
+      }
+      else
+      {
+         isLeft = comp(t, currentNode->data);
+         if (!isLeft)
+            pNotGreater = currentNode;
+      }
+   }
+
+   if constexpr (!isThreeWay)
+      if (keepUnique && pNotGreater && !comp(pNotGreater->data, t))
+         return pNotGreater;
+   return nullptr;
+}
+
+/*************************************************
+ * BST :: ERASE
+ * Remove a given node as specified by the iterator
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> ::iterator BST <T, A, B, C, S> :: erase(iterator & it)
+{
+   if(it.pNode == nullptr)
+      return end();
+
+   BNode * pDelete = it.pNode;
+   ++it;
+   unlink(pDelete);
+   BNode::dispose(pDelete, pPool);
+   return it;
+}
+
+/*************************************************
+ * BST :: ERASE a VALUE
+ * Remove every element equal to a given value and
+ * return how many there were
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+size_t BST <T, A, B, C, S> :: erase(const T & t)
+{
+   return eraseAll(t);
+}
+
+template <typename T, typename A, typename B, typename C, bool S>
+template <class K, class CC, class, class>
+size_t BST <T, A, B, C, S> :: erase(const K & k)
+{
+   return eraseAll(k);
+}
+
+template <typename T, typename A, typename B, typename C, bool S>
+template <class K>
+size_t BST <T, A, B, C, S> :: eraseAll(const K & k)
+{
+   size_t num = 0;
+   iterator it(lowerBoundNode(k), this);
+   while (it != end() && !less(comp, k, *it))
+   {
+      erase(it);
+      num++;
+   }
+   return num;
+}
+
+/*************************************************
+ * BST :: EXTRACT
+ * Take a node out of the tree and hand it to the caller
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: node_type BST <T, A, B, C, S> :: extract(iterator it)
+{
+   if (it.pNode == nullptr)
+      return node_type();
+   unlink(it.pNode);
+   return node_type(it.pNode);
+}
+
+/*************************************************
+ * BST :: INSERT a NODE
+ * Hang a node extracted from this or another tree
+ * where it belongs. The node and its data stay put.
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+std::pair<typename BST <T, A, B, C, S> :: iterator, bool> BST <T, A, B, C, S> :: insert(node_type && node, bool keepUnique)
+{
+   if (node.empty())
+      return std::pair<iterator, bool>(end(), false);
+
+   BNode * pParent;
+   bool isLeft;
+   BNode * pSame = findParent(node.pNode->data, keepUnique, pParent, isLeft);
+   if (pSame)
+      return std::pair<iterator, bool>(iterator(pSame, this), false);
+
+   BNode * newNode = node.pNode;
+   node.pNode = nullptr;
+   if (pPool == nullptr || Pool::owner(newNode) != pPool)
+      hasForeignNodes = true;
+
+   link(newNode, pParent, isLeft);
+   return std::pair<iterator, bool>(iterator(newNode, this), true);
+}
+
+/*************************************************
+ * BST :: LINK
+ * Hang a new node below pParent as a leaf and let
+ * the balance policy restore its rules above it.
+ * Rotations never change which node is largest.
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: link(BNode * pNode, BNode * pParent, bool isLeft)
+{
+   pNode->pLeft = pNode->pRight = nullptr;
+   pNode->pParent = pParent;
+   pNode->setMeta(0);
+   if (pParent == nullptr)
+      root = pNode;
+   else if (isLeft)
+      pParent->addLeft(pNode);
+   else
+      pParent->addRight(pNode);
+   numElements += 1;
+   if (pParent == pMax && !isLeft)
+      pMax = pNode;
+
+   if constexpr (S)
+   {
+      pNode->numNodes = 1;
+      for (BNode * pUp = pParent; pUp; pUp = pUp->pParent)
+         pUp->numNodes++;
+   }
+
+   B::inserted(*this, pNode);
+   while (root->pParent)
+      root = root->pParent;
+}
+
+/*************************************************
+ * BST :: UNLINK
+ * Detach a node from the tree without destroying it.
+ * The balance policy takes it out and rebalances. The
+ * largest has no right child, so if it goes, the one
+ * before it is its parent or just below it.
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: unlink(BNode * pNode)
+{
+   if (pNode == pMax)
+      pMax = (--iterator(pNode)).pNode;
+   B::unlink(*this, pNode);
+
+   pNode->pLeft = pNode->pRight = nullptr;
+   pNode->pParent = nullptr;
+   pNode->setMeta(0);
+   numElements--;
+}
+
+/*************************************************
+ * BST :: SWAP WITH SUCCESSOR
+ * A node with two children trades places with its
+ * successor, so no data is ever copied or moved. The
+ * metadata and the subtree size stay with the place,
+ * not the node.
+ * Afterwards pNode has at most a right child.
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: swapWithSuccessor(BNode * pNode)
+{
+   assert(pNode->pLeft && pNode->pRight);
+   BNode * pSuccessor = pNode->pRight;
+   while (pSuccessor->pLeft)
+      pSuccessor = pSuccessor->pLeft;
+   BNode * pRight = pSuccessor->pRight;
+
+   unsigned meta = pNode->meta();
+   pNode->setMeta(pSuccessor->meta());
+   pSuccessor->setMeta(meta);
+   if constexpr (S)
+      std::swap(pNode->numNodes, pSuccessor->numNodes);
+
+   if (pSuccessor == pNode->pRight)
+   {
+      relink(pNode, pSuccessor);
+      pSuccessor->pRight = pNode;
+      pNode->pParent = pSuccessor;
+   }
+   else
+   {
+      BNode * pSuccessorParent = pSuccessor->pParent;
+      relink(pNode, pSuccessor);
+      pSuccessorParent->pLeft = pNode;
+      pNode->pParent = pSuccessorParent;
+      pSuccessor->pRight = pNode->pRight;
+      pSuccessor->pRight->pParent = pSuccessor;
+   }
+   pSuccessor->pLeft = pNode->pLeft;
+   pSuccessor->pLeft->pParent = pSuccessor;
+
+   pNode->pLeft = nullptr;
+   pNode->pRight = pRight;
+   if (pRight)
+      pRight->pParent = pNode;
+}
+
+/*************************************************
+ * BST :: FIX DOUBLE BLACK
+ * A black node was removed from above pNode (possibly
+ * nullptr), whose parent is pParent, so every path through
+ * pNode is one black short. Borrow from the sibling's side
+ * by recoloring and rotating, moving up while the sibling
+ * has no red to spare.
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: fixDoubleBlack(BNode * pNode, BNode * pParent)
+{
+   while (pNode != root && !BNode::isRed(pNode))
+   {
+      bool isLeft = pParent->pLeft == pNode;
+      BNode * pSibling = isLeft ? pParent->pRight : pParent->pLeft;
+
+      // only possible in a tree that was never balanced: nothing to borrow
+      if (pSibling == nullptr)
+      {
+         pNode = pParent;
+         pParent = pNode->pParent;
+         continue;
+      }
+
+      // Case 1: a red sibling. Rotate it up so the sibling is black
+      if (pSibling->isRed())
+      {
+         pSibling->setRed(false);
+         pParent->setRed(true);
+         if (isLeft)
+            pParent->rotateLeft();
+         else
+            pParent->rotateRight();
+         stats.singleRotations++;
+         if (root == pParent)
+            root = pSibling;
+         pSibling = isLeft ? pParent->pRight : pParent->pLeft;
+         if (pSibling == nullptr)
+            continue;
+      }
+
+      BNode * pNear = isLeft ? pSibling->pLeft  : pSibling->pRight;
+      BNode * pFar  = isLeft ? pSibling->pRight : pSibling->pLeft;
+
+      // Case 2: a black sibling with black children. Push the problem up
+      if (!BNode::isRed(pNear) && !BNode::isRed(pFar))
+      {
+         pSibling->setRed(true);
+         stats.recolors++;
+         pNode = pParent;
+         pParent = pNode->pParent;
+         continue;
+      }
+
+      // Case 3: only the near nephew is red. Rotate it into the far spot
+      // so that together with case 4 this is a double rotation
+      bool isDouble = !BNode::isRed(pFar);
+      if (isDouble)
+      {
+         pNear->setRed(false);
+         pSibling->setRed(true);
+         if (isLeft)
+            pSibling->rotateRight();
          else
+            pSibling->rotateLeft();
+         pFar = pSibling;
+         pSibling = pNear;
+      }
+
+      // Case 4: the far nephew is red. One rotation settles it
+      pSibling->setRed(pParent->isRed());
+      pParent->setRed(false);
+      pFar->setRed(false);
+      if (isLeft)
+         pParent->rotateLeft();
+      else
+         pParent->rotateRight();
+      if (isDouble)
+         stats.doubleRotations++;
+      else
+         stats.singleRotations++;
+      if (root == pParent)
+         root = pSibling;
+      pNode = root;
+   }
+
+   if (pNode)
+      pNode->setRed(false);
+}
+
+/*************************************************
+ * BST :: REPLACE
+ * Take pOld out of the tree, putting its only child
+ * pNew (possibly nullptr) where it hangs. Every subtree
+ * above is now one smaller.
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: replace(BNode * pOld, BNode * pNew)
+{
+   assert(pNew == nullptr || pNew == pOld->pLeft || pNew == pOld->pRight);
+   relink(pOld, pNew);
+   if constexpr (S)
+      for (BNode * pUp = pOld->pParent; pUp; pUp = pUp->pParent)
+         pUp->numNodes--;
+}
+
+/*************************************************
+ * BST :: RESTORE
+ * A tree was built or copied wholesale: count the
+ * subtrees if we keep their sizes, let the balance
+ * policy fix up what it needs to, and find the largest
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: restore()
+{
+   if constexpr (S)
+      countSubtrees(root);
+   B::restore(*this);
+
+   pMax = root;
+   while (pMax && pMax->pRight)
+      pMax = pMax->pRight;
+}
+
+/*************************************************
+ * BST :: COUNT SUBTREES
+ * Set the size of every subtree, children first. The
+ * walk follows the parent links rather than recursing,
+ * so no tree is too deep.
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: countSubtrees(BNode * pRoot)
+{
+   // the first node in post-order below pNode
+   auto deepest = [](BNode * pNode)
+   {
+      while (pNode->pLeft || pNode->pRight)
+         pNode = pNode->pLeft ? pNode->pLeft : pNode->pRight;
+      return pNode;
+   };
+
+   if (pRoot == nullptr)
+      return;
+   BNode * pNode = deepest(pRoot);
+   while (true)
+   {
+      pNode->numNodes = 1 + sizeOf(pNode->pLeft) + sizeOf(pNode->pRight);
+      if (pNode == pRoot)
+         return;
+      BNode * pUp = pNode->pParent;
+      pNode = (pUp->pLeft == pNode && pUp->pRight) ? deepest(pUp->pRight) : pUp;
+   }
+}
+
+/*************************************************
+ * BST :: RELINK
+ * Put pNew (possibly nullptr) where pOld hangs
+ ************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: relink(BNode * pOld, BNode * pNew)
+{
+   BNode * pParent = pOld->pParent;
+   if (pParent == nullptr)
+      root = pNew;
+   else if (pParent->pLeft == pOld)
+      pParent->pLeft = pNew;
+   else
+      pParent->pRight = pNew;
+
+   if (pNew)
+      pNew->pParent = pParent;
+}
+
+/*****************************************************
+ * BST :: CLEAR
+ * Removes all the BNodes from a tree
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> ::clear() noexcept
+{
+   // every node came from our own slabs, nothing else is in them, and
+   // they are not to be kept for recycling: destroy the elements that
+   // need it, then drop the slabs
+   if (pPool)
+      pPool->drain();
+   if (pPool && !hasForeignNodes && pPool->size() == numElements &&
+       (std::is_trivially_destructible<T>::value || !pPool->canRecycle(numElements)))
+   {
+      if constexpr (!std::is_trivially_destructible<T>::value)
+         BNode::teardown(root, [](BNode * pNode) { pNode->~BNode(); });
+      pPool->releaseAll();
+   }
+   else
+      BNode::clear(root, pPool);
+   hasForeignNodes = false;
+   numElements = 0;
+   root= nullptr;
+   pMax = nullptr;
+}
+
+/*****************************************************
+ * BST :: RELEASE ASYNC
+ * Empty the tree in O(1) and leave the freeing to the
+ * reclaimer thread. It destroys the elements and hands
+ * the slabs back a bounded amount at a time. Only a tree
+ * that is the sole user of its pool can be handed over,
+ * and only if A is reclaim_safe, as the reclaimer frees
+ * through it while other threads allocate; anything else
+ * is cleared here and now. The allocator must outlive the
+ * reclaimer's work.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: release_async()
+{
+   if constexpr (!reclaim_safe<A>::value)
+   {
+      clear();
+      return;
+   }
+   if (pPool)
+      pPool->drain();
+   if (!pPool || hasForeignNodes || pPool->size() != numElements)
+   {
+      clear();
+      return;
+   }
+
+   BNode * pRemaining = root;
+   Pool * pDoomed = pPool;
+   root = nullptr;
+   numElements = 0;
+   pPool = nullptr;
+   pMax = nullptr;
+
+   Reclaimer::instance().submit([pRemaining, pDoomed]() mutable
+   {
+      const size_t nodesPerStep = 65536;
+      if constexpr (!std::is_trivially_destructible<T>::value)
+         if (pRemaining)
          {
-            BNode* newNode = new BNode(std::move(t));
-            currentNode->pRight = newNode;
-            newNode->pParent = currentNode;
-            numElements += 1;
-            found = true;
-            std::pair<iterator, bool> pairReturn( newNode, true);
-            return pairReturn;
+            pRemaining = BNode::teardown(pRemaining,
+               [](BNode * pNode) { pNode->~BNode(); }, nodesPerStep);
+            return false;
          }
+      if (pDoomed->releaseRun())
+         return false;
+      Pool::destroy(pDoomed);
+      return true;
+   });
+}
+
+/*****************************************************
+ * BST :: BEGIN
+ * Return the first node (left-most) in a binary search tree
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: iterator custom :: BST <T, A, B, C, S> :: begin() const noexcept
+{
+   if(empty())
+      return end();
+   BNode * currentNode = root;
+   
+   while(currentNode->pLeft)
+   {
+      currentNode = currentNode->pLeft;
+   }
+   return iterator(currentNode, this);
+}
+
+
+/****************************************************
+ * BST :: FIND
+ * Return the node corresponding to a given value
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: iterator BST <T, A, B, C, S> :: find(const T & t)
+{
+   return iterator(findNode(t), this);
+}
+
+/****************************************************
+ * BST :: FIND NODE
+ * The node equal to k, or nullptr. With a two-way
+ * comparator this is the lower bound and one more
+ * comparison: it is k unless k is less than it. With
+ * duplicates, this finds the first. A three-way
+ * comparator stops as soon as it sees k.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <class K>
+typename BST <T, A, B, C, S> :: BNode * BST <T, A, B, C, S> :: findNode(const K & k) const
+{
+   if constexpr (isThreeWay)
+   {
+      BNode * currentNode = root;
+      while (currentNode != nullptr)
+      {
+         auto order = comp(k, currentNode->data);
+         if (order == 0)
+            return currentNode;
+         currentNode = order < 0 ? currentNode->pLeft : currentNode->pRight;
       }
+      return nullptr;
+   }
+   else
+   {
+      BNode * pNotLess = lowerBoundNode(k);
+      if (pNotLess && !comp(k, pNotLess->data))
+         return pNotLess;
+      return nullptr;
+   }
+}
+
+/****************************************************
+ * BST :: LOWER BOUND NODE
+ * The first node not less than k, or nullptr. One
+ * comparison a level: go right past anything less than
+ * k, else note the node and go left. The last node
+ * noted is the answer.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <class K>
+typename BST <T, A, B, C, S> :: BNode * BST <T, A, B, C, S> :: lowerBoundNode(const K & k) const
+{
+   BNode * currentNode = root;
+   BNode * pNotLess = nullptr;
+   while (currentNode != nullptr)
+   {
+      if (less(comp, currentNode->data, k))
+         currentNode = currentNode->pRight;
       else
       {
-         if (t == currentNode->data)
-         {
-            found = true;
-            std::pair<iterator, bool> pairReturn( currentNode, false);
-            return pairReturn;
-         }
-         else if (t < currentNode->data)
+         pNotLess = currentNode;
+         currentNode = currentNode->pLeft;
+      }
+   }
+   return pNotLess;
+}
+
+/****************************************************
+ * BST :: UPPER BOUND NODE
+ * The first node greater than k, or nullptr: the mirror
+ * image of lowerBoundNode()
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <class K>
+typename BST <T, A, B, C, S> :: BNode * BST <T, A, B, C, S> :: upperBoundNode(const K & k) const
+{
+   BNode * currentNode = root;
+   BNode * pGreater = nullptr;
+   while (currentNode != nullptr)
+   {
+      if (less(comp, k, currentNode->data))
+      {
+         pGreater = currentNode;
+         currentNode = currentNode->pLeft;
+      }
+      else
+         currentNode = currentNode->pRight;
+   }
+   return pGreater;
+}
+
+/****************************************************
+ * BST :: FOR EACH IN RANGE
+ * Call fn on every element in [lo, hi), in order. The
+ * first is found in O(log n) and the rest are walked to,
+ * so a window of k elements costs O(log n + k) and one
+ * comparison per element.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <class K, class Fn>
+void BST <T, A, B, C, S> :: forEachIn(const K & lo, const K & hi, Fn & fn) const
+{
+   for (iterator it(lowerBoundNode(lo), this); it != end() && less(comp, *it, hi); ++it)
+      fn(*it);
+}
+
+/****************************************************
+ * BST :: SELECT
+ * The k-th smallest element, counting from 0, or end()
+ * if there are not that many. Skip whole left subtrees
+ * by their sizes on the way down.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: iterator BST <T, A, B, C, S> :: select(size_t k) const
+{
+   static_assert(S, "select() needs a BST that keeps subtree sizes");
+   BNode * currentNode = root;
+   while (currentNode != nullptr)
+   {
+      size_t numLeft = sizeOf(currentNode->pLeft);
+      if (k == numLeft)
+         return iterator(currentNode, this);
+      if (k < numLeft)
+         currentNode = currentNode->pLeft;
+      else
+      {
+         k -= numLeft + 1;
+         currentNode = currentNode->pRight;
+      }
+   }
+   return end();
+}
+
+/****************************************************
+ * BST :: RANK
+ * How many elements are less than k: the walk to the
+ * lower bound, adding up everything it passes on the
+ * left. One comparison a level.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <class K>
+size_t BST <T, A, B, C, S> :: rankOf(const K & k) const
+{
+   static_assert(S, "rank() needs a BST that keeps subtree sizes");
+   size_t numLess = 0;
+   BNode * currentNode = root;
+   while (currentNode != nullptr)
+   {
+      if (less(comp, currentNode->data, k))
+      {
+         numLess += sizeOf(currentNode->pLeft) + 1;
+         currentNode = currentNode->pRight;
+      }
+      else
+         currentNode = currentNode->pLeft;
+   }
+   return numLess;
+}
+
+/****************************************************
+ * BST :: COUNT RANGE
+ * How many elements are in [lo, hi), without visiting
+ * them
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+size_t BST <T, A, B, C, S> :: count_range(const T & lo, const T & hi) const
+{
+   if (!less(comp, lo, hi))
+      return 0;
+   return rankOf(hi) - rankOf(lo);
+}
+
+/****************************************************
+ * BST :: DISTANCE
+ * How many increments it takes to get from first to
+ * last, as std::distance would say, in O(log n)
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+std::ptrdiff_t BST <T, A, B, C, S> :: distance(iterator first, iterator last) const
+{
+   static_assert(S, "distance() needs a BST that keeps subtree sizes");
+   size_t posFirst = first.pNode ? position(first.pNode) : numElements;
+   size_t posLast  = last.pNode  ? position(last.pNode)  : numElements;
+   return (std::ptrdiff_t)posLast - (std::ptrdiff_t)posFirst;
+}
+
+/****************************************************
+ * BST :: POSITION
+ * Where a node is in order, counting from 0: its left
+ * subtree, and every left subtree and parent passed
+ * on the way up from a right child
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+size_t BST <T, A, B, C, S> :: position(const BNode * pNode)
+{
+   size_t pos = sizeOf(pNode->pLeft);
+   for (const BNode * pUp = pNode->pParent; pUp; pNode = pUp, pUp = pUp->pParent)
+      if (pUp->pRight == pNode)
+         pos += sizeOf(pUp->pLeft) + 1;
+   return pos;
+}
+
+/****************************************************
+ * BST :: COUNT
+ * How many elements are equal to a given value: find
+ * the first, then walk while they stay equal
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+size_t BST <T, A, B, C, S> :: count(const T & t) const
+{
+   return countFrom(lowerBoundNode(t), t);
+}
+
+template <typename T, typename A, typename B, typename C, bool S>
+template <class K, class CC, class>
+size_t BST <T, A, B, C, S> :: count(const K & k) const
+{
+   return countFrom(lowerBoundNode(k), k);
+}
+
+template <typename T, typename A, typename B, typename C, bool S>
+template <class K>
+size_t BST <T, A, B, C, S> :: countFrom(BNode * pNode, const K & k) const
+{
+   size_t num = 0;
+   for (iterator it(pNode, this); it != end() && !less(comp, k, *it); ++it)
+      num++;
+   return num;
+}
+
+/****************************************************
+ * BST :: FIND BATCH
+ * Look up num keys at once, putting where each one is
+ * (or end()) in out. The walks down the tree take turns
+ * a group at a time: each takes one step, asks for the
+ * next node to be fetched, and lets the others step
+ * while it arrives, so the cache misses overlap rather
+ * than following one another. Each walk makes the same
+ * comparisons find() would.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: find_batch(const T * keys, size_t num, iterator * out)
+{
+   const size_t groupSize = 16;
+   BNode * nodes[groupSize];    // where each walk is; nullptr once it is done
+   BNode * notLess[groupSize];  // the last node each walk went left of
+
+   for (size_t first = 0; first < num; first += groupSize)
+   {
+      size_t numGroup = std::min(groupSize, num - first);
+      size_t numWalking = 0;
+      for (size_t i = 0; i < numGroup; i++)
+      {
+         nodes[i] = root;
+         notLess[i] = nullptr;
+         out[first + i] = end();
+         if (root)
+            numWalking++;
+      }
+
+      while (numWalking)
+      {
+         for (size_t i = 0; i < numGroup; i++)
          {
-            if (currentNode->pLeft != nullptr)
+            BNode * pNode = nodes[i];
+            if (pNode == nullptr)
+               continue;
+
+            const T & t = keys[first + i];
+            if constexpr (isThreeWay)
             {
-               currentNode = currentNode->pLeft;
+               auto order = comp(t, pNode->data);
+               if (order == 0)
+               {
+                  out[first + i] = iterator(pNode, this);
+                  pNode = nullptr;
+               }
+               else
+                  pNode = order < 0 ? pNode->pLeft : pNode->pRight;
             }
-         }
-         else
-         {
-            if (currentNode->pRight != nullptr)
+            else if (comp(pNode->data, t))
+               pNode = pNode->pRight;
+            else
+            {
+               notLess[i] = pNode;
+               pNode = pNode->pLeft;
+            }
+
+            if (pNode)
+               prefetch(pNode);
+            else
             {
-               currentNode = currentNode->pRight;
+               numWalking--;
+               if (notLess[i] && !less(comp, t, notLess[i]->data))
+                  out[first + i] = iterator(notLess[i], this);
             }
+            nodes[i] = pNode;
          }
       }
+   }
+}
+
+/****************************************************
+ * BST :: FREEZE
+ * A read-only copy of the elements in one array, for a
+ * tree that is done changing. See frozen_set.
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+frozen_set<T, A> BST <T, A, B, C, S> :: freeze() const
+{
+   static_assert(std::is_same_v<C, std::less<T> >, "a frozen_set is ordered by operator <");
+   return frozen_set<T, A>(begin(), end(), alloc);
+}
+
+/****************************************************
+ * BST :: PREFETCH
+ * Start bringing a node into the cache without waiting
+ * for it
+ ****************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: prefetch(const void * p)
+{
+#if defined(__GNUC__)
+   __builtin_prefetch(p);
+#elif defined(_MSC_VER)
+   _mm_prefetch(static_cast<const char *>(p), _MM_HINT_T0);
+#endif
+}
+
+/******************************************************
+ ******************************************************
+ ******************************************************
+ *********************** B NODE ***********************
+ ******************************************************
+ ******************************************************
+ ******************************************************/
+
+ 
+/******************************************************
+ * BINARY NODE :: ADD LEFT
+ * Add a node to the left of the current node
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: BNode :: addLeft (BNode * pNode)
+{
+   pLeft= pNode;
+}
+
+/******************************************************
+ * BINARY NODE :: ADD RIGHT
+ * Add a node to the right of the current node
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: BNode :: addRight (BNode * pNode)
+{
+   pRight = pNode;
+}
+
+/******************************************************
+ * BINARY NODE :: ADD LEFT
+ * Add a node to the left of the current node
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: BNode :: addLeft (const T & t)
+{
+   pLeft = new (Pool::owner(this)) BNode(t);
+   pLeft->pParent = this;
+}
+
+/******************************************************
+ * BINARY NODE :: ADD LEFT
+ * Add a node to the left of the current node
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> ::BNode::addLeft(T && t)
+{
+   pLeft = new (Pool::owner(this)) BNode(std::move(t));
+   pLeft->pParent = this;
+}
+
+/******************************************************
+ * BINARY NODE :: ADD RIGHT
+ * Add a node to the right of the current node
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: BNode :: addRight (const T & t)
+{
+   pRight = new (Pool::owner(this)) BNode(t);
+   pRight->pParent = this;
+}
+
+/******************************************************
+ * BINARY NODE :: ADD RIGHT
+ * Add a node to the right of the current node
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> ::BNode::addRight(T && t)
+{
+   pRight = new (Pool::owner(this)) BNode(std::move(t));
+   pRight->pParent = this;
+}
+
+/******************************************************
+ * BINARY NODE :: CLEAR
+ * Delete every node of the subtree. Nodes from pLocal,
+ * the pool of the tree doing the clearing, go straight
+ * back to it; the rest are remote frees.
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S>:: BNode :: clear(BNode *&pThis, Pool * pLocal)
+{
+   teardown(pThis, [pLocal](BNode * pNode) { dispose(pNode, pLocal); });
+   pThis = nullptr;
+}
+
+/******************************************************
+ * BINARY NODE :: DISPOSE
+ * Destroy a node and free it: directly if it came from
+ * pLocal, else through its owner's remote list
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S>:: BNode :: dispose(BNode * pNode, Pool * pLocal)
+{
+   pNode->~BNode();
+   Pool * pOwner = Pool::owner(pNode);
+   if (pOwner == pLocal)
+      pOwner->release(pNode);
+   else
+      pOwner->releaseRemote(pNode);
+}
+
+/******************************************************
+ * BINARY NODE :: TEARDOWN
+ * Visit every node of the subtree exactly once, after
+ * which it is never touched again. A node with a left
+ * child is rotated right until it has none, so the
+ * walk needs no stack and no parent links. Stops after
+ * limit visits and returns the root of what is left.
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+template <class Visit>
+typename BST <T, A, B, C, S> :: BNode * BST <T, A, B, C, S>:: BNode :: teardown(BNode * pNode, Visit visit, size_t limit)
+{
+   while (pNode && limit > 0)
+   {
+      if (pNode->pLeft)
+      {
+         BNode * pLeft = pNode->pLeft;
+         pNode->pLeft = pLeft->pRight;
+         pLeft->pRight = pNode;
+         pNode = pLeft;
+      }
+      else
+      {
+         BNode * pRight = pNode->pRight;
+         visit(pNode);
+         pNode = pRight;
+         limit--;
+      }
+   }
+   return pNode;
+}
+
+/******************************************************
+ * BINARY NODE :: ASSIGN
+ * Copy the subtree at pSrc onto the one at pDest, reusing
+ * its nodes and taking any more from pPool
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S>:: BNode:: assign(BNode * &pDest, const BNode *pSrc, Pool * pPool)
+{
+   if(pSrc == nullptr)
+   {
+      clear(pDest, pPool);
+      return;
+   }
+   
+   if(pDest== nullptr)
+      pDest = new (pPool) BNode(pSrc->data);
+   else
+      pDest->data = pSrc->data;
+   pDest->setMeta(pSrc->meta());
+   
+   assign(pDest->pLeft, pSrc->pLeft, pPool); // L
+   if(pSrc->pLeft)
+      pDest->pLeft->pParent = pDest;
+   
+   assign(pDest->pRight, pSrc->pRight, pPool); // R
+   if(pSrc->pRight)
+      pDest->pRight->pParent = pDest;
+}
+
+
+
+/******************************************************
+ * BINARY NODE :: ROTATE LEFT
+ * Our right child takes our place and we become its
+ * left child. Colors are left alone; subtree sizes
+ * follow the nodes.
+ *           (P)                 (R)
+ *          /   \               /   \
+ *        (a)   (R)    ==>    (P)   (c)
+ *             /   \         /   \
+ *           (b)   (c)     (a)   (b)
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: BNode :: rotateLeft()
+{
+   BNode * pPivot = pRight;
+   assert(pPivot != nullptr);
+
+   pRight = pPivot->pLeft;
+   if (pRight)
+      pRight->pParent = this;
+
+   BNode * pUp = pParent;
+   pPivot->pParent = pUp;
+   if (pUp && pUp->pLeft == this)
+      pUp->pLeft = pPivot;
+   else if (pUp)
+      pUp->pRight = pPivot;
+
+   pPivot->pLeft = this;
+   pParent = pPivot;
+
+   if constexpr (S)
+   {
+      pPivot->numNodes = this->numNodes;
+      this->numNodes = 1 + sizeOf(pLeft) + sizeOf(pRight);
+   }
+}
+
+/******************************************************
+ * BINARY NODE :: ROTATE RIGHT
+ * Our left child takes our place and we become its
+ * right child. Colors are left alone; subtree sizes
+ * follow the nodes.
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: BNode :: rotateRight()
+{
+   BNode * pPivot = pLeft;
+   assert(pPivot != nullptr);
+
+   pLeft = pPivot->pRight;
+   if (pLeft)
+      pLeft->pParent = this;
 
+   BNode * pUp = pParent;
+   pPivot->pParent = pUp;
+   if (pUp && pUp->pLeft == this)
+      pUp->pLeft = pPivot;
+   else if (pUp)
+      pUp->pRight = pPivot;
 
+   pPivot->pRight = this;
+   pParent = pPivot;
+
+   if constexpr (S)
+   {
+      pPivot->numNodes = this->numNodes;
+      this->numNodes = 1 + sizeOf(pLeft) + sizeOf(pRight);
    }
-   
-   std::pair<iterator, bool> pairReturn(end(), false);
-   return pairReturn;
 }
 
-/*************************************************
- * BST :: ERASE
- * Remove a given node as specified by the iterator
- ************************************************/
-template <typename T>
-typename BST <T> ::iterator BST <T> :: erase(iterator & it)
+/******************************************************
+ * BINARY NODE :: BALANCE
+ * Balance the tree from a given location. We are a red
+ * node that may have a red parent.
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: BNode :: balance(BalanceStats & stats)
 {
-   
-   if(it.pNode == nullptr)
-      return end();
-   // Case No Child
-   if(it.pNode->pRight == NULL && it.pNode->pLeft == NULL)
-      {
-         BNode * temp = nullptr;
-         if(it.pNode->pParent != NULL && it.pNode->pParent->pRight == it.pNode)
-         {
-            it.pNode->pParent->pRight = NULL;
-         }
-         if(it.pNode->pParent != NULL && it.pNode->pParent->pLeft == it.pNode)
-         {
-            ++it;
-            temp = it.pNode->pLeft;
-            it.pNode->pLeft = NULL;
-         }
-         numElements--;
-         delete temp;
-         return it;
-   }
-   // Case One Child
-   if(it.pNode->pRight == NULL && it.pNode->pLeft != NULL)
+   BNode * pNode = this;
+   while (true)
    {
-      BNode * temp = nullptr;
-      it.pNode->pLeft->pParent = it.pNode->pParent;
-      
-      if(it.pNode->pParent != NULL && it.pNode->pParent->pRight == it.pNode)
+      BNode * pMom = pNode->pParent;
+
+      // Case 1: if we are the root, then color ourselves black and call it a day.
+      if (pMom == nullptr)
       {
-         temp = it.pNode;
-         it.pNode->pParent->pRight = it.pNode->pLeft;
+         pNode->setRed(false);
+         return;
       }
-      
-      if(it.pNode->pParent != NULL && it.pNode->pParent->pLeft == it.pNode)
+
+      // Case 2: if the parent is black, then there is nothing left to do
+      if (!pMom->isRed())
+         return;
+
+      // a red root is only possible in a tree that was never balanced
+      BNode * pGranny = pMom->pParent;
+      if (pGranny == nullptr)
       {
-         temp = it.pNode;
-         it.pNode->pParent->pLeft = it.pNode->pLeft;
+         pMom->setRed(false);
+         return;
       }
-      
-      ++it;
-      numElements--;
-      delete temp;
-      return it;
-   }
-   // has Right Child
-   if(it.pNode->pLeft == NULL && it.pNode->pRight != NULL)
-   {
-      BNode * temp = nullptr;
-      it.pNode->pRight->pParent = it.pNode->pParent;
-      
-      if(it.pNode->pParent != NULL && it.pNode->pParent->pRight == it.pNode)
+      bool isMomLeft = pGranny->pLeft == pMom;
+      BNode * pAunt = isMomLeft ? pGranny->pRight : pGranny->pLeft;
+
+      // Case 3: if the aunt is red, then just recolor
+      if (isRed(pAunt))
       {
-         temp = it.pNode;
-         it.pNode->pParent->pRight = it.pNode->pRight;
+         pMom->setRed(false);
+         pAunt->setRed(false);
+         pGranny->setRed(true);
+         stats.recolors++;
+         pNode = pGranny;
+         continue;
       }
-      
-      if(it.pNode->pParent != NULL && it.pNode->pParent->pLeft == it.pNode)
+
+      // Case 4: if the aunt is black or non-existant, then we need to rotate
+      bool isLeft = pMom->pLeft == pNode;
+      BNode * pTop;
+      if (isMomLeft && isLeft)
       {
-         temp = it.pNode;
-         it.pNode->pParent->pLeft = it.pNode->pRight;
+         // Case 4a: We are mom's left and mom is granny's left
+         pGranny->rotateRight();
+         pTop = pMom;
+         stats.singleRotations++;
       }
-      
-      ++it;
-      numElements--;
-      delete temp;
-      return it;
-   }
-
-   
-   // Case TWO CHILD
-   
-   if(it.pNode->pLeft != NULL && it.pNode->pRight != NULL)
-   {
-      BNode * tempNode = it.pNode->pRight;
-      while(tempNode->pLeft != NULL)
+      else if (!isMomLeft && !isLeft)
       {
-         tempNode = tempNode->pLeft;
+         // case 4b: We are mom's right and mom is granny's right
+         pGranny->rotateLeft();
+         pTop = pMom;
+         stats.singleRotations++;
       }
-
-      BNode * deleteNode = it.pNode;
-
-      if(tempNode->pRight!= NULL)
+      else if (isMomLeft)
       {
-         tempNode->pRight->pParent = tempNode->pParent;
-         tempNode->pParent->pLeft = tempNode->pRight;
+         // Case 4c: We are mom's right and mom is granny's left
+         pMom->rotateLeft();
+         pGranny->rotateRight();
+         pTop = pNode;
+         stats.doubleRotations++;
       }
-      
-      it.pNode->pParent->pLeft = tempNode;
-      it.pNode->pParent->pLeft->pParent = deleteNode->pParent;
-      
-      // LEFT CHILD
-      it.pNode->pParent->pLeft->pLeft = deleteNode->pLeft;
-      it.pNode->pParent->pLeft->pLeft->pParent = it.pNode->pParent->pLeft;
-      
-      // RIGHT CHILD
-      
-      it.pNode->pParent->pLeft->pRight = deleteNode->pRight;
-      it.pNode->pParent->pLeft->pRight->pParent = it.pNode->pParent->pLeft;
-      
-   
-
-      numElements--;
-      ++it;
-      delete deleteNode;
-      if(it.pNode>= tempNode)
-        it.pNode = tempNode;
-      
-      return it;
+      else
+      {
+         // case 4d: we are mom's left and mom is granny's right
+         pMom->rotateRight();
+         pGranny->rotateLeft();
+         pTop = pNode;
+         stats.doubleRotations++;
+      }
+      pTop->setRed(false);
+      pGranny->setRed(true);
+      return;
    }
- 
-   
-   
-   
-   
-   
-   return nullptr;
 }
 
-/*****************************************************
- * BST :: CLEAR
- * Removes all the BNodes from a tree
+#ifdef DEBUG
+/****************************************************
+ * BINARY NODE :: FIND DEPTH
+ * Find the depth of the black nodes. This is useful for
+ * verifying that a given red-black tree is valid
  ****************************************************/
-template <typename T>
-void BST <T> ::clear() noexcept
+template <typename T, typename A, typename B, typename C, bool S>
+int BST <T, A, B, C, S> :: BNode :: findDepth() const
 {
-   root->clear(root);
-   numElements = 0;
-   root= nullptr;
+   // if there are no children, the depth is ourselves
+   if (pRight == nullptr && pLeft == nullptr)
+      return (isRed() ? 0 : 1);
+
+   // if there is a right child, go that way
+   if (pRight != nullptr)
+      return (isRed() ? 0 : 1) + pRight->findDepth();
+   else
+      return (isRed() ? 0 : 1) + pLeft->findDepth();
 }
 
-/*****************************************************
- * BST :: BEGIN
- * Return the first node (left-most) in a binary search tree
- ****************************************************/
-template <typename T>
-typename BST <T> :: iterator custom :: BST <T> :: begin() const noexcept
+/****************************************************
+ * BINARY NODE :: VERIFY RED BLACK
+ * Do all four red-black rules work here?
+ ***************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+bool BST <T, A, B, C, S> :: BNode :: verifyRedBlack(int depth) const
 {
-   if(empty())
-      return end();
-   BNode * currentNode = root;
-   
-   while(currentNode->pLeft)
+   bool fReturn = true;
+   depth -= (isRed() == false) ? 1 : 0;
+
+   // Rule a) Every node is either red or black: one bit, so always
+
+   // Rule b) The root is black
+   if (pParent == nullptr)
+      if (isRed() == true)
+         fReturn = false;
+
+   // Rule c) Red nodes have black children
+   if (isRed() == true)
    {
-      currentNode = currentNode->pLeft;
+      if (pLeft != nullptr)
+         if (pLeft->isRed() == true)
+            fReturn = false;
+
+      if (pRight != nullptr)
+         if (pRight->isRed() == true)
+            fReturn = false;
    }
-   return iterator(currentNode);
+
+   // Rule d) Every path from a leaf to the root has the same # of black nodes
+   if (pLeft == nullptr || pRight == nullptr)
+      if (depth != 0)
+         fReturn = false;
+   if (pLeft != nullptr)
+      if (!pLeft->verifyRedBlack(depth))
+         fReturn = false;
+   if (pRight != nullptr)
+      if (!pRight->verifyRedBlack(depth))
+         fReturn = false;
+
+   return fReturn;
 }
 
+/******************************************************
+ * VERIFY B TREE
+ * Verify that the tree is correctly formed
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+std::pair <T, T> BST <T, A, B, C, S> :: BNode :: verifyBTree() const
+{
+   // largest and smallest values
+   std::pair <T, T> extremes;
+   extremes.first = data;
+   extremes.second = data;
 
-/****************************************************
- * BST :: FIND
- * Return the node corresponding to a given value
- ****************************************************/
-template <typename T>
-typename BST <T> :: iterator BST<T> :: find(const T & t)
+   // check parent
+   if (pParent)
+      assert(pParent->pLeft == this || pParent->pRight == this);
+
+   // check left, the smaller sub-tree
+   if (pLeft)
+   {
+      assert(!less(C(), data, pLeft->data));
+      assert(pLeft->pParent == this);
+      std::pair <T, T> p = pLeft->verifyBTree();
+      assert(!less(C(), data, p.second));
+      extremes.first = p.first;
+   }
+
+   // check right
+   if (pRight)
+   {
+      assert(!less(C(), pRight->data, data));
+      assert(pRight->pParent == this);
+      std::pair <T, T> p = pRight->verifyBTree();
+      assert(!less(C(), p.first, data));
+      extremes.second = p.second;
+   }
+
+   // return answer
+   return extremes;
+}
+
+/*********************************************
+ * COMPUTE SIZE
+ * Verify that the BST is as large as we think it is.
+ * A node that keeps its subtree size only has to agree
+ * with its children.
+ ********************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+int BST <T, A, B, C, S> :: BNode :: computeSize() const
 {
-   BNode * currentNode = root;
-   
-   while(currentNode != NULL)
+   if constexpr (S)
    {
-      if(currentNode->data == t)
-         return iterator(currentNode);
-      
-      else if( t < currentNode->data)
-         currentNode = currentNode->pLeft;
-      else
-         currentNode = currentNode->pRight;
+      assert(this->numNodes == 1 + sizeOf(pLeft) + sizeOf(pRight));
+      return (int)this->numNodes;
    }
-   return end();
+   return 1 +
+      (pLeft  == nullptr ? 0 : pLeft->computeSize()) +
+      (pRight == nullptr ? 0 : pRight->computeSize());
+}
+#endif // DEBUG
+
+/******************************************************
+ * BINARY NODE :: NEW
+ * A node made outside of any tree comes from the fallback
+ * pool. No one tree owns it, so any thread may be here.
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void * BST <T, A, B, C, S> :: BNode :: operator new (size_t size)
+{
+   assert(size == sizeof(BNode));
+   static std::mutex fallbackLock;
+   std::lock_guard<std::mutex> guard(fallbackLock);
+   return Pool::fallback().allocate();
+}
+
+/******************************************************
+ * BINARY NODE :: NEW from a POOL
+ * Carve the node out of a given tree's slabs
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void * BST <T, A, B, C, S> :: BNode :: operator new (size_t size, Pool * pPool)
+{
+   assert(size == sizeof(BNode));
+   assert(pPool != nullptr);
+   return pPool->allocate();
+}
+
+/******************************************************
+ * BINARY NODE :: DELETE
+ * Hand the node back to whichever pool it came from.
+ * Nothing says which tree is deleting it, so it is a
+ * remote free.
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: BNode :: operator delete (void * p)
+{
+   if (p)
+      Pool::owner(p)->releaseRemote(p);
+}
+
+/******************************************************
+ * BINARY NODE :: DELETE from a POOL
+ * Only called when a constructor throws
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: BNode :: operator delete (void * p, Pool * pPool)
+{
+   pPool->release(p);
 }
 
 /******************************************************
  ******************************************************
  ******************************************************
- *********************** B NODE ***********************
+ ********************* NODE POOL **********************
  ******************************************************
  ******************************************************
  ******************************************************/
 
- 
 /******************************************************
- * BINARY NODE :: ADD LEFT
- * Add a node to the left of the current node
+ * NODE POOL :: CREATE
+ * The pool itself lives in memory from the tree's allocator
  ******************************************************/
-template <typename T>
-void BST <T> :: BNode :: addLeft (BNode * pNode)
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: Pool * BST <T, A, B, C, S> :: Pool :: create(const A & alloc)
 {
-   pLeft= pNode;
+   PoolAlloc poolAlloc(alloc);
+   Pool * pPool = std::allocator_traits<PoolAlloc>::allocate(poolAlloc, 1);
+   return ::new (static_cast<void *>(pPool)) Pool(alloc);
 }
 
 /******************************************************
- * BINARY NODE :: ADD RIGHT
- * Add a node to the right of the current node
+ * NODE POOL :: DESTROY
+ * Free the slabs, then the pool, with the allocator they came from
  ******************************************************/
-template <typename T>
-void BST <T> :: BNode :: addRight (BNode * pNode)
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: destroy(Pool * pPool)
 {
-   pRight = pNode;
+   PoolAlloc poolAlloc(pPool->slabAlloc);
+   pPool->~Pool();
+   std::allocator_traits<PoolAlloc>::deallocate(poolAlloc, pPool, 1);
 }
 
 /******************************************************
- * BINARY NODE :: ADD LEFT
- * Add a node to the left of the current node
+ * NODE POOL :: ALLOCATE
+ * Room for one node: recycled first, taking back remote
+ * frees if there is nothing else, then the newest slab.
+ * A run that gives up its last free node goes to the back.
  ******************************************************/
-template <typename T>
-void BST<T> :: BNode :: addLeft (const T & t)
+template <typename T, typename A, typename B, typename C, bool S>
+void * BST <T, A, B, C, S> :: Pool :: allocate()
 {
-   pLeft = new BNode(t);
+   Slab * pRun = pSlabs;
+   if ((pRun == nullptr || pRun->pFree == nullptr) && hasRemote.load(std::memory_order_relaxed))
+   {
+      drain();
+      pRun = pSlabs;
+   }
+   if (pRun && pRun->pFree)
+   {
+      Free * p = pRun->pFree;
+      pRun->pFree = p->pNext;
+      pRun->numFree--;
+      pRun->numLive++;
+      numFree--;
+      numRecycled++;
+      numLive++;
+      if (pRun->pFree == nullptr && pRun != pLastRun)
+      {
+         unlinkRun(pRun);
+         pushBack(pRun);
+      }
+      return p;
+   }
+
+   if (pBump == pBumpEnd)
+   {
+      if (pBumpSlab != pBumpLast)
+         carve(pBumpSlab + 1);
+      else
+         grow(1);
+   }
+   void * p = pBump;
+   pBump += sizeof(BNode);
+   numLive++;
+   Slab::of(p)->pRun->numLive++;
+   return p;
 }
 
 /******************************************************
- * BINARY NODE :: ADD LEFT
- * Add a node to the left of the current node
+ * NODE POOL :: RESERVE
+ * Make sure the next n allocations are served without a
+ * trip to the allocator. Whatever is missing comes in a
+ * single run of slabs.
  ******************************************************/
-template <typename T>
-void BST<T> ::BNode::addLeft(T && t)
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: reserve(size_t n)
 {
-   pLeft = new BNode(std::move(t));
+   size_t available = numFree + (pBumpEnd - pBump) / sizeof(BNode);
+   if (pBumpSlab)
+      available += (pBumpLast - pBumpSlab) * nodesPerSlab();
+   if (n <= available)
+      return;
+
+   // the rest of the current run is skipped, not lost: it goes
+   // back to the allocator with the run
+   size_t needed = n - numFree;
+   grow((needed + nodesPerSlab() - 1) / nodesPerSlab());
 }
 
 /******************************************************
- * BINARY NODE :: ADD RIGHT
- * Add a node to the right of the current node
+ * NODE POOL :: CLAIM
+ * Hand out n nodes at once, in order, from a fresh run of
+ * slabs. The nodes are found with slot() and can be
+ * constructed concurrently since nothing else in the
+ * pool changes while they are.
  ******************************************************/
-template <typename T>
-void BST <T> :: BNode :: addRight (const T & t)
+template <typename T, typename A, typename B, typename C, bool S>
+void * BST <T, A, B, C, S> :: Pool :: claim(size_t n)
 {
-   pRight = new BNode(t);
+   assert(n > 0);
+   size_t numSlabs = (n + nodesPerSlab() - 1) / nodesPerSlab();
+   grow(numSlabs);
+   Slab * pRun = pLastRun;
+   pRun->numLive = n;
+   numLive += n;
+
+   // the rest of the last slab is still there for insert()
+   carve(pBumpLast);
+   pBump = static_cast<unsigned char *>(slot(pRun, n - 1)) + sizeof(BNode);
+   return pRun;
 }
 
 /******************************************************
- * BINARY NODE :: ADD RIGHT
- * Add a node to the right of the current node
+ * NODE POOL :: RELEASE
+ * Put a node's memory on its run's free list. The
+ * destructor has already been called. A run that now has
+ * a free node moves to the front; one with nothing left in
+ * use goes back to the allocator if the pool has more free
+ * nodes than it may keep.
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: release(void * p)
+{
+   assert(owner(p) == this);
+   assert(numLive > 0);
+   Slab * pRun = Slab::of(p)->pRun;
+   Free * pNode = static_cast<Free *>(p);
+   pNode->pNext = pRun->pFree;
+   pRun->pFree = pNode;
+   pRun->numFree++;
+   numFree++;
+   if (pRun->numFree == 1 && pRun != pSlabs)
+   {
+      unlinkRun(pRun);
+      pushFront(pRun);
+   }
+
+   numLive--;
+   if (--pRun->numLive == 0 && numFree > freeLimit)
+      dropRun(pRun);
+}
+
+/******************************************************
+ * NODE POOL :: RELEASE REMOTE
+ * Free a node from a tree other than the owner, maybe on
+ * another thread. While the owner is around the node just
+ * waits on pRemote. After, the lock keeps remote frees
+ * apart, and the last one out destroys the pool.
  ******************************************************/
-template <typename T>
-void BST <T> ::BNode::addRight(T && t)
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: releaseRemote(void * p)
 {
-   pRight = new BNode(std::move(t));
+   assert(owner(p) == this);
+   bool isLast = false;
+   {
+      std::lock_guard<std::mutex> guard(remoteLock);
+      if (isDetached)
+      {
+         release(p);
+         isLast = numLive == 0;
+      }
+      else
+      {
+         Free * pNode = static_cast<Free *>(p);
+         pNode->pNext = pRemote;
+         pRemote = pNode;
+         hasRemote.store(true, std::memory_order_relaxed);
+      }
+   }
+   if (isLast)
+      destroy(this);
 }
 
-template <typename T>
-void BST<T>:: BNode :: clear(BNode *&pThis)
+/******************************************************
+ * NODE POOL :: DRAIN
+ * The owner takes back the nodes other trees freed
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: drain()
 {
-   if(pThis== nullptr)
+   if (!hasRemote.load(std::memory_order_relaxed))
       return;
-   
-   clear(pThis->pLeft);
-   clear(pThis->pRight);
-   delete pThis;
-   pThis = nullptr;
+   Free * p;
+   {
+      std::lock_guard<std::mutex> guard(remoteLock);
+      p = pRemote;
+      pRemote = nullptr;
+      hasRemote.store(false, std::memory_order_relaxed);
+   }
+   while (p)
+   {
+      Free * pNext = p->pNext;
+      release(p);
+      p = pNext;
+   }
+}
 
+/******************************************************
+ * NODE POOL :: RELEASE ALL
+ * Give every slab back at once without visiting the nodes
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: releaseAll()
+{
+   while (pSlabs)
+   {
+      Slab * pNext = pSlabs->pNext;
+      std::allocator_traits<SlabAlloc>::deallocate(slabAlloc, pSlabs, pSlabs->numSlabs);
+      pSlabs = pNext;
+   }
+   pLastRun = nullptr;
+   pBump = pBumpEnd = nullptr;
+   pBumpSlab = pBumpLast = nullptr;
+   numLive = 0;
+   numFree = 0;
 }
 
+/******************************************************
+ * NODE POOL :: RELEASE EMPTY SLABS
+ * Hand back every run of slabs none of whose nodes are
+ * in use
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: releaseEmptySlabs()
+{
+   for (Slab * pRun = pSlabs; pRun; )
+   {
+      Slab * pNext = pRun->pNext;
+#ifdef DEBUG
+      numRunVisits++;
+#endif // DEBUG
+      if (pRun->numLive == 0)
+         dropRun(pRun);
+      pRun = pNext;
+   }
+}
 
-template <typename T>
-void BST <T>:: BNode:: assign(BNode * &pDest, const BNode *pSrc)
+/******************************************************
+ * NODE POOL :: DROP RUN
+ * Hand back one run of slabs with nothing in use. Its
+ * free nodes are all on its own list, so they go with it.
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: dropRun(Slab * pRun)
 {
-   if(pSrc == nullptr)
+   assert(pRun->numLive == 0);
+#ifdef DEBUG
+   numRunVisits++;
+#endif // DEBUG
+   if (pBumpSlab && pBumpSlab->pRun == pRun)
    {
-      clear(pDest);
-      return;
+      pBump = pBumpEnd = nullptr;
+      pBumpSlab = pBumpLast = nullptr;
    }
-   
-   if(pDest== nullptr)
-      pDest = new BNode(pSrc->data);
-   else
-      pDest->data = pSrc->data;
-   
-   assign(pDest->pLeft, pSrc->pLeft); // L
-   if(pSrc->pLeft)
-      pDest->pLeft->pParent = pDest;
-   
-   assign(pDest->pRight, pSrc->pRight); // R
-   if(pSrc->pRight)
-      pDest->pRight->pParent = pDest;
+   numFree -= pRun->numFree;
+   unlinkRun(pRun);
+   std::allocator_traits<SlabAlloc>::deallocate(slabAlloc, pRun, pRun->numSlabs);
+}
+
+/******************************************************
+ * NODE POOL :: UNLINK RUN, PUSH FRONT, and PUSH BACK
+ * Keep the list of runs in order: any with free nodes
+ * ahead of any without
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: unlinkRun(Slab * pRun)
+{
+   (pRun->pPrev ? pRun->pPrev->pNext : pSlabs)   = pRun->pNext;
+   (pRun->pNext ? pRun->pNext->pPrev : pLastRun) = pRun->pPrev;
+}
+
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: pushFront(Slab * pRun)
+{
+   pRun->pPrev = nullptr;
+   pRun->pNext = pSlabs;
+   (pSlabs ? pSlabs->pPrev : pLastRun) = pRun;
+   pSlabs = pRun;
+}
+
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: pushBack(Slab * pRun)
+{
+   pRun->pNext = nullptr;
+   pRun->pPrev = pLastRun;
+   (pLastRun ? pLastRun->pNext : pSlabs) = pRun;
+   pLastRun = pRun;
+}
+
+/******************************************************
+ * NODE POOL :: RELEASE RUN
+ * Give the first run of slabs back whether or not it is
+ * in use. Returns true while there are runs left.
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+bool BST <T, A, B, C, S> :: Pool :: releaseRun()
+{
+   if (pSlabs)
+   {
+      Slab * pRun = pSlabs;
+      unlinkRun(pRun);
+      std::allocator_traits<SlabAlloc>::deallocate(slabAlloc, pRun, pRun->numSlabs);
+   }
+   return pSlabs != nullptr;
+}
+
+/******************************************************
+ * NODE POOL :: DETACH
+ * The owning tree is going away. Nodes that have left the
+ * tree keep the pool alive until the last one is released.
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: detach()
+{
+   bool isLast;
+   {
+      std::lock_guard<std::mutex> guard(remoteLock);
+      for (Free * p = pRemote; p; )
+      {
+         Free * pNext = p->pNext;
+         release(p);
+         p = pNext;
+      }
+      pRemote = nullptr;
+      isDetached = true;
+      isLast = numLive == 0;
+   }
+   if (isLast)
+      destroy(this);
 }
 
+/******************************************************
+ * NODE POOL :: GROW
+ * Add a fresh run of slabs, all from one call to the
+ * allocator, at the back since nothing on it is free,
+ * and start carving nodes from the first.
+ * owner() finds a slab by masking a node's address, so
+ * a run that is not aligned to slabBytes() would be
+ * taken for someone else's memory: it goes straight
+ * back and the allocation fails.
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: grow(size_t numSlabs)
+{
+   assert(numSlabs > 0);
+   Slab * pRun = std::allocator_traits<SlabAlloc>::allocate(slabAlloc, numSlabs);
+   if (reinterpret_cast<std::uintptr_t>(pRun) % slabBytes() != 0)
+   {
+      std::allocator_traits<SlabAlloc>::deallocate(slabAlloc, pRun, numSlabs);
+      throw std::bad_alloc();
+   }
+   for (size_t i = 0; i < numSlabs; i++)
+   {
+      pRun[i].pPool = this;
+      pRun[i].pRun  = pRun;
+   }
+   pRun->numSlabs = numSlabs;
+   pRun->numLive  = 0;
+   pRun->pFree    = nullptr;
+   pRun->numFree  = 0;
+   pushBack(pRun);
+   numSlabAllocs++;
+
+   pBumpLast = pRun + (numSlabs - 1);
+   carve(pRun);
+}
 
+/******************************************************
+ * NODE POOL :: CARVE
+ * Hand out never-used nodes from this slab next
+ ******************************************************/
+template <typename T, typename A, typename B, typename C, bool S>
+void BST <T, A, B, C, S> :: Pool :: carve(Slab * pSlab)
+{
+   pBumpSlab = pSlab;
+   pBump     = pSlab->nodes;
+   pBumpEnd  = pSlab->nodes + sizeof(pSlab->nodes);
+}
 
 /*************************************************
  *************************************************
@@ -795,8 +3192,8 @@ void BST <T>:: BNode:: assign(BNode * &pDest, const BNode *pSrc)
  * BST ITERATOR :: INCREMENT PREFIX
  * advance by one
  *************************************************/
-template <typename T>
-typename BST <T> :: iterator & BST <T> :: iterator :: operator ++ ()
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: iterator & BST <T, A, B, C, S> :: iterator :: operator ++ ()
 {
 //   if(pNode->isRightChild(pNode))
 //   {
@@ -817,10 +3214,10 @@ typename BST <T> :: iterator & BST <T> :: iterator :: operator ++ ()
  
    }
    
-   else if(pNode->pRight == NULL && pNode->pParent->pLeft == pNode)
+   else if(pNode->pParent && pNode->pParent->pLeft == pNode)
       pNode = pNode->pParent;
    
-   else if(pNode->pRight == NULL && pNode->pParent->pRight == pNode)
+   else if(pNode->pParent && pNode->pParent->pRight == pNode)
    {
       while(pNode->pParent && pNode->pParent->pRight == pNode)
       {
@@ -838,13 +3235,34 @@ typename BST <T> :: iterator & BST <T> :: iterator :: operator ++ ()
 
 /**************************************************
  * BST ITERATOR :: DECREMENT PREFIX
- * advance by one
+ * back up by one: the right-most of the left subtree,
+ * or else up past every left child to the parent of a
+ * right child. Backing up from end() gives the largest,
+ * and from the first element gives end().
  *************************************************/
-template <typename T>
-typename BST <T> :: iterator & BST <T> :: iterator :: operator -- ()
+template <typename T, typename A, typename B, typename C, bool S>
+typename BST <T, A, B, C, S> :: iterator & BST <T, A, B, C, S> :: iterator :: operator -- ()
 {
-   return *this;
+   if (pNode == nullptr)
+   {
+      if (pTree)
+         pNode = pTree->pMax;
+      return *this;
+   }
 
+   if (pNode->pLeft)
+   {
+      pNode = pNode->pLeft;
+      while (pNode->pRight)
+         pNode = pNode->pRight;
+   }
+   else
+   {
+      while (pNode->pParent && pNode->pParent->pLeft == pNode)
+         pNode = pNode->pParent;
+      pNode = pNode->pParent;
+   }
+   return *this;
 }
 
 
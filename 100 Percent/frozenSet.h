@@ -0,0 +1,270 @@
+/***********************************************************************
+ * Header:
+ *    FROZEN SET
+ * Summary:
+ *    A read-only sorted set with no pointers at all. The elements sit in
+ *    one array in Eytzinger order: the root first, then its two children,
+ *    then their four, and so on, so the children of the element at k
+ *    (counting from 1) are at 2k and 2k + 1. A search is a loop with no
+ *    branch to mispredict, and the top of the tree, which every search
+ *    goes through, is packed into the first few cache lines. An int takes
+ *    4 bytes instead of the 32 of a BST node.
+ *
+ *    This will contain the class definition of:
+ *        frozen_set           : A read-only set in one array
+ *        frozen_set::iterator : An iterator through frozen_set, in order
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <algorithm>  // for std::min
+#include <memory>     // for std::allocator
+#include <vector>     // for std::vector
+#ifdef _MSC_VER
+#include <xmmintrin.h>// for _mm_prefetch
+#endif
+
+class TestFrozenSet; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************************************
+ * FROZEN SET
+ * Built once from elements in ascending order, then only searched
+ *****************************************************************/
+template <typename T, typename A = std::allocator<T> >
+class frozen_set
+{
+   friend class ::TestFrozenSet; // give unit tests access to the privates
+
+public:
+   //
+   // Construct
+   //
+
+   frozen_set() {}
+   template <class Iterator>
+   frozen_set(Iterator first, Iterator last, const A & alloc = A());
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() const noexcept;
+   iterator end()   const noexcept { return iterator(this, 0); }
+
+   //
+   // Access
+   //
+
+   iterator find(const T & t) const;
+   iterator lower_bound(const T & t) const { return iterator(this, lowerBound(t)); }
+
+   //
+   // Status
+   //
+
+   bool   empty() const noexcept { return elements.empty(); }
+   size_t size()  const noexcept { return elements.size();  }
+   A      get_allocator() const noexcept { return elements.get_allocator(); }
+
+private:
+   size_t lowerBound(const T & t) const;
+
+   // elements[k - 1] is the element at k: the children of k are 2k and 2k + 1
+   std::vector<T, A> elements;
+};
+
+/**********************************************************
+ * FROZEN SET ITERATOR
+ * Walk the implicit tree in order. Position 0 is the end.
+ *********************************************************/
+template <typename T, typename A>
+class frozen_set <T, A> :: iterator
+{
+   friend class ::TestFrozenSet; // give unit tests access to the privates
+   friend class frozen_set <T, A>;
+public:
+   // constructors and assignment
+   iterator() : pSet(nullptr), k(0) {}
+
+   // compare
+   bool operator == (const iterator & rhs) const { return k == rhs.k; }
+   bool operator != (const iterator & rhs) const { return k != rhs.k; }
+
+   // de-reference. Cannot change because the set is frozen
+   const T & operator * () const { return pSet->elements[k - 1]; }
+
+   // increment: the left-most of the right subtree, or else up
+   // past every right child to the parent of a left child
+   iterator & operator ++ ()
+   {
+      size_t n = pSet->size();
+      if (2 * k + 1 <= n)
+      {
+         k = 2 * k + 1;
+         while (2 * k <= n)
+            k = 2 * k;
+      }
+      else
+      {
+         while (k & 1)
+            k >>= 1;
+         k >>= 1;
+      }
+      return *this;
+   }
+   iterator operator ++ (int)
+   {
+      iterator old = *this;
+      ++*this;
+      return old;
+   }
+
+   // decrement: the mirror image. Backing up from the end lands
+   // on the largest element
+   iterator & operator -- ()
+   {
+      size_t n = pSet->size();
+      if (k == 0)
+      {
+         k = n ? 1 : 0;
+         while (k && 2 * k + 1 <= n)
+            k = 2 * k + 1;
+      }
+      else if (2 * k <= n)
+      {
+         k = 2 * k;
+         while (2 * k + 1 <= n)
+            k = 2 * k + 1;
+      }
+      else
+      {
+         while (k > 1 && !(k & 1))
+            k >>= 1;
+         k >>= 1;
+      }
+      return *this;
+   }
+   iterator operator -- (int)
+   {
+      iterator old = *this;
+      --*this;
+      return old;
+   }
+
+private:
+   iterator(const frozen_set * pSet, size_t k) : pSet(pSet), k(k) {}
+
+   const frozen_set * pSet;
+   size_t k;
+};
+
+/*********************************************
+ * FROZEN SET :: CONSTRUCT from a sorted range
+ * Note where each element is, then lay them out level
+ * by level. The in-order position of every slot comes
+ * from walking the implicit tree.
+ ********************************************/
+template <typename T, typename A>
+template <class Iterator>
+frozen_set <T, A> :: frozen_set(Iterator first, Iterator last, const A & alloc) :
+   elements(alloc)
+{
+   std::vector<const T *> sorted;
+   for (; first != last; ++first)
+      sorted.push_back(&*first);
+   size_t n = sorted.size();
+   if (n == 0)
+      return;
+
+   // slot[k - 1] gets the element of this in-order rank
+   std::vector<size_t> rankOf(n);
+   size_t rank = 0;
+   size_t k = 1;
+   while (2 * k <= n)
+      k = 2 * k;
+   for (; k; rank++)
+   {
+      rankOf[k - 1] = rank;
+      if (2 * k + 1 <= n)
+      {
+         k = 2 * k + 1;
+         while (2 * k <= n)
+            k = 2 * k;
+      }
+      else
+      {
+         while (k & 1)
+            k >>= 1;
+         k >>= 1;
+      }
+   }
+   assert(rank == n);
+
+   elements.reserve(n);
+   for (size_t i = 0; i < n; i++)
+      elements.push_back(*sorted[rankOf[i]]);
+}
+
+/*********************************************
+ * FROZEN SET :: BEGIN
+ * The left-most slot
+ ********************************************/
+template <typename T, typename A>
+typename frozen_set <T, A> :: iterator frozen_set <T, A> :: begin() const noexcept
+{
+   size_t k = empty() ? 0 : 1;
+   while (k && 2 * k <= size())
+      k = 2 * k;
+   return iterator(this, k);
+}
+
+/*********************************************
+ * FROZEN SET :: FIND
+ * The element equal to t, if there is one
+ ********************************************/
+template <typename T, typename A>
+typename frozen_set <T, A> :: iterator frozen_set <T, A> :: find(const T & t) const
+{
+   size_t k = lowerBound(t);
+   if (k && elements[k - 1] == t)
+      return iterator(this, k);
+   return end();
+}
+
+/*********************************************
+ * FROZEN SET :: LOWER BOUND
+ * Go left or right all the way to the bottom: the
+ * comparison picks the child by arithmetic, not by a
+ * branch. Four levels ahead are fetched meanwhile. The
+ * last time the walk went left was at the answer, so
+ * dropping the trailing right turns and one more from
+ * the path leaves the answer, or 0 if it never went left.
+ ********************************************/
+template <typename T, typename A>
+size_t frozen_set <T, A> :: lowerBound(const T & t) const
+{
+   const T * pElements = elements.data();
+   size_t n = elements.size();
+   size_t k = 1;
+   while (k <= n)
+   {
+#if defined(__GNUC__)
+      __builtin_prefetch(pElements + std::min(16 * k, n) - 1);
+#elif defined(_MSC_VER)
+      _mm_prefetch(reinterpret_cast<const char *>(pElements + std::min(16 * k, n) - 1), _MM_HINT_T0);
+#endif
+      k = 2 * k + (pElements[k - 1] < t);
+   }
+   while (k & 1)
+      k >>= 1;
+   return k >> 1;
+}
+
+} // namespace custom
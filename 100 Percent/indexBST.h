@@ -0,0 +1,581 @@
+/***********************************************************************
+ * Header:
+ *    INDEX BST
+ * Summary:
+ *    A binary search tree whose nodes sit side by side in one vector and
+ *    refer to each other with 32-bit indices rather than pointers. A node
+ *    holding an int is 16 bytes instead of 32, the links stay valid when
+ *    the vector moves, so the whole tree copies or relocates as one block,
+ *    and a walk down the tree touches fewer cache lines. It is kept
+ *    red-black, with the color in the top bit of the parent link.
+ *
+ *    This will contain the class definition of:
+ *        IndexBST            : A binary search tree with index links
+ *        IndexBST::iterator  : An iterator through IndexBST
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>    // for std::uint32_t
+#include <memory>     // for std::allocator
+#include <utility>    // for std::pair
+#include <vector>     // for std::vector
+#include "bst.h"
+
+class TestIndexBST; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************************************
+ * INDEX BINARY SEARCH TREE
+ * A red-black tree for up to two billion elements
+ *****************************************************************/
+template <typename T, typename A = std::allocator<T> >
+class IndexBST
+{
+   friend class ::TestIndexBST; // give unit tests access to the privates
+
+public:
+   //
+   // Construct
+   //
+
+   IndexBST() : root(NIL) {}
+   explicit IndexBST(const A & alloc) : nodes(NodeAlloc(alloc)), root(NIL) {}
+   template <typename B>
+   explicit IndexBST(const BST <T, A, B> & rhs);
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() const noexcept;
+   iterator end()   const noexcept { return iterator(this, NIL); }
+
+   //
+   // Access
+   //
+
+   iterator find(const T & t) const;
+
+   //
+   // Insert
+   //
+
+   std::pair<iterator, bool> insert(const T &  t, bool keepUnique = false);
+   std::pair<iterator, bool> insert(      T && t, bool keepUnique = false);
+   void reserve(size_t n) { nodes.reserve(n); }
+
+   //
+   // Remove
+   //
+
+   iterator erase(iterator & it);
+   void clear() noexcept { nodes.clear(); root = NIL; }
+
+   //
+   // Status
+   //
+
+   bool   empty() const noexcept { return nodes.empty(); }
+   size_t size()  const noexcept { return nodes.size();  }
+   A      get_allocator() const noexcept { return A(nodes.get_allocator()); }
+
+private:
+   typedef std::uint32_t Link;
+   static constexpr Link NIL = 0x7FFFFFFF;   // the index of no node at all
+   static constexpr Link RED = 0x80000000;   // the color bit of a parent link
+
+   // a parent index that carries the node's color in its top bit. It
+   // reads and assigns like a Link; assigning leaves the color alone.
+   class ParentLink
+   {
+   public:
+      ParentLink(Link i = NIL) : bits(i) {}
+      ParentLink(const ParentLink & rhs) = default;
+      ParentLink & operator = (Link i)  { bits = (bits & RED) | i; return *this; }
+      ParentLink & operator = (const ParentLink & rhs) { return *this = (Link)rhs; }
+      operator Link () const      { return bits & ~RED; }
+      bool isRed() const          { return (bits & RED) != 0; }
+      void setRed(bool red)       { bits = (bits & ~RED) | (red ? RED : 0); }
+   private:
+      Link bits;
+   };
+
+   struct Node
+   {
+      T data;
+      Link left;
+      Link right;
+      ParentLink parent;
+   };
+   typedef typename std::allocator_traits<A>::template rebind_alloc<Node> NodeAlloc;
+
+   template <typename U>
+   std::pair<iterator, bool> insertNode(U && t, bool keepUnique);
+   Link buildBalanced(Link first, Link last, Link parent, size_t depth, size_t redDepth);
+   void replaceChild(Link parent, Link from, Link to);
+   void rotateLeft(Link i);
+   void rotateRight(Link i);
+   void fixRedRed(Link i);
+   void fixDoubleBlack(Link i, Link parent);
+   bool isRed(Link i) const { return i != NIL && nodes[i].parent.isRed(); }
+   Link minimum(Link i) const;
+   Link maximum(Link i) const;
+   Link next(Link i) const;
+   Link prev(Link i) const;
+
+   std::vector<Node, NodeAlloc> nodes;   // every node in the tree, no gaps
+   Link root;                            // index of the root or NIL
+};
+
+/**********************************************************
+ * INDEX BST ITERATOR
+ * Forward and reverse iterator through an IndexBST
+ *********************************************************/
+template <typename T, typename A>
+class IndexBST <T, A> :: iterator
+{
+   friend class ::TestIndexBST; // give unit tests access to the privates
+   friend class IndexBST <T, A>;
+public:
+   // constructors and assignment
+   iterator() : pTree(nullptr), index(NIL) {}
+
+   // compare
+   bool operator == (const iterator & rhs) const { return index == rhs.index; }
+   bool operator != (const iterator & rhs) const { return index != rhs.index; }
+
+   // de-reference. Cannot change because it will invalidate the BST
+   const T & operator * () const { return pTree->nodes[index].data; }
+
+   // increment and decrement
+   iterator & operator ++ ()
+   {
+      index = pTree->next(index);
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator old = *this;
+      ++*this;
+      return old;
+   }
+   iterator & operator -- ()
+   {
+      index = pTree->prev(index);
+      return *this;
+   }
+   iterator operator -- (int postfix)
+   {
+      iterator old = *this;
+      --*this;
+      return old;
+   }
+
+private:
+   iterator(const IndexBST * pTree, Link index) : pTree(pTree), index(index) {}
+
+   const IndexBST * pTree;
+   Link index;
+};
+
+/*********************************************
+ * INDEX BST :: CONSTRUCT from a BST
+ * Lay the elements out in sorted order and hang a
+ * perfectly balanced tree over them
+ ********************************************/
+template <typename T, typename A>
+template <typename B>
+IndexBST <T, A> :: IndexBST(const BST <T, A, B> & rhs) :
+   nodes(NodeAlloc(rhs.get_allocator())), root(NIL)
+{
+   assert(rhs.size() < NIL);
+   nodes.reserve(rhs.size());
+   for (auto it = rhs.begin(); it != rhs.end(); ++it)
+      nodes.push_back(Node{ *it, NIL, NIL, NIL });
+
+   // the deepest level is red, unless it is the root
+   size_t redDepth = 0;
+   while (((size_t)2 << redDepth) <= nodes.size())
+      redDepth++;
+   root = buildBalanced(0, (Link)nodes.size(), NIL, 0, redDepth ? redDepth : 1);
+}
+
+/*********************************************
+ * INDEX BST :: BUILD BALANCED
+ * Link nodes [first, last) into a subtree rooted at the
+ * middle. Every leaf is on one of the two lowest levels,
+ * so coloring the lowest red keeps the black heights even.
+ ********************************************/
+template <typename T, typename A>
+typename IndexBST <T, A> :: Link IndexBST <T, A> :: buildBalanced(Link first, Link last, Link parent,
+                                                                 size_t depth, size_t redDepth)
+{
+   if (first == last)
+      return NIL;
+   Link middle = first + (last - first) / 2;
+   nodes[middle].parent = parent;
+   nodes[middle].parent.setRed(depth == redDepth);
+   nodes[middle].left   = buildBalanced(first, middle, middle, depth + 1, redDepth);
+   nodes[middle].right  = buildBalanced(middle + 1, last, middle, depth + 1, redDepth);
+   return middle;
+}
+
+/*********************************************
+ * INDEX BST :: BEGIN
+ * The left-most node
+ ********************************************/
+template <typename T, typename A>
+typename IndexBST <T, A> :: iterator IndexBST <T, A> :: begin() const noexcept
+{
+   return iterator(this, root == NIL ? NIL : minimum(root));
+}
+
+/*********************************************
+ * INDEX BST :: FIND
+ * Return the node corresponding to a given value
+ ********************************************/
+template <typename T, typename A>
+typename IndexBST <T, A> :: iterator IndexBST <T, A> :: find(const T & t) const
+{
+   Link i = root;
+   while (i != NIL)
+   {
+      const Node & node = nodes[i];
+      if (node.data == t)
+         return iterator(this, i);
+      i = (t < node.data) ? node.left : node.right;
+   }
+   return end();
+}
+
+/*********************************************
+ * INDEX BST :: INSERT
+ * Insert a node at a given location in the tree
+ ********************************************/
+template <typename T, typename A>
+std::pair<typename IndexBST <T, A> :: iterator, bool> IndexBST <T, A> :: insert(const T & t, bool keepUnique)
+{
+   return insertNode(t, keepUnique);
+}
+
+template <typename T, typename A>
+std::pair<typename IndexBST <T, A> :: iterator, bool> IndexBST <T, A> :: insert(T && t, bool keepUnique)
+{
+   return insertNode(std::move(t), keepUnique);
+}
+
+/*********************************************
+ * INDEX BST :: INSERT NODE
+ * Walk to the leaf where t belongs and append the new node
+ * to the end of the vector, red. Duplicates go right.
+ ********************************************/
+template <typename T, typename A>
+template <typename U>
+std::pair<typename IndexBST <T, A> :: iterator, bool> IndexBST <T, A> :: insertNode(U && t, bool keepUnique)
+{
+   Link parent = NIL;
+   Link i = root;
+   bool isLeft = false;
+   while (i != NIL)
+   {
+      if (keepUnique && t == nodes[i].data)
+         return std::pair<iterator, bool>(iterator(this, i), false);
+      parent = i;
+      isLeft = t < nodes[i].data;
+      i = isLeft ? nodes[i].left : nodes[i].right;
+   }
+
+   assert(nodes.size() < NIL);
+   Link added = (Link)nodes.size();
+   nodes.push_back(Node{ T(std::forward<U>(t)), NIL, NIL, parent });
+   if (parent == NIL)
+      root = added;
+   else if (isLeft)
+      nodes[parent].left = added;
+   else
+      nodes[parent].right = added;
+   nodes[added].parent.setRed(true);
+   fixRedRed(added);
+
+   return std::pair<iterator, bool>(iterator(this, added), true);
+}
+
+/*********************************************
+ * INDEX BST :: ERASE
+ * Unlink the node, restore the black heights if it was
+ * black, then move the last node of the vector into its
+ * slot so the vector never has holes. Returns the node
+ * after the one erased.
+ ********************************************/
+template <typename T, typename A>
+typename IndexBST <T, A> :: iterator IndexBST <T, A> :: erase(iterator & it)
+{
+   Link doomed = it.index;
+   if (doomed == NIL)
+      return end();
+   Link following = next(doomed);
+
+   // two children: the successor's value takes our place and the
+   // successor, which has no left child, is the one to unlink
+   if (nodes[doomed].left != NIL && nodes[doomed].right != NIL)
+   {
+      nodes[doomed].data = std::move(nodes[following].data);
+      std::swap(doomed, following);
+   }
+
+   // at most one child now: splice it into the parent
+   Link child = nodes[doomed].left != NIL ? nodes[doomed].left : nodes[doomed].right;
+   Link parent = nodes[doomed].parent;
+   if (child != NIL)
+      nodes[child].parent = parent;
+   replaceChild(parent, doomed, child);
+   if (!isRed(doomed))
+      fixDoubleBlack(child, parent);
+
+   // fill the hole with the last node
+   Link last = (Link)nodes.size() - 1;
+   if (doomed != last)
+   {
+      bool red = nodes[last].parent.isRed();
+      nodes[doomed] = std::move(nodes[last]);
+      nodes[doomed].parent.setRed(red);
+      replaceChild(nodes[doomed].parent, last, doomed);
+      if (nodes[doomed].left != NIL)
+         nodes[nodes[doomed].left].parent = doomed;
+      if (nodes[doomed].right != NIL)
+         nodes[nodes[doomed].right].parent = doomed;
+      if (following == last)
+         following = doomed;
+   }
+   nodes.pop_back();
+
+   return iterator(this, following);
+}
+
+/*********************************************
+ * INDEX BST :: REPLACE CHILD
+ * Point whatever referred to node "from" at node "to"
+ ********************************************/
+template <typename T, typename A>
+void IndexBST <T, A> :: replaceChild(Link parent, Link from, Link to)
+{
+   if (parent == NIL)
+      root = to;
+   else if (nodes[parent].left == from)
+      nodes[parent].left = to;
+   else
+      nodes[parent].right = to;
+}
+
+/*********************************************
+ * INDEX BST :: ROTATE LEFT and RIGHT
+ * The child on one side takes the place of i, which
+ * becomes its child on the other side
+ ********************************************/
+template <typename T, typename A>
+void IndexBST <T, A> :: rotateLeft(Link i)
+{
+   Link pivot = nodes[i].right;
+   nodes[i].right = nodes[pivot].left;
+   if (nodes[pivot].left != NIL)
+      nodes[nodes[pivot].left].parent = i;
+   nodes[pivot].parent = nodes[i].parent;
+   replaceChild(nodes[i].parent, i, pivot);
+   nodes[pivot].left = i;
+   nodes[i].parent = pivot;
+}
+
+template <typename T, typename A>
+void IndexBST <T, A> :: rotateRight(Link i)
+{
+   Link pivot = nodes[i].left;
+   nodes[i].left = nodes[pivot].right;
+   if (nodes[pivot].right != NIL)
+      nodes[nodes[pivot].right].parent = i;
+   nodes[pivot].parent = nodes[i].parent;
+   replaceChild(nodes[i].parent, i, pivot);
+   nodes[pivot].right = i;
+   nodes[i].parent = pivot;
+}
+
+/*********************************************
+ * INDEX BST :: FIX RED RED
+ * The red node i may have a red parent. A red aunt
+ * pushes the red up to the grandparent; a black one
+ * means one or two rotations and done.
+ ********************************************/
+template <typename T, typename A>
+void IndexBST <T, A> :: fixRedRed(Link i)
+{
+   while (i != root && isRed(nodes[i].parent))
+   {
+      Link parent = nodes[i].parent;
+      Link granny = nodes[parent].parent;
+      bool isLeft = nodes[granny].left == parent;
+      Link aunt = isLeft ? nodes[granny].right : nodes[granny].left;
+
+      if (isRed(aunt))
+      {
+         nodes[parent].parent.setRed(false);
+         nodes[aunt].parent.setRed(false);
+         nodes[granny].parent.setRed(true);
+         i = granny;
+         continue;
+      }
+
+      // bend the inside grandchild to the outside first
+      if (isLeft && nodes[parent].right == i)
+      {
+         rotateLeft(parent);
+         parent = i;
+      }
+      else if (!isLeft && nodes[parent].left == i)
+      {
+         rotateRight(parent);
+         parent = i;
+      }
+      nodes[parent].parent.setRed(false);
+      nodes[granny].parent.setRed(true);
+      if (isLeft)
+         rotateRight(granny);
+      else
+         rotateLeft(granny);
+      break;
+   }
+   nodes[root].parent.setRed(false);
+}
+
+/*********************************************
+ * INDEX BST :: FIX DOUBLE BLACK
+ * A black node was unlinked from above i (possibly NIL),
+ * whose parent is parent, so every path through i is one
+ * black short. Borrow from the sibling's side, moving up
+ * while the sibling has no red to spare.
+ ********************************************/
+template <typename T, typename A>
+void IndexBST <T, A> :: fixDoubleBlack(Link i, Link parent)
+{
+   while (i != root && !isRed(i))
+   {
+      bool isLeft = nodes[parent].left == i;
+      Link sibling = isLeft ? nodes[parent].right : nodes[parent].left;
+
+      // a red sibling: rotate it up so the sibling is black
+      if (isRed(sibling))
+      {
+         nodes[sibling].parent.setRed(false);
+         nodes[parent].parent.setRed(true);
+         if (isLeft)
+            rotateLeft(parent);
+         else
+            rotateRight(parent);
+         sibling = isLeft ? nodes[parent].right : nodes[parent].left;
+      }
+
+      Link nearNephew = isLeft ? nodes[sibling].left  : nodes[sibling].right;
+      Link farNephew  = isLeft ? nodes[sibling].right : nodes[sibling].left;
+
+      // nothing red below the sibling: it turns red and the problem moves up
+      if (!isRed(nearNephew) && !isRed(farNephew))
+      {
+         nodes[sibling].parent.setRed(true);
+         i = parent;
+         parent = nodes[i].parent;
+         continue;
+      }
+
+      // the red nephew must be on the far side
+      if (!isRed(farNephew))
+      {
+         nodes[nearNephew].parent.setRed(false);
+         nodes[sibling].parent.setRed(true);
+         if (isLeft)
+            rotateRight(sibling);
+         else
+            rotateLeft(sibling);
+         farNephew = sibling;
+         sibling = nearNephew;
+      }
+
+      nodes[sibling].parent.setRed(isRed(parent));
+      nodes[parent].parent.setRed(false);
+      nodes[farNephew].parent.setRed(false);
+      if (isLeft)
+         rotateLeft(parent);
+      else
+         rotateRight(parent);
+      i = root;
+   }
+   if (i != NIL)
+      nodes[i].parent.setRed(false);
+}
+
+/*********************************************
+ * INDEX BST :: MINIMUM and MAXIMUM
+ * The left-most and right-most nodes under i
+ ********************************************/
+template <typename T, typename A>
+typename IndexBST <T, A> :: Link IndexBST <T, A> :: minimum(Link i) const
+{
+   while (nodes[i].left != NIL)
+      i = nodes[i].left;
+   return i;
+}
+
+template <typename T, typename A>
+typename IndexBST <T, A> :: Link IndexBST <T, A> :: maximum(Link i) const
+{
+   while (nodes[i].right != NIL)
+      i = nodes[i].right;
+   return i;
+}
+
+/*********************************************
+ * INDEX BST :: NEXT
+ * The in-order successor of i, NIL past the end
+ ********************************************/
+template <typename T, typename A>
+typename IndexBST <T, A> :: Link IndexBST <T, A> :: next(Link i) const
+{
+   if (i == NIL)
+      return NIL;
+   if (nodes[i].right != NIL)
+      return minimum(nodes[i].right);
+   Link parent = nodes[i].parent;
+   while (parent != NIL && nodes[parent].right == i)
+   {
+      i = parent;
+      parent = nodes[i].parent;
+   }
+   return parent;
+}
+
+/*********************************************
+ * INDEX BST :: PREV
+ * The in-order predecessor of i. Backing up from
+ * the end lands on the largest element.
+ ********************************************/
+template <typename T, typename A>
+typename IndexBST <T, A> :: Link IndexBST <T, A> :: prev(Link i) const
+{
+   if (i == NIL)
+      return root == NIL ? NIL : maximum(root);
+   if (nodes[i].left != NIL)
+      return maximum(nodes[i].left);
+   Link parent = nodes[i].parent;
+   while (parent != NIL && nodes[parent].left == i)
+   {
+      i = parent;
+      parent = nodes[i].parent;
+   }
+   return parent;
+}
+
+} // namespace custom
@@ -0,0 +1,402 @@
+/***********************************************************************
+ * Header:
+ *    MAPPED BST
+ * Summary:
+ *    A binary search tree saved to a file in the same form it is searched
+ *    in, so that loading it is mapping the file into memory and nothing
+ *    more: no parsing, no allocation, and no page is read from the disk
+ *    until a search first touches it. The file is a short header followed
+ *    by the nodes in sorted order. The tree over them is perfectly
+ *    balanced, rooted at the middle node of every range, so the children
+ *    are worked out rather than stored and a damaged file cannot send a
+ *    search outside it. Because the nodes are in order, iterating is
+ *    walking the array.
+ *
+ *    The elements are written byte for byte, so they must be trivially
+ *    copyable, and a file can only be read on a machine with the same byte
+ *    order and the same sizeof(T).
+ *
+ *    The nodes are kept in the order of the tree they were saved from, so
+ *    a MappedBST is searched with that tree's comparator C, default
+ *    constructed. save() only takes trees ordered by the same C, ranked or
+ *    not. The file does not record C: open it as the same MappedBST <T, C>
+ *    that saved it.
+ *
+ *    This will contain the class definition of:
+ *        MappedBST           : A read-only BST in a memory-mapped file
+ *        MappedBST::iterator : An iterator through MappedBST
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>    // for std::uint32_t and std::uint64_t
+#include <cstring>    // for std::memcpy and std::memset
+#include <fstream>    // for std::ofstream
+#include <functional> // for std::less
+#include <type_traits>// for std::is_trivially_copyable_v
+#include <utility>    // for std::swap
+#include <vector>     // for std::vector
+#include "bst.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>    // for open
+#include <sys/mman.h> // for mmap and munmap
+#include <sys/stat.h> // for fstat
+#include <unistd.h>   // for close
+#endif
+
+class TestMappedBST; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************************************
+ * MAPPED BINARY SEARCH TREE
+ * A tree written once with save() and then only searched
+ *****************************************************************/
+template <typename T, typename C = std::less<T> >
+class MappedBST
+{
+   static_assert(std::is_trivially_copyable_v<T>,
+                 "only trivially copyable elements can be written byte for byte");
+   friend class ::TestMappedBST; // give unit tests access to the privates
+
+public:
+   //
+   // Construct
+   //
+
+   MappedBST() : pImage(nullptr), numBytes(0), pNodes(nullptr), numNodes(0), comp() {}
+   explicit MappedBST(const char * path) : MappedBST() { open(path); }
+   MappedBST(MappedBST && rhs) noexcept : MappedBST() { swap(rhs); }
+   MappedBST(const MappedBST &) = delete;
+  ~MappedBST() { close(); }
+   MappedBST & operator = (MappedBST && rhs) noexcept
+   {
+      close();
+      swap(rhs);
+      return *this;
+   }
+   MappedBST & operator = (const MappedBST &) = delete;
+   void swap(MappedBST & rhs) noexcept
+   {
+      std::swap(pImage,   rhs.pImage);
+      std::swap(numBytes, rhs.numBytes);
+      std::swap(pNodes,   rhs.pNodes);
+      std::swap(numNodes, rhs.numNodes);
+      std::swap(comp,     rhs.comp);
+   }
+
+   //
+   // Save and load
+   //
+
+   template <typename A, typename B, bool S>
+   static bool save(const BST <T, A, B, C, S> & tree, const char * path);
+   bool open(const char * path);
+   void close() noexcept;
+   bool is_open() const noexcept { return pImage != nullptr; }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() const noexcept { return iterator(pNodes); }
+   iterator end()   const noexcept { return iterator(pNodes + numNodes); }
+
+   //
+   // Access
+   //
+
+   iterator find(const T & t) const;
+
+   //
+   // Status
+   //
+
+   bool   empty() const noexcept { return numNodes == 0; }
+   size_t size()  const noexcept { return numNodes;      }
+
+private:
+   typedef std::uint32_t Link;
+   static constexpr Link NIL = 0xFFFFFFFF;   // the index of no node at all
+
+   struct Node
+   {
+      T data;
+   };
+
+   // the start of the file. The nodes follow at NODE_OFFSET
+   struct Header
+   {
+      char          magic[8];       // "BSTIMAGE"
+      std::uint32_t version;
+      std::uint32_t byteOrder;      // ENDIAN_CHECK as the writer saw it
+      std::uint32_t nodeSize;       // sizeof(Node) of the writer
+      std::uint32_t root;           // index of the middle node or NIL
+      std::uint64_t numNodes;
+   };
+   static constexpr std::uint32_t VERSION      = 2;
+   static constexpr std::uint32_t ENDIAN_CHECK = 0x01020304;
+   static constexpr size_t        NODE_OFFSET  = 64;
+   static_assert(sizeof(Header) <= NODE_OFFSET && alignof(Node) <= NODE_OFFSET,
+                 "the nodes must start aligned after the header");
+
+   bool isValid() const;
+   bool map(const char * path);
+
+   const unsigned char * pImage;   // the whole file, or null if none is open
+   size_t numBytes;                // size of the file
+   const Node * pNodes;            // the nodes, in sorted order
+   size_t numNodes;
+   C comp;                         // the order the nodes were saved in
+};
+
+/**********************************************************
+ * MAPPED BST ITERATOR
+ * Forward and reverse iterator through a MappedBST. The
+ * nodes are in order, so this is a pointer into the file.
+ *********************************************************/
+template <typename T, typename C>
+class MappedBST <T, C> :: iterator
+{
+   friend class ::TestMappedBST; // give unit tests access to the privates
+   friend class MappedBST <T, C>;
+public:
+   // constructors and assignment
+   iterator() : pNode(nullptr) {}
+
+   // compare
+   bool operator == (const iterator & rhs) const { return pNode == rhs.pNode; }
+   bool operator != (const iterator & rhs) const { return pNode != rhs.pNode; }
+
+   // de-reference. Cannot change because the file is read-only
+   const T & operator * () const { return pNode->data; }
+
+   // increment and decrement
+   iterator & operator ++ ()
+   {
+      ++pNode;
+      return *this;
+   }
+   iterator operator ++ (int)
+   {
+      iterator old = *this;
+      ++*this;
+      return old;
+   }
+   iterator & operator -- ()
+   {
+      --pNode;
+      return *this;
+   }
+   iterator operator -- (int)
+   {
+      iterator old = *this;
+      --*this;
+      return old;
+   }
+
+private:
+   explicit iterator(const Node * pNode) : pNode(pNode) {}
+
+   const Node * pNode;
+};
+
+/*********************************************
+ * MAPPED BST :: SAVE
+ * Copy the elements out in order and write the header
+ * and the nodes. The padding is zeroed so the same tree
+ * gives the same file.
+ ********************************************/
+template <typename T, typename C>
+template <typename A, typename B, bool S>
+bool MappedBST <T, C> :: save(const BST <T, A, B, C, S> & tree, const char * path)
+{
+   if (tree.size() >= NIL)
+      return false;
+
+   std::vector<Node> nodes(tree.size());
+   if (!nodes.empty())
+      std::memset(static_cast<void *>(nodes.data()), 0, nodes.size() * sizeof(Node));
+   size_t i = 0;
+   for (auto it = tree.begin(); it != tree.end(); ++it, ++i)
+      std::memcpy(static_cast<void *>(&nodes[i].data), &*it, sizeof(T));
+
+   unsigned char header[NODE_OFFSET] = {};
+   Header h;
+   std::memset(static_cast<void *>(&h), 0, sizeof(h));
+   std::memcpy(h.magic, "BSTIMAGE", sizeof(h.magic));
+   h.version   = VERSION;
+   h.byteOrder = ENDIAN_CHECK;
+   h.nodeSize  = (std::uint32_t)sizeof(Node);
+   h.root      = nodes.empty() ? NIL : (Link)(nodes.size() / 2);
+   h.numNodes  = nodes.size();
+   std::memcpy(header, &h, sizeof(h));
+
+   std::ofstream fout(path, std::ios::binary | std::ios::trunc);
+   fout.write(reinterpret_cast<const char *>(header), sizeof(header));
+   fout.write(reinterpret_cast<const char *>(nodes.data()), nodes.size() * sizeof(Node));
+   fout.close();
+   return !fout.fail();
+}
+
+/*********************************************
+ * MAPPED BST :: OPEN
+ * Map the file and check the header. Anything that is not
+ * a tree of this T written on this kind of machine is
+ * refused, leaving nothing open.
+ ********************************************/
+template <typename T, typename C>
+bool MappedBST <T, C> :: open(const char * path)
+{
+   close();
+   if (!map(path))
+      return false;
+   if (!isValid())
+   {
+      close();
+      return false;
+   }
+
+   Header h;
+   std::memcpy(&h, pImage, sizeof(h));
+   pNodes   = reinterpret_cast<const Node *>(pImage + NODE_OFFSET);
+   numNodes = (size_t)h.numNodes;
+   return true;
+}
+
+/*********************************************
+ * MAPPED BST :: IS VALID
+ * Does the mapped file hold what save() writes?
+ ********************************************/
+template <typename T, typename C>
+bool MappedBST <T, C> :: isValid() const
+{
+   if (numBytes < NODE_OFFSET)
+      return false;
+   Header h;
+   std::memcpy(&h, pImage, sizeof(h));
+   return std::memcmp(h.magic, "BSTIMAGE", sizeof(h.magic)) == 0 &&
+          h.version   == VERSION &&
+          h.byteOrder == ENDIAN_CHECK &&
+          h.nodeSize  == sizeof(Node) &&
+          h.numNodes  == (numBytes - NODE_OFFSET) / sizeof(Node) &&
+          (numBytes - NODE_OFFSET) % sizeof(Node) == 0 &&
+          h.root      == (h.numNodes == 0 ? NIL : h.numNodes / 2);
+}
+
+/*********************************************
+ * MAPPED BST :: MAP
+ * Map the whole file read-only
+ ********************************************/
+template <typename T, typename C>
+bool MappedBST <T, C> :: map(const char * path)
+{
+#ifdef _WIN32
+   HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (hFile == INVALID_HANDLE_VALUE)
+      return false;
+   LARGE_INTEGER fileSize;
+   HANDLE hMapping = nullptr;
+   if (GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart > 0)
+      hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   CloseHandle(hFile);
+   if (hMapping == nullptr)
+      return false;
+   void * p = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+   CloseHandle(hMapping);
+   if (p == nullptr)
+      return false;
+   numBytes = (size_t)fileSize.QuadPart;
+#else
+   int fd = ::open(path, O_RDONLY);
+   if (fd < 0)
+      return false;
+   struct stat status;
+   void * p = MAP_FAILED;
+   if (fstat(fd, &status) == 0 && status.st_size > 0)
+      p = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   ::close(fd);
+   if (p == MAP_FAILED)
+      return false;
+   numBytes = (size_t)status.st_size;
+#endif
+   pImage = static_cast<const unsigned char *>(p);
+   return true;
+}
+
+/*********************************************
+ * MAPPED BST :: CLOSE
+ * Unmap the file, if one is open
+ ********************************************/
+template <typename T, typename C>
+void MappedBST <T, C> :: close() noexcept
+{
+   if (pImage)
+   {
+#ifdef _WIN32
+      UnmapViewOfFile(pImage);
+#else
+      munmap(const_cast<unsigned char *>(pImage), numBytes);
+#endif
+   }
+   pImage   = nullptr;
+   numBytes = 0;
+   pNodes   = nullptr;
+   numNodes = 0;
+}
+
+/*********************************************
+ * MAPPED BST :: FIND
+ * Return the node corresponding to a given value. The
+ * subtree over [lo, hi) is rooted at its middle node,
+ * so the search never leaves the nodes in the file.
+ * Equal is neither ordered before the other by C.
+ ********************************************/
+template <typename T, typename C>
+typename MappedBST <T, C> :: iterator MappedBST <T, C> :: find(const T & t) const
+{
+   size_t lo = 0;
+   size_t hi = numNodes;
+   while (lo < hi)
+   {
+      size_t middle = lo + (hi - lo) / 2;
+      const Node & node = pNodes[middle];
+      if constexpr (is_three_way<C>::value)
+      {
+         auto order = comp(t, node.data);
+         if (order == 0)
+            return iterator(&node);
+         if (order < 0)
+            hi = middle;
+         else
+            lo = middle + 1;
+      }
+      else
+      {
+         if (comp(t, node.data))
+            hi = middle;
+         else if (comp(node.data, t))
+            lo = middle + 1;
+         else
+            return iterator(&node);
+      }
+   }
+   return end();
+}
+
+} // namespace custom
@@ -0,0 +1,319 @@
+/***********************************************************************
+ * Header:
+ *    NODE SEARCH
+ * Summary:
+ *    Find where a value goes in the sorted array of a B+ tree node.
+ *    For 32 and 64 bit integers, floats and doubles the whole node is
+ *    compared against the value 4 to 8 elements per instruction and the
+ *    elements below it are counted, which needs no branches at all. The
+ *    widest instructions this processor has are picked the first time a
+ *    search is made. The vector searches are built by GCC and Clang
+ *    (including clang-cl) and by MSVC, on 32 or 64 bit x86 only. Any
+ *    other type, processor or compiler gets a binary search.
+ *
+ *    This will contain:
+ *        Isa                 : The instruction sets a search can use
+ *        lowerBound()        : The first element not less than a value
+ *        upperBound()        : The first element greater than a value
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <algorithm>  // for std::lower_bound and std::upper_bound
+#include <cstddef>    // for size_t
+#include <cstdint>    // for std::int32_t and std::int64_t
+#include <type_traits>// for std::is_integral_v
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CUSTOM_NODE_SEARCH_X86
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define CUSTOM_NODE_SEARCH_X86
+#include <immintrin.h>
+#include <intrin.h>   // for __cpuid and __cpuidex
+#endif
+
+// GCC and Clang only emit vector instructions in functions marked
+// for them; MSVC emits whatever intrinsics it is given
+#if defined(__GNUC__) || defined(__clang__)
+#define CUSTOM_NODE_SEARCH_TARGET(isa) __attribute__((target(isa)))
+#else
+#define CUSTOM_NODE_SEARCH_TARGET(isa)
+#endif
+
+namespace custom
+{
+namespace nodeSearch
+{
+
+/*****************************************************************
+ * ISA
+ * The instructions a search can be done with
+ *****************************************************************/
+enum class Isa { scalar, sse42, avx2 };
+
+/*********************************************
+ * BEST ISA
+ * The widest instructions this processor has, found once
+ ********************************************/
+inline Isa bestIsa()
+{
+#if defined(CUSTOM_NODE_SEARCH_X86) && defined(__GNUC__)
+   static const Isa isa = __builtin_cpu_supports("avx2")   ? Isa::avx2  :
+                          __builtin_cpu_supports("sse4.2") ? Isa::sse42 : Isa::scalar;
+   return isa;
+#elif defined(CUSTOM_NODE_SEARCH_X86)
+   static const Isa isa = []
+   {
+      int info[4];                                 // eax, ebx, ecx, edx
+      __cpuid(info, 0);
+      int maxLeaf = info[0];
+      __cpuid(info, 1);
+      bool sse42 = (info[2] >> 20) & 1;
+      // AVX also needs the operating system to save the wide registers
+      bool avx = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) &&
+                 (_xgetbv(0) & 6) == 6;
+      bool avx2 = false;
+      if (avx && maxLeaf >= 7)
+      {
+         __cpuidex(info, 7, 0);
+         avx2 = (info[1] >> 5) & 1;
+      }
+      return avx2 ? Isa::avx2 : sse42 ? Isa::sse42 : Isa::scalar;
+   }();
+   return isa;
+#else
+   return Isa::scalar;
+#endif
+}
+
+/*********************************************
+ * COUNT BELOW SCALAR
+ * How many of the sorted keys are less than t, or with
+ * orEqual not greater than t
+ ********************************************/
+template <bool orEqual, typename T>
+size_t countBelowScalar(const T * keys, size_t num, const T & t)
+{
+   if (orEqual)
+      return std::upper_bound(keys, keys + num, t) - keys;
+   return std::lower_bound(keys, keys + num, t) - keys;
+}
+
+#ifdef CUSTOM_NODE_SEARCH_X86
+
+/*********************************************
+ * COUNT BITS
+ * How many bits of a comparison mask are set
+ ********************************************/
+inline int countBits(int bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return __builtin_popcount(bits);
+#else
+   int count = 0;
+   for (; bits; bits &= bits - 1)
+      count++;
+   return count;
+#endif
+}
+
+/*********************************************
+ * COUNT BELOW AVX2 and SSE4.2
+ * The same for the first numBlocks full vectors of keys,
+ * comparing a vector at a time and adding up the bits of
+ * the comparison masks. Integer keys are only ever read
+ * through the vector loads, so long and long long can
+ * share the 64 bit kernels.
+ ********************************************/
+template <bool orEqual>
+CUSTOM_NODE_SEARCH_TARGET("avx2")
+size_t countBelowAvx2(const void * keys, size_t numBlocks, std::int32_t t)
+{
+   __m256i value = _mm256_set1_epi32(t);
+   size_t count = 0;
+   for (size_t i = 0; i < numBlocks; i++)
+   {
+      __m256i block = _mm256_loadu_si256(static_cast<const __m256i *>(keys) + i);
+      __m256i mask = orEqual ? _mm256_cmpgt_epi32(block, value) : _mm256_cmpgt_epi32(value, block);
+      int bits = countBits(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+      count += orEqual ? 8 - bits : bits;
+   }
+   return count;
+}
+
+template <bool orEqual>
+CUSTOM_NODE_SEARCH_TARGET("avx2")
+size_t countBelowAvx2(const void * keys, size_t numBlocks, std::int64_t t)
+{
+   __m256i value = _mm256_set1_epi64x(t);
+   size_t count = 0;
+   for (size_t i = 0; i < numBlocks; i++)
+   {
+      __m256i block = _mm256_loadu_si256(static_cast<const __m256i *>(keys) + i);
+      __m256i mask = orEqual ? _mm256_cmpgt_epi64(block, value) : _mm256_cmpgt_epi64(value, block);
+      int bits = countBits(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+      count += orEqual ? 4 - bits : bits;
+   }
+   return count;
+}
+
+template <bool orEqual>
+CUSTOM_NODE_SEARCH_TARGET("avx2")
+size_t countBelowAvx2(const float * keys, size_t numBlocks, float t)
+{
+   __m256 value = _mm256_set1_ps(t);
+   size_t count = 0;
+   for (size_t i = 0; i < numBlocks * 8; i += 8)
+   {
+      __m256 block = _mm256_loadu_ps(keys + i);
+      __m256 mask = orEqual ? _mm256_cmp_ps(block, value, _CMP_LE_OQ) :
+                              _mm256_cmp_ps(block, value, _CMP_LT_OQ);
+      count += countBits(_mm256_movemask_ps(mask));
+   }
+   return count;
+}
+
+template <bool orEqual>
+CUSTOM_NODE_SEARCH_TARGET("avx2")
+size_t countBelowAvx2(const double * keys, size_t numBlocks, double t)
+{
+   __m256d value = _mm256_set1_pd(t);
+   size_t count = 0;
+   for (size_t i = 0; i < numBlocks * 4; i += 4)
+   {
+      __m256d block = _mm256_loadu_pd(keys + i);
+      __m256d mask = orEqual ? _mm256_cmp_pd(block, value, _CMP_LE_OQ) :
+                               _mm256_cmp_pd(block, value, _CMP_LT_OQ);
+      count += countBits(_mm256_movemask_pd(mask));
+   }
+   return count;
+}
+
+template <bool orEqual>
+CUSTOM_NODE_SEARCH_TARGET("sse4.2")
+size_t countBelowSse42(const void * keys, size_t numBlocks, std::int32_t t)
+{
+   __m128i value = _mm_set1_epi32(t);
+   size_t count = 0;
+   for (size_t i = 0; i < numBlocks; i++)
+   {
+      __m128i block = _mm_loadu_si128(static_cast<const __m128i *>(keys) + i);
+      __m128i mask = orEqual ? _mm_cmpgt_epi32(block, value) : _mm_cmpgt_epi32(value, block);
+      int bits = countBits(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+      count += orEqual ? 4 - bits : bits;
+   }
+   return count;
+}
+
+template <bool orEqual>
+CUSTOM_NODE_SEARCH_TARGET("sse4.2")
+size_t countBelowSse42(const void * keys, size_t numBlocks, std::int64_t t)
+{
+   __m128i value = _mm_set1_epi64x(t);
+   size_t count = 0;
+   for (size_t i = 0; i < numBlocks; i++)
+   {
+      __m128i block = _mm_loadu_si128(static_cast<const __m128i *>(keys) + i);
+      __m128i mask = orEqual ? _mm_cmpgt_epi64(block, value) : _mm_cmpgt_epi64(value, block);
+      int bits = countBits(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+      count += orEqual ? 2 - bits : bits;
+   }
+   return count;
+}
+
+template <bool orEqual>
+CUSTOM_NODE_SEARCH_TARGET("sse4.2")
+size_t countBelowSse42(const float * keys, size_t numBlocks, float t)
+{
+   __m128 value = _mm_set1_ps(t);
+   size_t count = 0;
+   for (size_t i = 0; i < numBlocks * 4; i += 4)
+   {
+      __m128 block = _mm_loadu_ps(keys + i);
+      __m128 mask = orEqual ? _mm_cmple_ps(block, value) : _mm_cmplt_ps(block, value);
+      count += countBits(_mm_movemask_ps(mask));
+   }
+   return count;
+}
+
+template <bool orEqual>
+CUSTOM_NODE_SEARCH_TARGET("sse4.2")
+size_t countBelowSse42(const double * keys, size_t numBlocks, double t)
+{
+   __m128d value = _mm_set1_pd(t);
+   size_t count = 0;
+   for (size_t i = 0; i < numBlocks * 2; i += 2)
+   {
+      __m128d block = _mm_loadu_pd(keys + i);
+      __m128d mask = orEqual ? _mm_cmple_pd(block, value) : _mm_cmplt_pd(block, value);
+      count += countBits(_mm_movemask_pd(mask));
+   }
+   return count;
+}
+
+#endif // CUSTOM_NODE_SEARCH_X86
+
+/*********************************************
+ * IS VECTORIZED
+ * The types the vector searches know how to compare
+ ********************************************/
+template <typename T>
+inline constexpr bool isVectorized =
+   (std::is_integral_v<T> && std::is_signed_v<T> && (sizeof(T) == 4 || sizeof(T) == 8)) ||
+   std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+/*********************************************
+ * COUNT BELOW
+ * Count with the given instructions: the full vectors
+ * first, then what is left over past them one by one
+ ********************************************/
+template <bool orEqual, typename T>
+size_t countBelow(const T * keys, size_t num, const T & t, Isa isa)
+{
+#ifdef CUSTOM_NODE_SEARCH_X86
+   if constexpr (isVectorized<T>)
+   {
+      // long and long long are both 64 bits but different types, so
+      // integers go to the kernels as raw memory and a value of the width
+      typedef std::conditional_t<std::is_integral_v<T>,
+              std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>, T> Key;
+      typedef std::conditional_t<std::is_integral_v<T>, const void *, const T *> Keys;
+      Keys pKeys = keys;
+      size_t lanes = (isa == Isa::avx2 ? 32 : 16) / sizeof(T);
+      size_t numBlocks = num / lanes;
+      size_t done = numBlocks * lanes;
+      size_t count = 0;
+      if (isa == Isa::avx2)
+         count = countBelowAvx2<orEqual>(pKeys, numBlocks, (Key)t);
+      else if (isa == Isa::sse42)
+         count = countBelowSse42<orEqual>(pKeys, numBlocks, (Key)t);
+      else
+         return countBelowScalar<orEqual>(keys, num, t);
+      return count + countBelowScalar<orEqual>(keys + done, num - done, t);
+   }
+#endif
+   return countBelowScalar<orEqual>(keys, num, t);
+}
+
+/*********************************************
+ * LOWER BOUND and UPPER BOUND
+ * The index of the first key not less than t, and of
+ * the first key greater than t
+ ********************************************/
+template <typename T>
+size_t lowerBound(const T * keys, size_t num, const T & t)
+{
+   return countBelow<false>(keys, num, t, isVectorized<T> ? bestIsa() : Isa::scalar);
+}
+
+template <typename T>
+size_t upperBound(const T * keys, size_t num, const T & t)
+{
+   return countBelow<true>(keys, num, t, isVectorized<T> ? bestIsa() : Isa::scalar);
+}
+
+} // namespace nodeSearch
+} // namespace custom
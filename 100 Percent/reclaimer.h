@@ -0,0 +1,149 @@
+/***********************************************************************
+ * Header:
+ *    RECLAIMER
+ * Summary:
+ *    A background thread that frees memory the program no longer needs,
+ *    a little at a time, so the thread that let go of it does not have
+ *    to. Work is handed over as a step function that does a bounded
+ *    amount of freeing and reports whether there is more to do. Between
+ *    steps the reclaimer pauses, which bounds how fast memory is handed
+ *    back to the allocator.
+ *
+ *    This will contain the class definition of:
+ *        Reclaimer           : The background reclaimer thread
+ *        reclaim_safe        : Allocators the reclaimer may free through
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#include <chrono>             // for std::chrono::microseconds
+#include <condition_variable> // for std::condition_variable
+#include <deque>              // for std::deque
+#include <functional>         // for std::function
+#include <memory>             // for std::allocator
+#include <mutex>              // for std::mutex
+#include <thread>             // for std::thread
+
+namespace custom
+{
+
+/*****************************************************************
+ * RECLAIMER
+ * One thread, shared by everything, working through a queue of jobs
+ * one step at a time. Jobs take turns so a huge one does not hold up
+ * the rest.
+ *****************************************************************/
+class Reclaimer
+{
+public:
+   // a step frees a little and returns true once the job is done
+   typedef std::function<bool()> Step;
+
+   static Reclaimer & instance()
+   {
+      static Reclaimer reclaimer;
+      return reclaimer;
+   }
+
+   // hand a job to the reclaimer thread
+   void submit(Step step)
+   {
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         jobs.push_back(std::move(step));
+      }
+      wake.notify_one();
+   }
+
+   // block until every job handed over so far is done
+   void drain()
+   {
+      std::unique_lock<std::mutex> guard(lock);
+      idle.wait(guard, [this]() { return jobs.empty() && !isBusy; });
+   }
+
+   // how long to rest between steps
+   void pace(std::chrono::microseconds pause)
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      this->pause = pause;
+   }
+
+private:
+   Reclaimer() : isBusy(false), isStopping(false), pause(0),
+                 worker([this]() { work(); }) {}
+
+   // whatever is left when the program ends is finished without resting
+   ~Reclaimer()
+   {
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         isStopping = true;
+      }
+      wake.notify_one();
+      worker.join();
+   }
+
+   Reclaimer(const Reclaimer &) = delete;
+   Reclaimer & operator = (const Reclaimer &) = delete;
+
+   /*********************************************
+    * RECLAIMER :: WORK
+    * Take the next job, run one step of it, and put it
+    * back at the end of the line if it is not done
+    ********************************************/
+   void work()
+   {
+      std::unique_lock<std::mutex> guard(lock);
+      while (true)
+      {
+         wake.wait(guard, [this]() { return isStopping || !jobs.empty(); });
+         if (jobs.empty())
+            return;
+
+         Step step = std::move(jobs.front());
+         jobs.pop_front();
+         isBusy = true;
+         std::chrono::microseconds rest = isStopping ? std::chrono::microseconds(0) : pause;
+         guard.unlock();
+
+         bool isDone = step();
+         if (!isDone && rest.count() > 0)
+            std::this_thread::sleep_for(rest);
+
+         guard.lock();
+         if (!isDone)
+            jobs.push_back(std::move(step));
+         isBusy = false;
+         if (jobs.empty())
+            idle.notify_all();
+      }
+   }
+
+   std::mutex lock;                    // guards everything below
+   std::condition_variable wake;       // a job arrived or it is time to stop
+   std::condition_variable idle;       // the queue has run dry
+   std::deque<Step> jobs;              // jobs waiting for their next step
+   bool isBusy;                        // a step is running right now
+   bool isStopping;                    // the program is ending
+   std::chrono::microseconds pause;    // rest between steps
+   std::thread worker;                 // started last, once the rest is ready
+};
+
+/*****************************************************************
+ * RECLAIM SAFE
+ * Whether memory from an allocator may be handed back on the reclaimer
+ * thread while its owner keeps allocating on another. std::allocator
+ * can; a polymorphic_allocator cannot, since most memory resources
+ * (monotonic, unsynchronized pools) are not synchronized. Specialize
+ * this for an allocator of your own that is thread-safe.
+ *****************************************************************/
+template <class Alloc>
+struct reclaim_safe : std::false_type {};
+
+template <class U>
+struct reclaim_safe <std::allocator<U> > : std::true_type {};
+
+} // namespace custom
@@ -0,0 +1,634 @@
+/***********************************************************************
+ * Header:
+ *    TEST B PLUS TREE
+ * Summary:
+ *    Unit tests for bPlusTree
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "bPlusTree.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <vector>
+#include <memory_resource>
+
+ /***********************************************
+  * TEST B PLUS TREE
+  * Unit tests for the BPlusTree class
+  ***********************************************/
+class TestBPlusTree : public UnitTest
+{
+   // an allocator whose copies are told apart by a tag: a copy
+   // constructed container gets the next tag, and assignment
+   // carries the tag over
+   template <class U>
+   struct TaggedAllocator
+   {
+      typedef U value_type;
+      typedef std::true_type propagate_on_container_copy_assignment;
+      int tag;
+      TaggedAllocator(int tag = 0) : tag(tag) {}
+      template <class V>
+      TaggedAllocator(const TaggedAllocator<V> & rhs) : tag(rhs.tag) {}
+      U * allocate(size_t n)            { return std::allocator<U>().allocate(n);   }
+      void deallocate(U * p, size_t n)  { std::allocator<U>().deallocate(p, n);     }
+      TaggedAllocator select_on_container_copy_construction() const { return TaggedAllocator(tag + 1); }
+      template <class V>
+      bool operator == (const TaggedAllocator<V> & rhs) const { return tag == rhs.tag; }
+      template <class V>
+      bool operator != (const TaggedAllocator<V> & rhs) const { return tag != rhs.tag; }
+   };
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_fromBST();
+      test_constructCopy_standard();
+      test_constructCopy_allocator();
+      test_assignMove_otherResource();
+
+      // Iterator
+      test_iterator_forward();
+      test_iterator_backward();
+
+      // Find
+      test_find_standard();
+      test_find_missing();
+      test_find_fewComparisons();
+
+      // Insert
+      test_insert_splitRoot();
+      test_insert_duplicates();
+      test_insert_keepUnique();
+
+      // Remove
+      test_erase_borrow();
+      test_erase_scattered();
+      test_erase_all();
+      test_erase_advances();
+
+      // Node search
+      test_search_int32();
+      test_search_int64();
+      test_search_float();
+      test_search_double();
+      test_search_whichTypes();
+
+      // Status
+      test_node_size();
+      test_height_hundredThousand();
+
+      report("BPlusTree");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // default constructor, no nodes
+   void test_construct_default()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::BPlusTree<Spy> tree;
+      // verify
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(tree.pRoot == nullptr);
+      assertUnit(tree.size() == 0);
+      assertUnit(tree.empty());
+      assertUnit(tree.begin() == tree.end());
+   }  // teardown
+
+   // the elements of a pointer tree arrive in order
+   void test_construct_fromBST()
+   {  // setup
+      custom::BST<int> src;
+      for (int i = 0; i < 1000; i++)
+         src.insert((i * 7919) % 1000);
+      // exercise
+      custom::BPlusTree<int> tree(src);
+      // verify
+      assertUnit(tree.size() == 1000);
+      assertValid(tree);
+      assertRange(tree, 0, 1000);
+   }  // teardown
+
+   // copying copies the nodes and compares nothing
+   void test_constructCopy_standard()
+   {  // setup
+      custom::BPlusTree<Spy> src;
+      for (int i = 0; i < 1000; i++)
+         src.insert(Spy(i));
+      Spy::reset();
+      // exercise
+      custom::BPlusTree<Spy> dest(src);
+      // verify
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(dest.size() == 1000);
+      assertUnit(dest.height() == src.height());
+      assertUnit(dest.pRoot != src.pRoot);
+      assertValid(dest);
+      int expected = 0;
+      for (auto it = dest.begin(); it != dest.end(); ++it)
+         assertUnit(*it == Spy(expected++));
+   }  // teardown
+
+   // a copy gets the allocator the source picks for it, even if
+   // its allocator propagates on assignment
+   void test_constructCopy_allocator()
+   {  // setup
+      custom::BPlusTree<int, TaggedAllocator<int> > src(TaggedAllocator<int>(1));
+      for (int i = 0; i < 1000; i++)
+         src.insert(i);
+      // exercise
+      custom::BPlusTree<int, TaggedAllocator<int> > dest(src);
+      // verify
+      assertUnit(dest.get_allocator().tag == 2);
+      assertUnit(dest.size() == 1000);
+      int expected = 0;
+      for (auto it = dest.begin(); it != dest.end(); ++it)
+         assertUnit(*it == expected++);
+      assertUnit(expected == 1000);
+   }  // teardown
+
+   // a pmr tree keeps its own resource, so the nodes are copied into it
+   void test_assignMove_otherResource()
+   {  // setup
+      std::pmr::unsynchronized_pool_resource resourceSrc;
+      std::pmr::unsynchronized_pool_resource resourceDest;
+      custom::BPlusTree<int, std::pmr::polymorphic_allocator<int> > src(&resourceSrc);
+      custom::BPlusTree<int, std::pmr::polymorphic_allocator<int> > dest(&resourceDest);
+      for (int i = 0; i < 1000; i++)
+         src.insert(i);
+      auto pRootSrc = src.pRoot;
+      // exercise
+      dest = std::move(src);
+      // verify
+      assertUnit(dest.get_allocator().resource() == &resourceDest);
+      assertUnit(dest.size() == 1000);
+      assertUnit(dest.pRoot != pRootSrc);
+      assertUnit(src.empty());
+      int expected = 0;
+      for (auto it = dest.begin(); it != dest.end(); ++it)
+         assertUnit(*it == expected++);
+      assertUnit(expected == 1000);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk forward across many leaves
+   void test_iterator_forward()
+   {  // setup
+      custom::BPlusTree<int> tree;
+      setupStandard(tree);
+      std::vector<int> values;
+      // exercise
+      for (auto it = tree.begin(); it != tree.end(); it++)
+         values.push_back(*it);
+      // verify
+      assertUnit(values.size() == 10000);
+      for (int i = 0; i < (int)values.size(); i++)
+         assertUnit(values[i] == i);
+   }  // teardown
+
+   // walk backward from the end
+   void test_iterator_backward()
+   {  // setup
+      custom::BPlusTree<int> tree;
+      setupStandard(tree);
+      int expected = 10000;
+      auto it = tree.end();
+      // exercise
+      while (it != tree.begin())
+         assertUnit(*--it == --expected);
+      // verify
+      assertUnit(expected == 0);
+      assertUnit(--it == tree.end());
+   }  // teardown
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // find every element
+   void test_find_standard()
+   {  // setup
+      custom::BPlusTree<int> tree;
+      setupStandard(tree);
+      // exercise
+      for (int i = 0; i < 10000; i += 7)
+      {
+         auto it = tree.find(i);
+         // verify
+         assertUnit(it != tree.end());
+         if (it != tree.end())
+            assertUnit(*it == i);
+      }
+   }  // teardown
+
+   // look for things that are not there, including past either end
+   void test_find_missing()
+   {  // setup
+      custom::BPlusTree<int> tree;
+      for (int i = 0; i < 10000; i += 2)
+         tree.insert(i);
+      // exercise and verify
+      assertUnit(tree.find(-1) == tree.end());
+      assertUnit(tree.find(5001) == tree.end());
+      assertUnit(tree.find(10000) == tree.end());
+   }  // teardown
+
+   // a binary search per level: about log2(n) comparisons in all
+   void test_find_fewComparisons()
+   {  // setup
+      custom::BPlusTree<Spy> tree;
+      for (int i = 0; i < 10000; i++)
+         tree.insert(Spy(i));
+      Spy::reset();
+      // exercise
+      auto it = tree.find(Spy(6789));
+      // verify
+      assertUnit(it != tree.end());
+      assertUnit(Spy::numEquals() == 1);
+      assertUnit(Spy::numLessthan() <= 14 + (int)tree.height());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // one more than a leaf holds splits it and grows a root above
+   void test_insert_splitRoot()
+   {  // setup
+      custom::BPlusTree<int> tree;
+      size_t capacity = custom::BPlusTree<int>::leafCapacity;
+      for (size_t i = 0; i < capacity; i++)
+         tree.insert((int)i);
+      assertUnit(tree.height() == 1);
+      // exercise
+      tree.insert((int)capacity);
+      // verify
+      assertUnit(tree.height() == 2);
+      assertUnit(tree.pFirst != tree.pLast);
+      assertUnit(tree.pFirst->pNext == tree.pLast);
+      assertValid(tree);
+      assertRange(tree, 0, (int)capacity + 1);
+   }  // teardown
+
+   // duplicates span several leaves and go after their equals
+   void test_insert_duplicates()
+   {  // setup
+      custom::BPlusTree<int> tree;
+      for (int i = 0; i < 100; i++)
+         tree.insert(i * 10);
+      // exercise
+      for (int i = 0; i < 500; i++)
+         tree.insert(500);
+      // verify
+      assertUnit(tree.size() == 600);
+      assertValid(tree);
+      auto it = tree.find(500);
+      assertUnit(it != tree.end());
+      if (it == tree.end())
+         return;
+      assertUnit(*--it == 490);
+      ++it;
+      int count = 0;
+      for (; it != tree.end() && *it == 500; ++it)
+         count++;
+      assertUnit(count == 501);
+   }  // teardown
+
+   // a duplicate is refused when asked to keep things unique
+   void test_insert_keepUnique()
+   {  // setup
+      custom::BPlusTree<int> tree;
+      setupStandard(tree);
+      // exercise
+      auto pairTree = tree.insert(1234, true /* keepUnique */);
+      // verify
+      assertUnit(pairTree.second == false);
+      assertUnit(pairTree.first == tree.find(1234));
+      assertUnit(tree.size() == 10000);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // a leaf left less than half full takes from its neighbor
+   void test_erase_borrow()
+   {  // setup
+      custom::BPlusTree<int> tree;
+      size_t capacity = custom::BPlusTree<int>::leafCapacity;
+      for (size_t i = 0; i <= capacity; i++)
+         tree.insert((int)i);
+      tree.insert(-1);       // the left leaf has one to spare
+      auto pLeft = tree.pFirst;
+      auto pRight = tree.pLast;
+      // exercise
+      auto it = tree.find((int)capacity);
+      auto itNext = tree.erase(it);
+      // verify
+      assertUnit(itNext == tree.end());
+      assertUnit(tree.pFirst == pLeft && tree.pLast == pRight);
+      assertUnit(pRight->numKeys == custom::BPlusTree<int>::leafMin);
+      assertValid(tree);
+      assertRange(tree, -1, (int)capacity);
+   }  // teardown
+
+   // erase in a scattered order; each erase returns the next element
+   void test_erase_scattered()
+   {  // setup
+      custom::BPlusTree<int> tree;
+      setupStandard(tree);
+      // exercise
+      for (int i = 0; i < 10000; i++)
+      {
+         int key = (i * 7919) % 10000;
+         if (key % 4 == 0)
+            continue;
+         auto it = tree.find(key);
+         assertUnit(it != tree.end());
+         auto itNext = tree.erase(it);
+         int next = key + 1;
+         while (next < 10000 && next % 4 != 0 && tree.find(next) == tree.end())
+            next++;
+         if (next < 10000)
+            assertUnit(itNext != tree.end() && *itNext == next);
+         else
+            assertUnit(itNext == tree.end());
+      }
+      // verify
+      assertUnit(tree.size() == 2500);
+      assertValid(tree);
+      int expected = 0;
+      for (auto it = tree.begin(); it != tree.end(); ++it, expected += 4)
+         assertUnit(*it == expected);
+   }  // teardown
+
+   // erasing everything from the front leaves nothing behind
+   void test_erase_all()
+   {  // setup
+      custom::BPlusTree<Spy> tree;
+      for (int i = 0; i < 5000; i++)
+         tree.insert(Spy(i));
+      // exercise
+      for (int i = 0; i < 5000; i++)
+      {
+         auto it = tree.begin();
+         auto itNext = tree.erase(it);
+         assertUnit(i == 4999 ? itNext == tree.end() : *itNext == Spy(i + 1));
+      }
+      // verify
+      assertUnit(tree.empty());
+      assertUnit(tree.pRoot == nullptr);
+      assertUnit(tree.pFirst == nullptr && tree.pLast == nullptr);
+   }  // teardown
+
+   // as with BST, the iterator handed in moves on to the next element
+   void test_erase_advances()
+   {  // setup
+      custom::BPlusTree<int> tree;
+      for (int i = 0; i < 1000; i++)
+         tree.insert(i);
+      auto it = tree.begin();
+      // exercise
+      while (it != tree.end())
+      {
+         int value = *it;
+         auto itNext = tree.erase(it);
+         assertUnit(itNext == it);
+         assertUnit(it == tree.end() || *it == value + 1);
+      }
+      // verify
+      assertUnit(tree.empty());
+   }  // teardown
+
+   /***************************************
+    * NODE SEARCH
+    *    nodeSearch::lowerBound(), upperBound()
+    ***************************************/
+
+   // every instruction set finds the same place as a binary search
+   void test_search_int32()
+   {
+      assertUnit(searchAgrees<std::int32_t>());
+   }
+
+   void test_search_int64()
+   {
+      assertUnit(searchAgrees<std::int64_t>());
+      assertUnit(searchAgrees<long long>());
+      assertUnit(searchAgrees<long>());
+   }
+
+   void test_search_float()
+   {
+      assertUnit(searchAgrees<float>());
+   }
+
+   void test_search_double()
+   {
+      assertUnit(searchAgrees<double>());
+   }
+
+   // only the plain signed numbers are searched with vectors
+   void test_search_whichTypes()
+   {
+      assertUnit(custom::nodeSearch::isVectorized<int>);
+      assertUnit(custom::nodeSearch::isVectorized<long long>);
+      assertUnit(custom::nodeSearch::isVectorized<double>);
+      assertUnit(!custom::nodeSearch::isVectorized<unsigned int>);
+      assertUnit(!custom::nodeSearch::isVectorized<short>);
+      assertUnit(!custom::nodeSearch::isVectorized<Spy>);
+   }
+
+   /***************************************
+    * STATUS
+    ***************************************/
+
+   // a node fills most of eight cache lines
+   void test_node_size()
+   {
+      assertUnit(sizeof(custom::BPlusTree<int>::Leaf)  <= 512);
+      assertUnit(sizeof(custom::BPlusTree<int>::Leaf)  >= 256);
+      assertUnit(sizeof(custom::BPlusTree<int>::Inner) <= 512);
+      assertUnit(sizeof(custom::BPlusTree<int>::Inner) >= 256);
+      assertUnit(sizeof(custom::BPlusTree<double>::Leaf)  <= 512);
+      assertUnit(sizeof(custom::BPlusTree<double>::Inner) <= 512);
+   }
+
+   // the nodes a find visits: a red-black tree of this many is at
+   // least seventeen deep, one node and likely one cache miss per level
+   void test_height_hundredThousand()
+   {  // setup
+      custom::BPlusTree<int> tree;
+      // exercise
+      for (int i = 0; i < 100000; i++)
+         tree.insert((int)(((long long)i * 7919) % 100000));
+      // verify
+      assertUnit(tree.size() == 100000);
+      assertUnit(tree.height() <= 4);
+      assertValid(tree);
+   }  // teardown
+
+   /**************************************************************
+    * SETUP STANDARD FIXTURE
+    * 0 through 9999 in order, across three levels of nodes
+    *************************************************************/
+   void setupStandard(custom::BPlusTree<int> & tree)
+   {
+      for (int i = 0; i < 10000; i++)
+         tree.insert(i);
+   }
+
+   /**************************************************************
+    * SEARCH AGREES
+    * For arrays of every length up to a few vectors past a
+    * full one, with runs of equal keys, each instruction set
+    * the processor has agrees with std::lower_bound and
+    * std::upper_bound for values on, between and past the keys
+    *************************************************************/
+   template <typename T>
+   bool searchAgrees()
+   {
+      using namespace custom::nodeSearch;
+      std::vector<Isa> isas = { Isa::scalar };
+      if (bestIsa() != Isa::scalar)
+         isas.push_back(Isa::sse42);
+      if (bestIsa() == Isa::avx2)
+         isas.push_back(Isa::avx2);
+
+      for (size_t num = 0; num <= 40; num++)
+      {
+         std::vector<T> keys;
+         for (size_t i = 0; i < num; i++)
+            keys.push_back((T)((int)(i / 3) * 2 - 10));   // -10 -10 -10 -8 ...
+         for (int value = -13; value <= (int)num; value++)
+         {
+            T t = (T)value;
+            size_t lower = std::lower_bound(keys.begin(), keys.end(), t) - keys.begin();
+            size_t upper = std::upper_bound(keys.begin(), keys.end(), t) - keys.begin();
+            for (Isa isa : isas)
+               if (countBelow<false>(keys.data(), num, t, isa) != lower ||
+                   countBelow<true >(keys.data(), num, t, isa) != upper)
+                  return false;
+            if (lowerBound(keys.data(), num, t) != lower ||
+                upperBound(keys.data(), num, t) != upper)
+               return false;
+         }
+      }
+      return true;
+   }
+
+   /**************************************************************
+    * VERIFY RANGE
+    * The tree holds exactly lo through hi - 1, in order
+    *************************************************************/
+   void assertRange(const custom::BPlusTree<int> & tree, int lo, int hi)
+   {
+      int expected = lo;
+      for (auto it = tree.begin(); it != tree.end(); ++it)
+         assertUnit(*it == expected++);
+      assertUnit(expected == hi);
+   }
+
+   /**************************************************************
+    * VERIFY VALID
+    * Every node is linked to its parent, no node but the root
+    * is less than half full, separators bound their children,
+    * and the leaves are chained in order and hold every element
+    *************************************************************/
+   template <typename T>
+   void assertValid(const custom::BPlusTree<T> & tree)
+   {
+      typedef custom::BPlusTree<T> Tree;
+      assertUnit(tree.pRoot != nullptr);
+      if (tree.pRoot == nullptr)
+         return;
+      assertUnit(tree.pRoot->pParent == nullptr);
+      size_t numLeaves = 0;
+      size_t numElements = 0;
+      verifyNode<T>(tree, tree.pRoot, nullptr, nullptr, 1, numLeaves, numElements);
+      assertUnit(numElements == tree.size());
+
+      // the chain visits the same leaves, in order
+      size_t numChained = 0;
+      const typename Tree::Leaf * pPrev = nullptr;
+      for (auto pLeaf = tree.pFirst; pLeaf; pPrev = pLeaf, pLeaf = pLeaf->pNext)
+      {
+         assertUnit(pLeaf->pPrev == pPrev);
+         if (pPrev)
+            assertUnit(!(pLeaf->keys()[0] < pPrev->keys()[pPrev->numKeys - 1]));
+         numChained++;
+      }
+      assertUnit(pPrev == tree.pLast);
+      assertUnit(numChained == numLeaves);
+   }
+
+   template <typename T>
+   void verifyNode(const custom::BPlusTree<T> & tree,
+                   const typename custom::BPlusTree<T>::Node * pNode,
+                   const T * pLo, const T * pHi, size_t depth,
+                   size_t & numLeaves, size_t & numElements)
+   {
+      typedef custom::BPlusTree<T> Tree;
+      bool isRoot = pNode == tree.pRoot;
+      const T * keys;
+      if (pNode->isLeaf)
+      {
+         keys = static_cast<const typename Tree::Leaf *>(pNode)->keys();
+         assertUnit(depth == tree.height());
+         assertUnit(pNode->numKeys <= Tree::leafCapacity);
+         assertUnit(isRoot || pNode->numKeys >= Tree::leafMin);
+         numLeaves++;
+         numElements += pNode->numKeys;
+      }
+      else
+      {
+         keys = static_cast<const typename Tree::Inner *>(pNode)->keys();
+         assertUnit(pNode->numKeys <= Tree::innerCapacity);
+         assertUnit(isRoot ? pNode->numKeys >= 1 : pNode->numKeys >= Tree::innerMin);
+      }
+
+      for (size_t i = 0; i < pNode->numKeys; i++)
+      {
+         if (i > 0)
+            assertUnit(!(keys[i] < keys[i - 1]));
+         if (pLo)
+            assertUnit(!(keys[i] < *pLo));
+         if (pHi)
+            assertUnit(!(*pHi < keys[i]));
+      }
+
+      if (!pNode->isLeaf)
+      {
+         auto pInner = static_cast<const typename Tree::Inner *>(pNode);
+         for (size_t i = 0; i <= pInner->numKeys; i++)
+         {
+            assertUnit(pInner->children[i]->pParent == pInner);
+            verifyNode(tree, pInner->children[i],
+                       i == 0 ? pLo : keys + i - 1,
+                       i == pInner->numKeys ? pHi : keys + i,
+                       depth + 1, numLeaves, numElements);
+         }
+      }
+   }
+};
+
+#endif // DEBUG
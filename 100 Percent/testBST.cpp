@@ -14,6 +14,10 @@
 
 #include "testBST.h"        // for the BST unit tests
 #include "testSpy.h"        // for the spy unit tests
+#include "testIndexBST.h"   // for the IndexBST unit tests
+#include "testBPlusTree.h"  // for the BPlusTree unit tests
+#include "testFrozenSet.h"  // for the frozen_set unit tests
+#include "testMappedBST.h"  // for the MappedBST unit tests
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -26,6 +30,10 @@ int main()
    // unit tests
    TestSpy().run();
    TestBST().run();
+   TestIndexBST().run();
+   TestBPlusTree().run();
+   TestFrozenSet().run();
+   TestMappedBST().run();
 #endif // DEBUG
    
    return 0;
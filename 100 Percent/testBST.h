@@ -19,7 +19,11 @@
 #include <memory>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <functional> // for std::less and std::greater
+#include <vector>
+#include <execution>  // for std::execution::seq and par
+#include <thread>     // for std::thread
 
  /***********************************************
   * TEST BST
@@ -27,6 +31,50 @@
   ***********************************************/
 class TestBST : public UnitTest
 {
+   // orders Spys by their values, all in one call, counting the calls
+   struct SpyThreeWay
+   {
+      typedef void is_three_way;
+      inline static size_t numCalls = 0;
+      int operator () (const Spy & lhs, const Spy & rhs) const
+      {
+         numCalls++;
+         return lhs.get() < rhs.get() ? -1 : (rhs.get() < lhs.get() ? 1 : 0);
+      }
+   };
+
+   // hands out memory 64 bytes past an alignment it was asked for,
+   // as a malloc-based allocator that ignores alignof() might
+   template <class U>
+   struct MisalignedAllocator
+   {
+      typedef U value_type;
+      MisalignedAllocator() = default;
+      template <class V>
+      MisalignedAllocator(const MisalignedAllocator<V> &) {}
+      U * allocate(size_t n)
+      {
+         char * p = static_cast<char *>(::operator new(n * sizeof(U) + 64, std::align_val_t(alignof(U))));
+         return reinterpret_cast<U *>(p + 64);
+      }
+      void deallocate(U * p, size_t)
+      {
+         ::operator delete(reinterpret_cast<char *>(p) - 64, std::align_val_t(alignof(U)));
+      }
+      template <class V>
+      bool operator == (const MisalignedAllocator<V> &) const { return true; }
+      template <class V>
+      bool operator != (const MisalignedAllocator<V> &) const { return false; }
+   };
+
+   // orders Spys by their values, and compares them with ints too
+   struct SpyByValue
+   {
+      typedef void is_transparent;
+      bool operator () (const Spy & lhs, const Spy & rhs) const { return lhs.get() < rhs.get(); }
+      bool operator () (const Spy & lhs, int rhs)         const { return lhs.get() < rhs;       }
+      bool operator () (int lhs, const Spy & rhs)         const { return lhs < rhs.get();       }
+   };
 
 public:
    void run()
@@ -38,9 +86,18 @@ public:
       test_constructCopy_empty();
       test_constructCopy_one();
       test_constructCopy_standard();
+      test_constructCopy_colors();
+      test_constructCopy_trivialColors();
+      test_constructCopy_deepStick();
       test_constructMove_empty();
       test_constructMove_one();
       test_constructMove_standard();
+      test_construct_resource();
+      test_constructCopy_resource();
+      test_constructSorted_standard();
+      test_constructSorted_partialLevelRed();
+      test_constructSorted_oneRun();
+      test_constructInit_unsorted();
 
       // Assign
       test_assign_emptyToEmpty();
@@ -59,6 +116,13 @@ public:
       test_swap_standardToEmpty();
       test_swap_emptyToStandard();
       test_swap_standardToStandard();
+      test_assignSorted_standardToStandard();
+      test_assignParallel_reuseNodes();
+      test_assignParallel_splitThreads();
+      test_build_sequenced();
+      test_build_keepUnique();
+      test_build_parallel();
+      test_build_splitThreads();
 
       // Iterator
       test_begin_empty();
@@ -70,6 +134,8 @@ public:
       test_iterator_increment_standardToGrandchild();
       test_iterator_increment_standardToDone();
       test_iterator_increment_standardEnd();
+      test_iterator_decrement_standardEnd();
+      test_iterator_decrement_emptyEnd();
       test_iterator_dereference_standardRead();
 
       // Find
@@ -77,6 +143,31 @@ public:
       test_find_standardBegin();
       test_find_standardLast();
       test_find_standardMissing();
+      test_find_oneComparePerLevel();
+      test_find_threeWay();
+      test_insert_threeWayKeepUnique();
+      test_insert_intLessThan();
+      test_findBatch_empty();
+      test_findBatch_standard();
+      test_findBatch_manyGroups();
+      test_count_duplicates();
+      test_eraseValue_duplicates();
+      test_find_transparent();
+      test_lowerBound_transparent();
+      test_count_transparent();
+      test_erase_transparent();
+      test_find_stringView();
+
+      // Range queries
+      test_lowerBound_standard();
+      test_upperBound_standard();
+      test_upperBound_backFromEnd();
+      test_equalRange_duplicates();
+      test_equalRange_missing();
+      test_lowerBound_walkBack();
+      test_forEachInRange_window();
+      test_forEachInRange_empty();
+      test_forEachInRange_transparent();
 
       // Insert
       test_insert_oneLeft();
@@ -87,6 +178,54 @@ public:
       test_insertMove_oneRight();
       test_insertMove_duplicate();
       test_insertMove_keepUnique();
+      test_insert_case1();
+      test_insert_case2();
+      test_insert_case3();
+      test_insert_case4aSimple();
+      test_insert_case4bSimple();
+      test_insert_case4cSimple();
+      test_insert_case4dSimple();
+      test_insert_case4aComplex();
+      test_insert_case4bComplex();
+      test_insert_case4cComplex();
+      test_insert_case4dComplex();
+      test_insert_statsSingle();
+      test_insert_statsDouble();
+      test_insert_statsRecolor();
+      test_insert_sortedStaysBalanced();
+      test_insert_appendSkipsDescent();
+      test_insert_appendAfterErase();
+      test_insertHint_beforeHint();
+      test_insertHint_afterPrevious();
+      test_insertHint_end();
+      test_insertHint_wrongHint();
+      test_insertHint_keepUnique();
+      test_insertHint_descending();
+      test_insertHint_ranked();
+
+      // Balance policy
+      test_policy_avlSorted();
+      test_policy_avlChurn();
+      test_policy_avlBuild();
+      test_policy_wavlSorted();
+      test_policy_wavlChurn();
+      test_policy_wavlBuild();
+      test_policy_treapChurn();
+      test_policy_treapCopy();
+      test_policy_scapegoatSorted();
+      test_policy_scapegoatErase();
+      test_policy_unbalancedSorted();
+      test_policy_compareHeights();
+
+      // Order statistics
+      test_select_standard();
+      test_rank_standard();
+      test_countRange_window();
+      test_distance_standard();
+      test_sizes_churn();
+      test_sizes_build();
+      test_sizes_extract();
+      test_sizes_unranked();
 
       // Remove
       test_erase_empty();
@@ -94,8 +233,39 @@ public:
       test_erase_noChildren();
       test_erase_oneChild();
       test_erase_twoChildren();
+      test_erase_blackLeafFarNephew();
+      test_erase_blackWithRedChild();
+      test_erase_ninetyPercent();
       test_clear_empty();
       test_clear_standard();
+      test_clear_releaseSlabs();
+      test_clear_destroyThenRelease();
+      test_clear_deepStick();
+      test_releaseAsync_standard();
+      test_releaseAsync_reuseTree();
+      test_releaseAsync_foreignNodes();
+      test_releaseAsync_resource();
+      test_extract_standard();
+      test_extract_outlivesTree();
+      test_insertNode_otherTree();
+      test_insertNode_keepUnique();
+
+      // Pool
+      test_pool_insertShareSlab();
+      test_pool_eraseRecycle();
+      test_pool_churnNoAllocs();
+      test_pool_shrinkToFit();
+      test_pool_limitRecycledDefault();
+      test_pool_limitRecycled();
+      test_pool_limitRecycledScattered();
+      test_pool_recycleAnyRun();
+      test_pool_misalignedAllocator();
+      test_pool_foreignNodesOtherThread();
+      test_pool_fallbackOtherThreads();
+
+      // Node
+      test_node_size();
+      test_node_colorSurvivesParent();
 
       // Status
       test_empty_empty();
@@ -251,6 +421,235 @@ public:
       teardownStandardFixture(bstDest);
    }
 
+   // the copy has the same colors and its nodes sit in one run of slabs
+   void test_constructCopy_colors()
+   {  // setup
+      custom::BST <Spy> bstSrc;
+      setupStandardFixture(bstSrc);
+      bstSrc.root->pLeft->setRed(true);
+      bstSrc.root->pRight->pRight->setRed(true);
+      Spy::reset();
+      // exercise
+      custom::BST <Spy> bstDest(bstSrc);
+      // verify
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numAlloc() <= 7);
+      assertUnit(bstDest.numSlabAllocs() == 1);
+      assertStandardFixture(bstDest);
+      if (bstDest.root && bstDest.root->pLeft && bstDest.root->pRight && bstDest.root->pRight->pRight)
+      {
+         assertUnit(bstDest.root->isRed() == false);
+         assertUnit(bstDest.root->pLeft->isRed() == true);
+         assertUnit(bstDest.root->pRight->isRed() == false);
+         assertUnit(bstDest.root->pRight->pRight->isRed() == true);
+      }
+      // teardown
+      teardownStandardFixture(bstSrc);
+   }
+
+   // nodes of a trivially copyable type are copied whole, color and all
+   void test_constructCopy_trivialColors()
+   {  // setup
+      std::vector<int> values = { 10, 20, 30, 40 };
+      custom::BST <int> bstSrc(values.begin(), values.end(), custom::sorted_tag);
+      // exercise
+      custom::BST <int> bstDest(bstSrc);
+      // verify
+      //          (20)
+      //      +----+----+
+      //    (10)      (30)
+      //                +--+
+      //                  [40]
+      assertUnit(bstDest.size() == 4);
+      assertUnit(bstDest.root && bstDest.root != bstSrc.root);
+      if (!bstDest.root || !bstDest.root->pRight || !bstDest.root->pRight->pRight)
+         return;
+      assertUnit(bstDest.root->pParent == nullptr);
+      assertUnit(bstDest.root->data == 20);
+      assertUnit(bstDest.root->pLeft->pParent == bstDest.root);
+      assertUnit(bstDest.root->pRight->pRight->data == 40);
+      assertUnit(bstDest.root->pRight->pRight->pParent == bstDest.root->pRight);
+      assertUnit(bstDest.root->pRight->pRight->isRed() == true);
+      assertUnit(bstDest.root->pRight->isRed() == false);
+   }  // teardown
+
+   // copying a tree as deep as it is long does not recurse
+   void test_constructCopy_deepStick()
+   {  // setup
+      custom::BST <int> bstSrc;
+      custom::BST <int>::BNode * pTail = nullptr;
+      for (int i = 0; i < 10000; i++)
+      {
+         custom::BST <int>::BNode * pNode = new custom::BST <int>::BNode(i);
+         if (pTail)
+         {
+            pTail->pRight = pNode;
+            pNode->pParent = pTail;
+         }
+         else
+            bstSrc.root = pNode;
+         pTail = pNode;
+      }
+      bstSrc.numElements = 10000;
+      // exercise
+      custom::BST <int> bstDest(bstSrc);
+      // verify
+      assertUnit(bstDest.size() == 10000);
+      assertUnit(bstDest.numSlabAllocs() == 1);
+      int expected = 0;
+      for (auto it = bstDest.begin(); it != bstDest.end(); ++it)
+         assertUnit(*it == expected++);
+      assertUnit(expected == 10000);
+   }  // teardown
+
+   /***************************************
+    * ALLOCATOR CONSTRUCTOR
+    ***************************************/
+
+   // nodes come from the memory resource given to the constructor
+   void test_construct_resource()
+   {  // setup
+      static unsigned char buffer[32 * 1024];
+      std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer),
+                                                   std::pmr::null_memory_resource());
+      // exercise
+      custom::pmr::BST <int> bst(&resource);
+      bst.insert(50);
+      bst.insert(30);
+      // verify
+      //            (50)
+      //        +----+
+      //      (30)
+      assertUnit(bst.get_allocator().resource() == &resource);
+      assertUnit(bst.numElements == 2);
+      assertUnit(bst.root != nullptr);
+      if (bst.root && bst.root->pLeft)
+      {
+         assertUnit((unsigned char*)bst.root >= buffer);
+         assertUnit((unsigned char*)bst.root < buffer + sizeof(buffer));
+         assertUnit((unsigned char*)bst.root->pLeft >= buffer);
+         assertUnit((unsigned char*)bst.root->pLeft < buffer + sizeof(buffer));
+      }
+   }  // teardown
+
+   // a copy does not inherit a pmr tree's resource
+   void test_constructCopy_resource()
+   {  // setup
+      static unsigned char buffer[32 * 1024];
+      std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer),
+                                                   std::pmr::null_memory_resource());
+      custom::pmr::BST <int> bstSrc(&resource);
+      bstSrc.insert(50);
+      // exercise
+      custom::pmr::BST <int> bstDest(bstSrc);
+      // verify
+      assertUnit(bstDest.get_allocator().resource() == std::pmr::get_default_resource());
+      assertUnit(bstDest.numElements == 1);
+      assertUnit(bstDest.root != nullptr);
+      if (bstDest.root)
+      {
+         assertUnit(bstDest.root->data == 50);
+         assertUnit(bstDest.root != bstSrc.root);
+         assertUnit((unsigned char*)bstDest.root <  buffer ||
+                    (unsigned char*)bstDest.root >= buffer + sizeof(buffer));
+      }
+   }  // teardown
+
+   /***************************************
+    * SORTED RANGE CONSTRUCTOR
+    *     BST::BST(first, last, sorted_tag)
+    ***************************************/
+
+   // sorted input builds the standard fixture without comparing anything
+   void test_constructSorted_standard()
+   {  // setup
+      std::vector<Spy> values = { Spy(20), Spy(30), Spy(40), Spy(50),
+                                  Spy(60), Spy(70), Spy(80) };
+      Spy::reset();
+      // exercise
+      custom::BST <Spy> bst(values.begin(), values.end(), custom::sorted_tag);
+      // verify
+      assertUnit(Spy::numCopy() == 7);      // copy     [20][30][40][50][60][70][80]
+      assertUnit(Spy::numAlloc() == 7);     // allocate [20][30][40][50][60][70][80]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(bst.numSlabAllocs() == 1);
+      //                (50)
+      //          +-------+-------+
+      //        (30)            (70)
+      //     +----+----+     +----+----+
+      //   (20)      (40)  (60)      (80)
+      assertStandardFixture(bst);
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         assertUnit(it.pNode->isRed() == false);
+   }  // teardown
+
+   // a partly filled bottom level is red, everything above is black
+   void test_constructSorted_partialLevelRed()
+   {  // setup
+      std::vector<int> values = { 10, 20, 30, 40 };
+      // exercise
+      custom::BST <int> bst(values.begin(), values.end(), custom::sorted_tag);
+      // verify
+      //          (20)
+      //      +----+----+
+      //    (10)      (30)
+      //                +--+
+      //                  [40]
+      assertUnit(bst.numElements == 4);
+      assertUnit(bst.root && bst.root->data == 20);
+      if (!bst.root || !bst.root->pLeft || !bst.root->pRight || !bst.root->pRight->pRight)
+         return;
+      assertUnit(bst.root->pParent == nullptr);
+      assertUnit(bst.root->pLeft->data == 10);
+      assertUnit(bst.root->pRight->data == 30);
+      assertUnit(bst.root->pRight->pRight->data == 40);
+      assertUnit(bst.root->pRight->pRight->pParent == bst.root->pRight);
+      assertUnit(bst.root->isRed() == false);
+      assertUnit(bst.root->pLeft->isRed() == false);
+      assertUnit(bst.root->pRight->isRed() == false);
+      assertUnit(bst.root->pRight->pRight->isRed() == true);
+   }  // teardown
+
+   // many slabs worth of nodes come from one trip to the allocator
+   void test_constructSorted_oneRun()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 10000; i++)
+         values.push_back(i);
+      // exercise
+      custom::BST <int> bst(values.begin(), values.end(), custom::sorted_tag);
+      // verify
+      assertUnit(bst.size() == 10000);
+      assertUnit(bst.numSlabAllocs() == 1);
+      assertUnit(bst.pPool && bst.pPool->pSlabs && bst.pPool->pSlabs->numSlabs > 1);
+      int expected = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         assertUnit(*it == expected++);
+      assertUnit(expected == 10000);
+      auto it = bst.find(9999);
+      assertUnit(it != bst.end());
+   }  // teardown
+
+   // a list that is not in order is inserted one value at a time
+   void test_constructInit_unsorted()
+   {  // setup
+      // exercise
+      custom::BST <int> bst = { 50, 30, 70 };
+      // verify
+      //            (50)
+      //        +----+----+
+      //      (30)      (70)
+      assertUnit(bst.numElements == 3);
+      assertUnit(bst.root && bst.root->data == 50);
+      if (!bst.root || !bst.root->pLeft || !bst.root->pRight)
+         return;
+      assertUnit(bst.root->pLeft->data == 30);
+      assertUnit(bst.root->pRight->data == 70);
+   }  // teardown
+
    /***************************************
     * MOVE CONSTRUCTOR
     ***************************************/
@@ -1074,6 +1473,106 @@ public:
       teardownStandardFixture(bst2);
    }
 
+   /***************************************
+    * ERASE RED-BLACK
+    *    BST::erase()
+    ***************************************/
+
+   // a black leaf whose sibling has a red far child: one rotation
+   void test_erase_blackLeafFarNephew()
+   {  // setup
+      //                 30
+      //          +-------+-------+
+      //        [10]              50
+      //                      +----+----+
+      //                     (40)      (60)
+      std::vector<int> values = { 10, 20, 30, 40, 50, 60 };
+      custom::BST <int> bst(values.begin(), values.end(), custom::sorted_tag);
+      auto it = bst.find(20);
+      bst.erase(it);
+      it = bst.find(10);
+      // exercise
+      auto itReturn = bst.erase(it);
+      // verify
+      //                 50
+      //          +-------+-------+
+      //          30              60
+      //          +----+
+      //              (40)
+      assertUnit(itReturn != bst.end() && *itReturn == 30);
+      assertUnit(bst.size() == 4);
+      assertUnit(bst.root && bst.root->data == 50);
+      if (!bst.root || !bst.root->pLeft || !bst.root->pRight || !bst.root->pLeft->pRight)
+         return;
+      assertUnit(bst.root->pParent == nullptr);
+      assertUnit(bst.root->isRed() == false);
+      assertUnit(bst.root->pLeft->data == 30);
+      assertUnit(bst.root->pLeft->isRed() == false);
+      assertUnit(bst.root->pLeft->pLeft == nullptr);
+      assertUnit(bst.root->pLeft->pRight->data == 40);
+      assertUnit(bst.root->pLeft->pRight->isRed() == true);
+      assertUnit(bst.root->pRight->data == 60);
+      assertUnit(bst.root->pRight->isRed() == false);
+      assertUnit(bst.root->verifyRedBlack(bst.root->findDepth()));
+   }  // teardown
+
+   // a black node with one red child: the child turns black
+   void test_erase_blackWithRedChild()
+   {  // setup
+      //                 30
+      //          +-------+-------+
+      //          10              50
+      //          +----+     +----+----+
+      //              (20) (40)      (60)
+      std::vector<int> values = { 10, 20, 30, 40, 50, 60 };
+      custom::BST <int> bst(values.begin(), values.end(), custom::sorted_tag);
+      auto it = bst.find(10);
+      // exercise
+      bst.erase(it);
+      // verify
+      assertUnit(bst.root && bst.root->pLeft && bst.root->pLeft->data == 20);
+      if (bst.root && bst.root->pLeft)
+         assertUnit(bst.root->pLeft->isRed() == false);
+      assertUnit(bst.root && bst.root->verifyRedBlack(bst.root->findDepth()));
+   }  // teardown
+
+   // after erasing nine keys in ten the tree is still red-black, so
+   // a find takes a logarithmic number of comparisons
+   void test_erase_ninetyPercent()
+   {  // setup
+      std::vector<Spy> values;
+      for (int i = 0; i < 20000; i++)
+         values.push_back(Spy(i));
+      custom::BST <Spy> bst(values.begin(), values.end(), custom::sorted_tag);
+      // exercise
+      for (int i = 0; i < 20000; i++)
+      {
+         int key = (i * 7919) % 20000;    // every key once, scattered
+         if (key % 10 == 0)
+            continue;
+         auto it = bst.find(Spy(key));
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(bst.size() == 2000);
+      assertUnit(bst.root && bst.root->computeSize() == 2000);
+      if (!bst.root)
+         return;
+      bst.root->verifyBTree();
+      assertUnit(bst.root->verifyRedBlack(bst.root->findDepth()));
+      // a red-black tree of 2000 is at most 2 log2(2001) < 22 high, and
+      // a find makes at most two comparisons per level
+      int maxCompares = 0;
+      for (int key = 0; key < 20000; key += 10)
+      {
+         Spy::reset();
+         auto it = bst.find(Spy(key));
+         assertUnit(it != bst.end());
+         maxCompares = std::max(maxCompares, Spy::numEquals() + Spy::numLessthan());
+      }
+      assertUnit(maxCompares <= 2 * 22);
+   }  // teardown
+
    /***************************************
     * CLEAR
     *    BST::clear()
@@ -1128,562 +1627,2950 @@ public:
       assertEmptyFixture(bst);
    }  // teardown
 
+   // clear a tree of trivially destructible nodes without visiting them
+   void test_clear_releaseSlabs()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i * 7 % 100);
+      assertUnit(bst.pPool != nullptr);
+      if (bst.pPool)
+         assertUnit(bst.pPool->size() == 100);
+      // exercise
+      bst.clear();
+      // verify
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.numElements == 0);
+      if (bst.pPool)
+         assertUnit(bst.pPool->size() == 0);
+   }  // teardown
+
+   // past the recycling limit, every element is destroyed once and
+   // the slabs go back whole
+   void test_clear_destroyThenRelease()
+   {  // setup
+      std::vector<Spy> values;
+      for (int i = 0; i < 1000; i++)
+         values.push_back(Spy(i));
+      custom::BST <Spy> bst(values.begin(), values.end(), custom::sorted_tag);
+      bst.limitRecycled(10);
+      Spy::reset();
+      // exercise
+      bst.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 1000);
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.pPool && bst.pPool->pSlabs == nullptr);
+      assertUnit(bst.numFreeNodes() == 0);
+   }  // teardown
+
+   // a tree far too deep to clear recursively
+   void test_clear_deepStick()
+   {  // setup
+      custom::BST <Spy> bst;
+      custom::BST <Spy>::BNode * pTail = nullptr;
+      for (int i = 0; i < 1000000; i++)
+      {
+         custom::BST <Spy>::BNode * pNode = new custom::BST <Spy>::BNode(Spy(-i));
+         if (pTail)
+         {
+            pTail->pLeft = pNode;
+            pNode->pParent = pTail;
+         }
+         else
+            bst.root = pNode;
+         pTail = pNode;
+      }
+      bst.numElements = 1000000;
+      Spy::reset();
+      // exercise
+      bst.clear();
+      // verify
+      assertUnit(Spy::numDestructor() == 1000000);
+      assertUnit(Spy::numDelete() == 1000000);
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.numElements == 0);
+   }  // teardown
+
    /***************************************
-    * Iterator
-    *     BST::begin()
-    *     BST::end()
-    *     BST::iterator::operator++()
-    *     BST::iterator::operator*()
+    * RELEASE ASYNC
+    *     BST::release_async()
     ***************************************/
 
-   // begin() from an empty BST
-   void test_begin_empty()
+   // the tree is empty at once and the elements die on the reclaimer
+   void test_releaseAsync_standard()
    {  // setup
-      custom::BST<Spy> bst;
-      custom::BST<Spy>::iterator it;
+      std::vector<Spy> values;
+      for (int i = 0; i < 100000; i++)
+         values.push_back(Spy(i));
+      custom::BST <Spy> bst(values.begin(), values.end(), custom::sorted_tag);
+      custom::Reclaimer::instance().drain();
       Spy::reset();
       // exercise
-      it = bst.begin();
+      bst.release_async();
       // verify
-      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
-      assertUnit(Spy::numEquals() == 0);      // does not look at any element
-      assertUnit(Spy::numDestructor() == 0);
-      assertUnit(Spy::numDelete() == 0);     
-      assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
-      assertUnit(Spy::numDefault() == 0);
-      assertUnit(Spy::numNondefault() == 0);
-      assertUnit(Spy::numCopyMove() == 0);
-      assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(it.pNode == nullptr);
-      assertUnit(it == bst.end());
-      assertEmptyFixture(bst);
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.numElements == 0);
+      assertUnit(bst.pPool == nullptr);
+      custom::Reclaimer::instance().drain();
+      assertUnit(Spy::numDestructor() == 100000);
    }  // teardown
 
-   // begin() from the standard fixture
-   void test_begin_standard()
+   // a tree handed over can be filled again right away
+   void test_releaseAsync_reuseTree()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 100000; i++)
+         values.push_back(i);
+      custom::BST <int> bst(values.begin(), values.end(), custom::sorted_tag);
+      // exercise
+      bst.release_async();
+      bst.insert(50);
+      // verify
+      assertUnit(bst.size() == 1);
+      assertUnit(bst.root && bst.root->data == 50);
+      assertUnit(bst.numSlabAllocs() == 1);
+      custom::Reclaimer::instance().drain();
+   }  // teardown
+
+   // nodes from other pools are not safe to free on another thread
+   void test_releaseAsync_foreignNodes()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
       custom::BST <Spy> bst;
       setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
+      custom::Reclaimer::instance().drain();
       Spy::reset();
       // exercise
-      it = bst.begin();
+      bst.release_async();
       // verify
-      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
-      assertUnit(Spy::numEquals() == 0);      // does not look at any element
-      assertUnit(Spy::numDestructor() == 0);
-      assertUnit(Spy::numDelete() == 0);
-      assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
-      assertUnit(Spy::numDefault() == 0);
-      assertUnit(Spy::numNondefault() == 0);
-      assertUnit(Spy::numCopyMove() == 0);
-      assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(it.pNode != nullptr);
-      assertUnit(bst.root != nullptr && bst.root->pLeft != nullptr);
-      if (it.pNode && bst.root && bst.root->pLeft)
-         assertUnit(it.pNode == bst.root->pLeft->pLeft);
-      if (it.pNode)
-         assertUnit(it.pNode->data == Spy(20));
-      assertStandardFixture(bst);
-      // teardown
-      teardownStandardFixture(bst);
-   }
+      assertUnit(Spy::numDestructor() == 7);
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.numElements == 0);
+   }  // teardown
 
-   // end() from the standard fixture.
-   void test_end_standard()
+   // a memory resource may not be thread-safe, so a pmr tree is cleared here
+   void test_releaseAsync_resource()
+   {  // setup
+      static unsigned char buffer[32 * 1024];
+      std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer),
+                                                   std::pmr::null_memory_resource());
+      custom::pmr::BST <Spy> bst(&resource);
+      for (int i = 0; i < 100; i++)
+         bst.insert(Spy(i));
+      custom::Reclaimer::instance().drain();
+      Spy::reset();
+      // exercise
+      bst.release_async();
+      // verify
+      assertUnit(Spy::numDestructor() == 100);
+      assertUnit(bst.root == nullptr);
+      assertUnit(bst.numElements == 0);
+      assertUnit(bst.pPool != nullptr);
+   }  // teardown
+
+   /***************************************
+    * NODE HANDLE
+    *     BST::extract()
+    *     BST::insert(node_type &&)
+    ***************************************/
+
+   // pull a node with two children out of the standard fixture
+   void test_extract_standard()
    {  // setup
       //                 50 
       //          +-------+-------+
-      //         30              70  
+      //      [[30]]             70  
       //     +----+----+     +----+----+
       //    20        40    60        80  
       custom::BST <Spy> bst;
       setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
+      auto p30 = bst.root->pLeft;
+      auto p40 = p30->pRight;
       Spy::reset();
       // exercise
-      it = bst.end();
+      auto node = bst.extract(custom::BST <Spy> ::iterator(p30));
       // verify
-      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
-      assertUnit(Spy::numEquals() == 0);      // does not look at any element
-      assertUnit(Spy::numDestructor() == 0);
-      assertUnit(Spy::numDelete() == 0);
-      assertUnit(Spy::numAssign() == 0);
+      //                 50 
+      //          +-------+-------+
+      //         40              70  
+      //     +----+          +----+----+
+      //    20              60        80  
       assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
-      assertUnit(Spy::numDefault() == 0);
-      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(!node.empty());
+      assertUnit(node.pNode == p30);
+      assertUnit(node.value() == Spy(30));
+      assertUnit(p30->pLeft == nullptr && p30->pRight == nullptr && p30->pParent == nullptr);
+      assertUnit(bst.numElements == 6);
+      assertUnit(bst.root->pLeft == p40);
+      assertUnit(p40->pParent == bst.root);
+      assertUnit(p40->pLeft && p40->pLeft->data == Spy(20));
+      assertUnit(p40->pRight == nullptr);
+      // teardown
+      bst.root->pLeft = p40->pLeft;
+      p40->pLeft->pParent = bst.root;
+      delete p40;
+      bst.numElements = 5;
+      bst.clear();
+   }
+
+   // a node handle keeps working after its tree is gone
+   void test_extract_outlivesTree()
+   {  // setup
+      custom::BST <Spy> ::node_type node;
+      {
+         custom::BST <Spy> bst;
+         bst.insert(Spy(50));
+         bst.insert(Spy(30));
+         // exercise
+         node = bst.extract(bst.find(Spy(30)));
+      }
+      // verify
+      assertUnit(!node.empty());
+      assertUnit(node.value() == Spy(30));
+      Spy::reset();
+      node = custom::BST <Spy> ::node_type();
+      assertUnit(node.empty());
+      assertUnit(Spy::numDestructor() == 1);
+      assertUnit(Spy::numDelete() == 1);
+   }  // teardown
+
+   // move an element between trees without copying anything
+   void test_insertNode_otherTree()
+   {  // setup
+      custom::BST <Spy> bstSrc;
+      custom::BST <Spy> bstDest;
+      bstSrc.insert(Spy(50));
+      bstDest.insert(Spy(40));
+      auto p50 = bstSrc.root;
+      Spy::reset();
+      // exercise
+      auto pairBST = bstDest.insert(bstSrc.extract(bstSrc.begin()));
+      // verify
+      //      (40)
+      //        +----+
+      //           (50)
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(pairBST.second == true);
+      assertUnit(pairBST.first == custom::BST <Spy> ::iterator(p50));
+      assertUnit(bstSrc.numElements == 0);
+      assertUnit(bstSrc.root == nullptr);
+      assertUnit(bstDest.numElements == 2);
+      assertUnit(bstDest.root->pRight == p50);
+      assertUnit(p50->pParent == bstDest.root);
+      assertUnit(bstDest.hasForeignNodes == true);
+   }  // teardown
+
+   // a duplicate stays in the handle when keeping things unique
+   void test_insertNode_keepUnique()
+   {  // setup
+      custom::BST <Spy> bstSrc;
+      custom::BST <Spy> bstDest;
+      bstSrc.insert(Spy(50));
+      bstDest.insert(Spy(50));
+      auto node = bstSrc.extract(bstSrc.begin());
+      // exercise
+      auto pairBST = bstDest.insert(std::move(node), true /* keepUnique */);
+      // verify
+      assertUnit(pairBST.second == false);
+      assertUnit(pairBST.first == bstDest.begin());
+      assertUnit(!node.empty());
+      assertUnit(bstDest.numElements == 1);
+   }  // teardown
+
+   /***************************************
+    * POOL
+    *     BST::Pool::allocate()
+    *     BST::Pool::release()
+    ***************************************/
+
+   // nodes inserted into one tree come from that tree's slab
+   void test_pool_insertShareSlab()
+   {  // setup
+      custom::BST <Spy> bst;
+      Spy::reset();
+      // exercise
+      bst.insert(Spy(50));
+      bst.insert(Spy(30));
+      bst.insert(Spy(70));
+      // verify
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      assertUnit(Spy::numCopyMove() == 3);   // move [50][30][70] into nodes
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(bst.numElements == 3);
+      assertUnit(bst.pPool != nullptr);
+      assertUnit(bst.root != nullptr);
+      if (bst.root && bst.root->pLeft && bst.root->pRight && bst.pPool)
+      {
+         using Pool = custom::BST<Spy>::Pool;
+         assertUnit(bst.pPool->size() == 3);
+         assertUnit(Pool::owner(bst.root) == bst.pPool);
+         assertUnit(Pool::owner(bst.root->pLeft) == bst.pPool);
+         assertUnit(Pool::owner(bst.root->pRight) == bst.pPool);
+         assertUnit(bst.root->pLeft->pParent == bst.root);
+         assertUnit(bst.root->pRight->pParent == bst.root);
+         assertUnit((char*)bst.root->pLeft == (char*)bst.root + sizeof(*bst.root));
+      }
+   }  // teardown
+
+   // a node freed by a tree is the next one handed out
+   void test_pool_eraseRecycle()
+   {  // setup
+      custom::BST <int> bst;
+      bst.insert(50);
+      bst.insert(30);
+      auto p30 = bst.root->pLeft;
+      auto it = custom::BST <int> ::iterator(p30);
+      // exercise
+      bst.erase(it);
+      auto pairBST = bst.insert(40);
+      // verify
+      assertUnit(pairBST.second == true);
+      assertUnit(bst.root->pLeft == p30);
+      assertUnit(bst.root->pLeft->data == 40);
+      assertUnit(bst.pPool->size() == 2);
+   }  // teardown
+
+   // steady erase/insert churn never goes back to the allocator
+   void test_pool_churnNoAllocs()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(1000 - i);   // a stick leaning left
+      size_t slabAllocs = bst.numSlabAllocs();
+      // exercise
+      for (int i = 0; i < 1000; i++)
+      {
+         auto it = bst.find(901);
+         bst.erase(it);
+         bst.insert(901);
+      }
+      // verify
+      assertUnit(bst.size() == 100);
+      assertUnit(bst.numSlabAllocs() == slabAllocs);
+      assertUnit(bst.numRecycled() == 1000);
+      assertUnit(bst.numFreeNodes() == 0);
+   }  // teardown
+
+   // nodes freed by clear() stay around until asked to go
+   void test_pool_shrinkToFit()
+   {  // setup
+      custom::BST <Spy> bst;
+      bst.limitRecycled(1000);
+      for (int i = 0; i < 1000; i++)
+         bst.insert(Spy(i));
+      bst.clear();
+      assertUnit(bst.numFreeNodes() == 1000);
+      assertUnit(bst.pPool && bst.pPool->pSlabs != nullptr);
+      // exercise
+      bst.shrink_to_fit();
+      // verify
+      assertUnit(bst.numFreeNodes() == 0);
+      assertUnit(bst.pPool && bst.pPool->pSlabs == nullptr);
+      bst.insert(Spy(1));
+      assertUnit(bst.size() == 1);
+   }  // teardown
+
+   // by default no more than a slab's worth of nodes is kept
+   void test_pool_limitRecycledDefault()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 10000; i++)
+         bst.insert(i);
+      // exercise
+      for (int i = 0; i < 10000; i++)
+      {
+         auto it = bst.find((i * 7919) % 10000);
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(bst.empty());
+      assertUnit(bst.numFreeNodes() <= custom::BST <int>::Pool::nodesPerSlab());
+   }  // teardown
+
+   // with no room on the free list, empty slabs go back right away
+   void test_pool_limitRecycled()
+   {  // setup
+      custom::BST <Spy> bst;
+      bst.limitRecycled(0);
+      for (int i = 0; i < 1000; i++)
+         bst.insert(Spy(i));
+      size_t slabAllocs = bst.numSlabAllocs();
+      // exercise
+      bst.clear();
+      // verify
+      assertUnit(slabAllocs > 1);
+      assertUnit(bst.pPool && bst.pPool->pSlabs == nullptr);
+      assertUnit(bst.numFreeNodes() == 0);
+   }  // teardown
+
+   // each run that empties goes back on its own, without a search
+   // through the others or their free nodes
+   void test_pool_limitRecycledScattered()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 20000; i++)
+         bst.insert((i * 7919) % 20000);
+      bst.limitRecycled(0);
+      size_t slabAllocs = bst.numSlabAllocs();
+      bst.pPool->numRunVisits = 0;
+      // exercise
+      for (int i = 0; i < 20000; i++)
+         bst.erase((i * 4999) % 20000);
+      // verify
+      assertUnit(bst.empty());
+      assertUnit(slabAllocs > 10);
+      assertUnit(bst.pPool->numRunVisits == slabAllocs);   // once each
+      assertUnit(bst.pPool->pSlabs == nullptr);
+      assertUnit(bst.numFreeNodes() == 0);
+   }  // teardown
+
+   // a node freed in an old run is found before a new slab is cut
+   void test_pool_recycleAnyRun()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 5000; i++)
+         bst.insert(i);
+      size_t slabAllocs = bst.numSlabAllocs();
+      while (bst.pPool->pBump != bst.pPool->pBumpEnd)
+         bst.insert(-1);
+      // exercise
+      bst.erase(10);
+      bst.erase(4000);
+      bst.insert(10);
+      bst.insert(4000);
+      // verify
+      assertUnit(bst.numSlabAllocs() == slabAllocs);
+      assertUnit(bst.numRecycled() == 2);
+      assertUnit(bst.numFreeNodes() == 0);
+   }  // teardown
+
+   // slabs that are not aligned to their size are refused
+   void test_pool_misalignedAllocator()
+   {  // setup
+      custom::BST <int, MisalignedAllocator<int> > bst;
+      bool threw = false;
+      // exercise
+      try
+      {
+         bst.insert(50);
+      }
+      catch (const std::bad_alloc &)
+      {
+         threw = true;
+      }
+      // verify
+      assertUnit(threw);
+      assertUnit(bst.empty());
+      assertUnit(bst.root == nullptr);
+   }  // teardown
+
+   // nodes made outside of any tree may be made on any thread
+   void test_pool_fallbackOtherThreads()
+   {  // setup
+      typedef custom::BST <long>::BNode BNode;
+      auto & pool = custom::BST <long>::Pool::fallback();
+      auto churn = []()
+      {
+         std::vector<BNode *> nodes;
+         for (int round = 0; round < 10; round++)
+         {
+            for (long i = 0; i < 1000; i++)
+               nodes.push_back(new BNode(i));
+            for (BNode * p : nodes)
+               delete p;
+            nodes.clear();
+         }
+      };
+      // exercise
+      std::thread other(churn);
+      churn();
+      other.join();
+      {
+         BNode * p = new BNode(0L);    // takes back what was freed
+         delete p;
+      }
+      pool.drain();
+      // verify
+      assertUnit(pool.size() == 0);
+   }  // teardown
+
+   // a tree on another thread frees nodes it adopted while their
+   // pool's own tree keeps allocating
+   void test_pool_foreignNodesOtherThread()
+   {  // setup
+      custom::BST <int> bstOwner;
+      custom::BST <int> bstAdopter;
+      for (int i = 0; i < 20000; i++)
+         bstOwner.insert(i);
+      for (int i = 0; i < 20000; i += 2)
+         bstAdopter.insert(bstOwner.extract(bstOwner.find(i)));
+      // exercise
+      std::thread adopter([&bstAdopter]()
+      {
+         for (int i = 0; i < 20000; i += 4)
+            bstAdopter.erase(i);
+         bstAdopter.clear();
+      });
+      for (int round = 0; round < 20; round++)
+      {
+         for (int i = 20000; i < 21000; i++)
+            bstOwner.insert(i);
+         for (int i = 20000; i < 21000; i++)
+            bstOwner.erase(i);
+      }
+      adopter.join();
+      bstOwner.pPool->drain();
+      // verify
+      assertUnit(bstAdopter.empty());
+      assertUnit(bstOwner.size() == 10000);
+      assertUnit(bstOwner.pPool->size() == 10000);
+      assertUnit(bstOwner.pPool->pRemote == nullptr);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN SORTED
+    *     BST::assign_sorted(first, last)
+    ***************************************/
+
+   // the old nodes are recycled for the new values
+   void test_assignSorted_standardToStandard()
+   {  // setup
+      std::vector<Spy> values = { Spy(20), Spy(30), Spy(40), Spy(50),
+                                  Spy(60), Spy(70), Spy(80) };
+      custom::BST <Spy> bst(values.begin(), values.begin() + 4, custom::sorted_tag);
+      size_t slabAllocs = bst.numSlabAllocs();
+      Spy::reset();
+      // exercise
+      bst.assign_sorted(values.begin(), values.end());
+      // verify
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numDestructor() == 4);
+      assertUnit(Spy::numCopy() == 7);
+      assertUnit(bst.numSlabAllocs() == slabAllocs);
+      assertUnit(bst.numRecycled() > 0);
+      assertStandardFixture(bst);
+   }  // teardown
+
+   /***************************************
+    * ASSIGN PARALLEL
+    *     BST::assign(rhs, policy)
+    ***************************************/
+
+   // the nodes already in the tree hold the new values, colors and all
+   void test_assignParallel_reuseNodes()
+   {  // setup
+      std::vector<int> valuesSrc  = { 11, 22, 33, 44 };
+      std::vector<int> valuesDest = { 10, 20, 30, 40, 50 };
+      custom::BST <int> bstSrc(valuesSrc.begin(), valuesSrc.end(), custom::sorted_tag);
+      custom::BST <int> bstDest(valuesDest.begin(), valuesDest.end(), custom::sorted_tag);
+      custom::BST <int>::BNode * pRoot = bstDest.root;
+      // exercise
+      bstDest.assign(bstSrc, std::execution::par);
+      // verify
+      //          (22)
+      //      +----+----+
+      //    (11)      (33)
+      //                +--+
+      //                  [44]
+      assertUnit(bstDest.size() == 4);
+      assertUnit(bstDest.root == pRoot);
+      assertUnit(bstDest.pPool && bstDest.pPool->size() == 4);
+      if (!bstDest.root || !bstDest.root->pRight || !bstDest.root->pRight->pRight)
+         return;
+      assertUnit(bstDest.root->data == 22);
+      assertUnit(bstDest.root->pLeft->data == 11);
+      assertUnit(bstDest.root->pRight->data == 33);
+      assertUnit(bstDest.root->pRight->pRight->data == 44);
+      assertUnit(bstDest.root->pRight->pRight->isRed() == true);
+      assertUnit(bstDest.root->pLeft->pLeft == nullptr);
+   }  // teardown
+
+   // the subtrees are copied three levels deep on other threads
+   // regardless of how many cores this machine has
+   void test_assignParallel_splitThreads()
+   {  // setup
+      std::vector<int> valuesSrc;
+      std::vector<int> valuesDest;
+      for (int i = 0; i < 50000; i++)
+         valuesSrc.push_back(i);
+      for (int i = 0; i < 20000; i++)
+         valuesDest.push_back(-i);
+      custom::BST <int> bstSrc(valuesSrc.begin(), valuesSrc.end(), custom::sorted_tag);
+      custom::BST <int> bstDest(valuesDest.rbegin(), valuesDest.rend(), custom::sorted_tag);
+      std::mutex poolLock;
+      // exercise
+      custom::BST <int>::assignSubtree(bstDest.root, bstSrc.root, bstDest.pool(),
+                                       poolLock, 3, bstSrc.size());
+      bstDest.numElements = bstSrc.numElements;
+      // verify
+      assertUnit(bstDest.pPool && bstDest.pPool->size() == 50000);
+      assertUnit(bstDest.root && bstDest.root->pParent == nullptr);
+      int expected = 0;
+      for (auto it = bstDest.begin(); it != bstDest.end(); ++it)
+         assertUnit(*it == expected++);
+      assertUnit(expected == 50000);
+   }  // teardown
+
+   /***************************************
+    * BUILD
+    *     BST::build(first, last, policy, keepUnique)
+    ***************************************/
+
+   // shuffled input becomes the standard fixture
+   void test_build_sequenced()
+   {  // setup
+      std::vector<Spy> values = { Spy(60), Spy(20), Spy(80), Spy(50),
+                                  Spy(30), Spy(70), Spy(40) };
+      custom::BST <Spy> bst;
+      Spy::reset();
+      // exercise
+      bst.build(values.begin(), values.end(), std::execution::seq);
+      // verify
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(bst.numSlabAllocs() == 1);
+      assertUnit(values[0] == Spy(60));    // the input is left alone
+      //                (50)
+      //          +-------+-------+
+      //        (30)            (70)
+      //     +----+----+     +----+----+
+      //   (20)      (40)  (60)      (80)
+      assertStandardFixture(bst);
+   }  // teardown
+
+   // only the first of each run of equal values is kept
+   void test_build_keepUnique()
+   {  // setup
+      std::vector<int> values = { 30, 10, 20, 30, 10, 10 };
+      custom::BST <int> bst;
+      // exercise
+      bst.build(values.begin(), values.end(), std::execution::par, true /* keepUnique */);
+      // verify
+      //            (20)
+      //        +----+----+
+      //      (10)      (30)
+      assertUnit(bst.size() == 3);
+      assertUnit(bst.root && bst.root->data == 20);
+      if (!bst.root || !bst.root->pLeft || !bst.root->pRight)
+         return;
+      assertUnit(bst.root->pLeft->data == 10);
+      assertUnit(bst.root->pRight->data == 30);
+   }  // teardown
+
+   // enough values to be split across threads
+   void test_build_parallel()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 100000; i++)
+         values.push_back((i * 7919) % 100000);   // every value once, out of order
+      custom::BST <int> bst;
+      bst.insert(-1);
+      // exercise
+      bst.build(values.begin(), values.end(), std::execution::par);
+      // verify
+      assertUnit(bst.size() == 100000);
+      assertUnit(bst.root && bst.root->pParent == nullptr);
+      int expected = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         assertUnit(*it == expected++);
+      assertUnit(expected == 100000);
+      assertUnit(bst.find(77777) != bst.end());
+      assertUnit(bst.pPool && bst.pPool->size() == 100000);
+      // the bump space left over in the run still serves insert()
+      size_t slabAllocs = bst.numSlabAllocs();
+      bst.insert(100000);
+      assertUnit(bst.numSlabAllocs() == slabAllocs);
+   }  // teardown
+
+   // the sort and the subtrees are split three levels deep regardless
+   // of how many cores this machine has
+   void test_build_splitThreads()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 50000; i++)
+         values.push_back((i * 7919) % 50000);
+      custom::BST <int> bst;
+      // exercise
+      custom::BST <int>::sortParallel(values.data(), values.data() + values.size(), 3);
+      void * pRun = bst.pool()->claim(values.size());
+      bst.root = custom::BST <int>::buildSlots(values.data(), 0, values.size(), 0,
+         custom::BST <int>::redDepthFor(values.size()), pRun, 3);
+      bst.numElements = values.size();
+      // verify
+      int expected = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         assertUnit(*it == expected++);
+      assertUnit(expected == 50000);
+      assertUnit(bst.root && bst.root->pParent == nullptr);
+      assertUnit(bst.root && bst.root->data == 24999);
+   }  // teardown
+
+   /***************************************
+    * NODE
+    *     BST::BNode::isRed()
+    *     BST::BNode::setRed()
+    ***************************************/
+
+   // the color costs no space of its own
+   void test_node_size()
+   {
+      assertUnit(sizeof(custom::BST<void*>::BNode) == 4 * sizeof(void*));
+      assertUnit(sizeof(custom::BST<int>::BNode) <= 4 * sizeof(void*));
+   }
+
+   // changing the parent keeps the color and vice versa
+   void test_node_colorSurvivesParent()
+   {  // setup
+      custom::BST<int>::BNode * p50 = new custom::BST<int>::BNode(50);
+      custom::BST<int>::BNode * p30 = new custom::BST<int>::BNode(30);
+      // exercise
+      p30->setRed(true);
+      p30->pParent = p50;
+      p50->pLeft = p30;
+      // verify
+      assertUnit(p30->isRed() == true);
+      assertUnit(p30->pParent == p50);
+      assertUnit(p30->pParent->pLeft == p30);
+      assertUnit(p50->isRed() == false);
+      p30->setRed(false);
+      assertUnit(p30->isRed() == false);
+      assertUnit(p30->pParent == p50);
+      p30->setRed(true);
+      p30->pParent = nullptr;
+      assertUnit(p30->isRed() == true);
+      assertUnit(p30->pParent == nullptr);
+      // teardown
+      delete p30;
+      delete p50;
+   }
+
+   /***************************************
+    * Iterator
+    *     BST::begin()
+    *     BST::end()
+    *     BST::iterator::operator++()
+    *     BST::iterator::operator*()
+    ***************************************/
+
+   // begin() from an empty BST
+   void test_begin_empty()
+   {  // setup
+      custom::BST<Spy> bst;
+      custom::BST<Spy>::iterator it;
+      Spy::reset();
+      // exercise
+      it = bst.begin();
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);     
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(it.pNode == nullptr);
+      assertUnit(it == bst.end());
+      assertEmptyFixture(bst);
+   }  // teardown
+
+   // begin() from the standard fixture
+   void test_begin_standard()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      Spy::reset();
+      // exercise
+      it = bst.begin();
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(it.pNode != nullptr);
+      assertUnit(bst.root != nullptr && bst.root->pLeft != nullptr);
+      if (it.pNode && bst.root && bst.root->pLeft)
+         assertUnit(it.pNode == bst.root->pLeft->pLeft);
+      if (it.pNode)
+         assertUnit(it.pNode->data == Spy(20));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // end() from the standard fixture.
+   void test_end_standard()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      Spy::reset();
+      // exercise
+      it = bst.end();
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(it.pNode == nullptr);
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // increment where the next node is the parent
+   void test_iterator_increment_standardToParent()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //  [[20]]      40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      it.pNode = bst.root->pLeft->pLeft;
+      Spy::reset();
+      // exercise
+      ++it;
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //                 50 
+      //          +-------+-------+
+      //       [[30]]            70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      assertUnit(it.pNode != nullptr);
+      assertUnit(bst.root != nullptr);
+      if (bst.root)
+         assertUnit(it.pNode == bst.root->pLeft);
+      if (it.pNode)
+         assertUnit(it.pNode->data == Spy(30));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+
+   // increment where the next node is the right child
+   void test_iterator_increment_standardToChild()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //       [[30]]            70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      it.pNode = bst.root->pLeft; // 30
+      Spy::reset();
+      // exercise
+      ++it;
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20      [[40]]  60        80  
+      assertUnit(it.pNode != nullptr);
+      assertUnit(bst.root != nullptr && bst.root->pLeft != nullptr);
+      if (bst.root && bst.root->pLeft)
+         assertUnit(it.pNode == bst.root->pLeft->pRight);
+      if (it.pNode)
+         assertUnit(it.pNode->data == Spy(40));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // increment where the next node is grandma
+   void test_iterator_increment_standardToGrandma()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20      [[40]]  60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      it.pNode = bst.root->pLeft->pRight; // 40
+      Spy::reset();
+      // exercise
+      ++it;
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //               [[50]] 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      assertUnit(it.pNode == bst.root);
+      if (it.pNode)
+         assertUnit(it.pNode->data == Spy(50));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // increment where the next node is the right grandchild
+   void test_iterator_increment_standardToGrandchild()
+   {  // setup
+      //               [[50]] 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      it.pNode = bst.root; // 50
+      Spy::reset();
+      // exercise
+      ++it;
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40  [[60]]      80  
+      assertUnit(it.pNode != nullptr);
+      assertUnit(bst.root != nullptr && bst.root->pRight != nullptr);
+      if (bst.root && bst.root->pRight)
+         assertUnit(it.pNode == bst.root->pRight->pLeft);
+      if (it.pNode)
+         assertUnit(it.pNode->data == Spy(60));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // increment where we are already at the last node
+   void test_iterator_increment_standardToDone()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60      [[80]]  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      it.pNode = bst.root->pRight->pRight; // 80
+      Spy::reset();
+      // exercise
+      ++it;
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      assertUnit(it.pNode == nullptr);
+      assertUnit(it == bst.end());
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // increment where we are already at the end
+   void test_iterator_increment_standardEnd()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      it.pNode = nullptr; 
+      Spy::reset();
+      // exercise
+      ++it;
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      assertUnit(it.pNode == nullptr);
+      assertUnit(it == bst.end());
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // decrement from the end to the largest element
+   void test_iterator_decrement_standardEnd()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      auto it = bst.end();
+      Spy::reset();
+      // exercise
+      --it;
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(it != bst.end() && *it == Spy(80));
+      --it;
+      assertUnit(it != bst.end() && *it == Spy(70));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // an empty tree has nothing to back up to
+   void test_iterator_decrement_emptyEnd()
+   {  // setup
+      custom::BST <Spy> bst;
+      auto it = bst.end();
+      // exercise
+      --it;
+      // verify
+      assertUnit(it == bst.end());
+   }  // teardown
+
+   // itereator dereference were we just read
+   void test_iterator_dereference_standardRead()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20      [[40]]  60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      it.pNode = bst.root->pLeft->pRight;
+      Spy s(99);
+      Spy::reset();
+      // exercise
+      s = *it;
+      // verify
+      assertUnit(Spy::numAssign() == 1);      // assign the results to s
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(s == Spy(40));
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   /***************************************
+    * Find
+    *    BST::find(const T &)
+    ***************************************/
+
+   // attempt to find something in an empty BST
+   void test_find_empty()
+   {  // setup
+      custom::BST<Spy> bst;
+      custom::BST<Spy>::iterator it;
+      Spy s(50);
+      Spy::reset();
+      // exercise
+      it = bst.find(s);
+      // verify
+      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
+      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(it == bst.end());
+      assertEmptyFixture(bst);
+   }  // teardown
+   
+   // attemp to find something where it is at the beginning
+   void test_find_standardBegin()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      Spy s(20);
+      Spy::reset();
+      // exercise
+      it = bst.find(s);
+      // verify
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numLessthan() == 4);    // compare [50][30][20] and check [20]
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //  [[20]]      40    60        80  
+      assertUnit(it.pNode != nullptr);
+      if (it.pNode)
+         assertUnit(*it == Spy(20));
+      assertUnit(bst.root != nullptr && bst.root->pLeft != nullptr);
+      if (bst.root && bst.root->pLeft)
+         assertUnit(it.pNode == bst.root->pLeft->pLeft);
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+   
+   // attempt to find something where it is the last element
+   void test_find_standardLast()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      Spy s(80);
+      Spy::reset();
+      // exercise
+      it = bst.find(s);
+      // verify
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numLessthan() == 4);    // compare [50][70][80] and check [80]
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60      [[80]]
+      assertUnit(it.pNode != nullptr);
+      if (it.pNode)
+         assertUnit(*it == Spy(80));
+      assertUnit(bst.root != nullptr && bst.root->pRight != nullptr);
+      if (bst.root && bst.root->pRight)
+         assertUnit(it.pNode == bst.root->pRight->pRight);
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // attempt to find something where it is not there
+   void test_find_standardMissing()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      custom::BST<Spy>::iterator it;
+      Spy s(42);
+      Spy::reset();
+      // exercise
+      it = bst.find(s);
+      // verify
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numLessthan() == 4);    // compare [50][30][40] and check [50]
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(it == bst.end());
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+
+
+   // a hit or a miss deep in a big tree costs one comparison a level
+   void test_find_oneComparePerLevel()
+   {  // setup
+      std::vector<Spy> values;
+      for (int i = 0; i < 1023; i++)
+         values.push_back(Spy(i * 2));
+      custom::BST <Spy> bst(values.begin(), values.end(), custom::sorted_tag);
+      Spy hit(0);
+      Spy miss(1);
+      Spy::reset();
+      // exercise
+      auto itHit = bst.find(hit);
+      auto itMiss = bst.find(miss);
+      // verify
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numLessthan() == 11 + 11);  // 10 levels and a check, each
+      assertUnit(itHit != bst.end() && *itHit == Spy(0));
+      assertUnit(itMiss == bst.end());
+   }  // teardown
+
+   // a three-way comparator stops at the first match
+   void test_find_threeWay()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy, std::allocator<Spy>, custom::RedBlack, SpyThreeWay> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(Spy(value));
+      Spy s50(50);
+      Spy s20(20);
+      Spy s42(42);
+      Spy::reset();
+      SpyThreeWay::numCalls = 0;
+      // exercise
+      auto it50 = bst.find(s50);
+      size_t numCalls50 = SpyThreeWay::numCalls;
+      auto it20 = bst.find(s20);
+      size_t numCalls20 = SpyThreeWay::numCalls - numCalls50;
+      auto it42 = bst.find(s42);
+      size_t numCalls42 = SpyThreeWay::numCalls - numCalls50 - numCalls20;
+      // verify
+      assertUnit(numCalls50 == 1);   // [50]
+      assertUnit(numCalls20 == 3);   // [50][30][20]
+      assertUnit(numCalls42 == 3);   // [50][30][40]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(it50.pNode == bst.root);
+      assertUnit(it20 == bst.begin());
+      assertUnit(it42 == bst.end());
+   }  // teardown
+
+   // a three-way comparator knows the element is there on the way down
+   void test_insert_threeWayKeepUnique()
+   {  // setup
+      custom::BST <Spy, std::allocator<Spy>, custom::RedBlack, SpyThreeWay> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(Spy(value));
+      Spy s(40);
+      SpyThreeWay::numCalls = 0;
+      // exercise
+      auto pairBST = bst.insert(s, true /* keepUnique */);
+      // verify
+      assertUnit(SpyThreeWay::numCalls == 4);   // [80][50][30][40]
+      assertUnit(pairBST.second == false);
+      assertUnit(pairBST.first != bst.end() && *pairBST.first == Spy(40));
+      assertUnit(bst.size() == 7);
+   }  // teardown
+
+   // a less-than that returns an int is still a less-than
+   void test_insert_intLessThan()
+   {  // setup
+      struct IntLess
+      {
+         int operator () (int lhs, int rhs) const { return lhs < rhs; }
+      };
+      custom::BST <int, std::allocator<int>, custom::RedBlack, IntLess> bst;
+      // exercise
+      for (int value : { 5, 3, 8, 1, 4 })
+         bst.insert(value);
+      // verify
+      //            (5)
+      //       +-----+-----+
+      //      (3)         (8)
+      //    +--+--+
+      //   (1)   (4)
+      int expected[] = { 1, 3, 4, 5, 8 };
+      size_t i = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it, ++i)
+         assertUnit(i < 5 && *it == expected[i]);
+      assertUnit(i == 5);
+      assertUnit(bst.find(4) != bst.end() && *bst.find(4) == 4);
+      assertUnit(bst.find(2) == bst.end());
+   }  // teardown
+
+   /***************************************
+    * Find Batch
+    *    BST::find_batch(keys, num, out)
+    ***************************************/
+
+   // nothing to find in an empty tree, and nothing looked at
+   void test_findBatch_empty()
+   {  // setup
+      custom::BST<Spy> bst;
+      Spy keys[3] = { Spy(10), Spy(20), Spy(30) };
+      custom::BST<Spy>::iterator out[3];
+      Spy::reset();
+      // exercise
+      bst.find_batch(keys, 3, out);
+      // verify
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numEquals() == 0);
+      for (auto & it : out)
+         assertUnit(it == bst.end());
+      assertEmptyFixture(bst);
+   }  // teardown
+
+   // hits and misses together make the same comparisons as find() would
+   void test_findBatch_standard()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy keys[4] = { Spy(20), Spy(42), Spy(50), Spy(80) };
+      custom::BST<Spy>::iterator out[4];
+      Spy::reset();
+      // exercise
+      bst.find_batch(keys, 4, out);
+      // verify
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numLessthan() == 4 + 4 + 4 + 4);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(bst.root && bst.root->pLeft && out[0].pNode == bst.root->pLeft->pLeft);
+      assertUnit(out[1] == bst.end());
+      assertUnit(out[2].pNode == bst.root);
+      assertUnit(bst.root && bst.root->pRight && out[3].pNode == bst.root->pRight->pRight);
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // more keys than one group, of walks of different lengths
+   void test_findBatch_manyGroups()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 1000; i += 2)
+         bst.insert((i * 7919) % 1000);
+      std::vector<int> keys;
+      for (int i = 0; i < 101; i++)
+         keys.push_back((i * 37) % 1000);
+      std::vector<custom::BST <int>::iterator> out(keys.size());
+      // exercise
+      bst.find_batch(keys.data(), keys.size(), out.data());
+      // verify
+      for (size_t i = 0; i < keys.size(); i++)
+         assertUnit(out[i] == bst.find(keys[i]));
+   }  // teardown
+
+   /***************************************
+    * Lookup by value
+    *    BST::count(const T &)
+    *    BST::erase(const T &)
+    *    ... and with a transparent comparator,
+    *    the same taking anything it compares
+    ***************************************/
+
+   // count and contains see every copy of a duplicate
+   void test_count_duplicates()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 40; i++)
+         bst.insert(i % 10);
+      // exercise and verify
+      assertUnit(bst.count(7) == 4);
+      assertUnit(bst.count(0) == 4);
+      assertUnit(bst.count(10) == 0);
+      assertUnit(bst.count(-1) == 0);
+      assertUnit(bst.contains(9));
+      assertUnit(!bst.contains(10));
+   }  // teardown
+
+   // erasing a value erases every copy of it
+   void test_eraseValue_duplicates()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 40; i++)
+         bst.insert(i % 10);
+      // exercise
+      size_t numErased = bst.erase(7);
+      size_t numMissing = bst.erase(10);
+      // verify
+      assertUnit(numErased == 4);
+      assertUnit(numMissing == 0);
+      assertUnit(bst.size() == 36);
+      assertUnit(!bst.contains(7));
+      assertUnit(bst.count(6) == 4);
+      assertUnit(bst.count(8) == 4);
+      assertUnit(bst.root && bst.root->verifyRedBlack(bst.root->findDepth()));
+   }  // teardown
+
+   // find by an int in a tree of Spys makes no Spy
+   void test_find_transparent()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy, std::allocator<Spy>, custom::RedBlack, SpyByValue> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(Spy(value));
+      Spy::reset();
+      // exercise
+      auto it20 = bst.find(20);
+      auto it42 = bst.find(42);
+      // verify
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(it20 == bst.begin());
+      assertUnit(it42 == bst.end());
+   }  // teardown
+
+   // the first element not less than an int
+   void test_lowerBound_transparent()
+   {  // setup
+      custom::BST <Spy, std::allocator<Spy>, custom::RedBlack, SpyByValue> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(Spy(value));
+      Spy::reset();
+      // exercise
+      auto it42 = bst.lower_bound(42);
+      auto it50 = bst.lower_bound(50);
+      auto it10 = bst.lower_bound(10);
+      auto it90 = bst.lower_bound(90);
+      // verify
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(it42 != bst.end() && (*it42).get() == 50);
+      assertUnit(it50 != bst.end() && (*it50).get() == 50);
+      assertUnit(it10 == bst.begin());
+      assertUnit(it90 == bst.end());
+   }  // teardown
+
+   // count and contains by an int make no Spy
+   void test_count_transparent()
+   {  // setup
+      custom::BST <Spy, std::allocator<Spy>, custom::RedBlack, SpyByValue> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80, 40 })
+         bst.insert(Spy(value));
+      Spy::reset();
+      // exercise
+      size_t num40 = bst.count(40);
+      size_t num42 = bst.count(42);
+      bool has80 = bst.contains(80);
+      bool has10 = bst.contains(10);
+      // verify
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(num40 == 2);
+      assertUnit(num42 == 0);
+      assertUnit(has80);
+      assertUnit(!has10);
+   }  // teardown
+
+   // erase by an int makes no Spy
+   void test_erase_transparent()
+   {  // setup
+      custom::BST <Spy, std::allocator<Spy>, custom::RedBlack, SpyByValue> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(Spy(value));
+      Spy::reset();
+      // exercise
+      size_t num30 = bst.erase(30);
+      size_t num42 = bst.erase(42);
+      // verify
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numDelete() == 1);
+      assertUnit(num30 == 1);
+      assertUnit(num42 == 0);
+      assertUnit(bst.size() == 6);
+      assertUnit(!bst.contains(30));
+   }  // teardown
+
+   // std::less<> finds a string by a string_view or a C string
+   void test_find_stringView()
+   {  // setup
+      custom::BST <std::string, std::allocator<std::string>, custom::RedBlack, std::less<> > bst;
+      for (const char * fruit : { "pear", "apple", "fig", "kiwi", "plum" })
+         bst.insert(fruit);
+      // exercise
+      auto itFig = bst.find(std::string_view("fig"));
+      auto itKiwi = bst.find("kiwi");
+      auto itLime = bst.find("lime");
+      size_t numErased = bst.erase(std::string_view("plum"));
+      // verify
+      assertUnit(itFig != bst.end() && *itFig == "fig");
+      assertUnit(itKiwi != bst.end() && *itKiwi == "kiwi");
+      assertUnit(itLime == bst.end());
+      assertUnit(numErased == 1);
+      assertUnit(bst.size() == 4);
+   }  // teardown
+
+   /***************************************
+    * Range queries
+    *    BST::lower_bound(const T &)
+    *    BST::upper_bound(const T &)
+    *    BST::equal_range(const T &)
+    *    BST::for_each_in_range(lo, hi, fn)
+    ***************************************/
+
+   // the first element not less, one comparison a level
+   void test_lowerBound_standard()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy s40(40);
+      Spy s42(42);
+      Spy s90(90);
+      Spy::reset();
+      // exercise
+      auto it40 = bst.lower_bound(s40);
+      auto it42 = bst.lower_bound(s42);
+      auto it90 = bst.lower_bound(s90);
+      // verify
+      assertUnit(Spy::numLessthan() == 3 + 3 + 3);   // [50][30][40] each time
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(it40 != bst.end() && *it40 == Spy(40));
+      assertUnit(it42 != bst.end() && *it42 == Spy(50));
+      assertUnit(it90 == bst.end());
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // the first element greater
+   void test_upperBound_standard()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy s40(40);
+      Spy s10(10);
+      Spy s80(80);
+      Spy::reset();
+      // exercise
+      auto it40 = bst.upper_bound(s40);
+      auto it10 = bst.upper_bound(s10);
+      auto it80 = bst.upper_bound(s80);
+      // verify
+      assertUnit(Spy::numLessthan() == 3 + 3 + 3);   // one a level each time
+      assertUnit(it40 != bst.end() && *it40 == Spy(50));
+      assertUnit(it10 == bst.begin());
+      assertUnit(it80 == bst.end());
+      assertStandardFixture(bst);
+      // teardown
+      teardownStandardFixture(bst);
+   }
+
+   // the last element not greater than a value past them all
+   void test_upperBound_backFromEnd()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert((i * 37) % 100);
+      // exercise
+      auto it = bst.upper_bound(500);
+      --it;
+      // verify
+      assertUnit(it != bst.end() && *it == 99);
+      bst.erase(it);
+      it = bst.upper_bound(99);
+      --it;
+      assertUnit(it != bst.end() && *it == 98);
+   }  // teardown
+
+   // every copy of a duplicate is in the range
+   void test_equalRange_duplicates()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i % 10);
+      // exercise
+      auto range = bst.equal_range(7);
+      // verify
+      int num = 0;
+      for (auto it = range.first; it != range.second; ++it, ++num)
+         assertUnit(*it == 7);
+      assertUnit(num == 10);
+      assertUnit(range.second != bst.end() && *range.second == 8);
+      --range.first;
+      assertUnit(*range.first == 6);
+   }  // teardown
+
+   // a value that is not there gives an empty range where it would go
+   void test_equalRange_missing()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i * 2);
+      // exercise
+      auto range = bst.equal_range(51);
+      auto rangeEnd = bst.equal_range(500);
+      // verify
+      assertUnit(range.first == range.second);
+      assertUnit(range.first != bst.end() && *range.first == 52);
+      assertUnit(rangeEnd.first == bst.end());
+      assertUnit(rangeEnd.second == bst.end());
+   }  // teardown
+
+   // from a bound, the iterator can walk back to the beginning
+   void test_lowerBound_walkBack()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert((i * 37) % 100);
+      auto it = bst.lower_bound(99);
+      std::vector<int> values;
+      // exercise
+      while (it != bst.end())
+         values.push_back(*it--);
+      // verify
+      assertUnit(values.size() == 100);
+      for (int i = 0; i < (int)values.size(); i++)
+         assertUnit(values[i] == 99 - i);
+   }  // teardown
+
+   // a window in a big tree costs a descent and a comparison each
+   void test_forEachInRange_window()
+   {  // setup
+      std::vector<Spy> values;
+      for (int i = 0; i < 1023; i++)
+         values.push_back(Spy(i));
+      custom::BST <Spy> bst(values.begin(), values.end(), custom::sorted_tag);
+      Spy lo(500);
+      Spy hi(520);
+      std::vector<int> window;
+      Spy::reset();
+      // exercise
+      bst.for_each_in_range(lo, hi, [&window](const Spy & s) { window.push_back(s.get()); });
+      // verify
+      assertUnit(Spy::numLessthan() == 10 + 21);  // a descent, then [500] .. [520]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(window.size() == 20);
+      for (int i = 0; i < (int)window.size(); i++)
+         assertUnit(window[i] == 500 + i);
+   }  // teardown
+
+   // nothing between, nothing called
+   void test_forEachInRange_empty()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i * 2);
+      int numEmpty = 0;
+      int numBackwards = 0;
+      int numPastEnd = 0;
+      // exercise
+      bst.for_each_in_range(51, 52, [&numEmpty](int) { numEmpty++; });
+      bst.for_each_in_range(60, 40, [&numBackwards](int) { numBackwards++; });
+      bst.for_each_in_range(500, 600, [&numPastEnd](int) { numPastEnd++; });
+      // verify
+      assertUnit(numEmpty == 0);
+      assertUnit(numBackwards == 0);
+      assertUnit(numPastEnd == 0);
+   }  // teardown
+
+   // a window given by ints over a tree of Spys makes no Spy
+   void test_forEachInRange_transparent()
+   {  // setup
+      custom::BST <Spy, std::allocator<Spy>, custom::RedBlack, SpyByValue> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(Spy(value));
+      std::vector<int> window;
+      Spy::reset();
+      // exercise
+      bst.for_each_in_range(25, 65, [&window](const Spy & s) { window.push_back(s.get()); });
+      auto it = bst.upper_bound(60);
+      // verify
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(window == std::vector<int>({ 30, 40, 50, 60 }));
+      assertUnit(it != bst.end() && (*it).get() == 70);
+   }  // teardown
+
+   /***************************************
+    * Insert
+    *    BST::insert(const T &)
+    ***************************************/
+
+   // insert an element to the right of a single-element tree
+   void test_insert_oneRight()
+   {  // setup
+      //            (50) 
+      custom::BST <Spy> bst;
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      bst.root = p50;
+      bst.numElements = 1;
+      Spy s(60);
+      Spy::reset();
+      // exercise
+      auto pairBST = bst.insert(s);
+      // verify
+      assertUnit(Spy::numLessthan() == 1);    // compare [50]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [60]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [60]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(it.pNode == nullptr);
+      assertUnit(pairBST.first != bst.end());
+      assertUnit(pairBST.second = true);
+      if (pairBST.first != bst.end())
+         assertUnit(*(pairBST.first) == Spy(60));
+      //           (50) 
+      //             +----+
+      //                 (60) 
+      assertUnit(bst.size() == 2);
+      assertUnit(bst.numElements == 2);
+      assertUnit(bst.root == p50);
+
+      assertUnit(p50 != nullptr);
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->pLeft == nullptr);
+         assertUnit(p50->pRight != nullptr);
+         assertUnit(p50->pParent == nullptr);
+      }
+      if (p50 && p50->pRight)
+      {
+         assertUnit(p50->pRight->data == Spy(60));
+         assertUnit(p50->pRight->pLeft == nullptr);
+         assertUnit(p50->pRight->pRight == nullptr);
+         assertUnit(p50->pRight->pParent == p50);
+      }
+      // teardown
+      if (p50 && p50->pRight && p50->pRight != p50)
+         delete p50->pRight;
+      if (p50)
+         delete p50;
+      bst.root = nullptr;
+      bst.numElements = 0;
+   }
+
+   // insert an element to the left of a single-element tree
+   void test_insert_oneLeft()
+   {  // setup
+      //            (50) 
+      custom::BST <Spy> bst;
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      bst.root = p50;
+      bst.numElements = 1;
+      Spy s(40);
+      Spy::reset();
+      // exercise
+      auto pairBST = bst.insert(s);
+      // verify
+      assertUnit(Spy::numLessthan() == 1);    // compare [50]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [40]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [40]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(pairBST.first != bst.end());
+      assertUnit(pairBST.second = true);
+      if (pairBST.first != bst.end())
+         assertUnit(*(pairBST.first) == Spy(40));
+
+      //           (50) 
+      //        +----+
+      //      (40) 
+      assertUnit(bst.size() == 2);
+      assertUnit(bst.numElements == 2);
+      assertUnit(bst.root == p50);
+
+      assertUnit(p50 != nullptr);
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->pLeft != nullptr);
+         assertUnit(p50->pRight == nullptr);
+         assertUnit(p50->pParent == nullptr);
+      }
+
+      if (p50 && p50->pLeft)
+      {
+         assertUnit(p50->pLeft->data == Spy(40));
+         assertUnit(p50->pLeft->pLeft == nullptr);
+         assertUnit(p50->pLeft->pRight == nullptr);
+         assertUnit(p50->pLeft->pParent == p50);
+      }
+
+      // teardown
+      if (p50 && p50->pLeft && p50->pLeft != p50)
+         delete p50->pLeft;
+      if (p50)
+         delete p50;
+      bst.root = nullptr;
+      bst.numElements = 0;
+   }
+
+   // insert a duplicate item in a BST
+   void test_insert_duplicate()
+   {  // setup
+      //            (50) 
+      custom::BST <Spy> bst;
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      bst.root = p50;
+      bst.numElements = 1;
+      Spy s(50);
+      Spy::reset();
+      // exercise
+      auto pairBST = bst.insert(s, false /* keepUnique */);
+      // verify
+      assertUnit(Spy::numLessthan() == 1);    // compare [50]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [50]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [50]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(pairBST.first != bst.end());
+      assertUnit(pairBST.second = true);
+      if (pairBST.first != bst.end())
+         assertUnit(*(pairBST.first) == Spy(50));
+      //           (50) 
+      //        +----+
+      //      (50r)
+      assertUnit(bst.size() == 2);
+      assertUnit(bst.numElements == 2);
+      assertUnit(bst.root == p50);
+
+      assertUnit(p50 != nullptr);
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->pLeft == nullptr);
+         assertUnit(p50->pRight != nullptr);
+         assertUnit(p50->pParent == nullptr);
+      }
+
+      if (p50 && p50->pRight)
+      {
+         assertUnit(p50->pRight->data == Spy(50));
+         assertUnit(p50->pRight->pLeft == nullptr);
+         assertUnit(p50->pRight->pRight == nullptr);
+         assertUnit(p50->pRight->pParent == p50);
+      }
+
+      // teardown
+      if (p50 && p50->pRight && p50->pRight != p50)
+         delete p50->pRight;
+      if (p50)
+         delete p50;
+      bst.root = nullptr;
+      bst.numElements = 0;
+   }
+
+   // insert an item when it already exists
+   void test_insert_keepUnique()
+   {  // setup
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      Spy s(40);
+      Spy::reset();
+      // exercise
+      auto pairBST = bst.insert(s, true /* keepUnique */);
+      // verify
+      assertUnit(Spy::numLessthan() == 5);    // try [80], compare [50][30][40] and check [40]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(pairBST.first != bst.end());
+      assertUnit(pairBST.second == false);
+      if (pairBST.first != bst.end())
+         assertUnit(*(pairBST.first) == Spy(40));
+      //                 50 
+      //          +-------+-------+
+      //         30              70  
+      //     +----+----+     +----+----+
+      //    20        40    60        80  
       assertStandardFixture(bst);
       // teardown
-      teardownStandardFixture(bst);
+      teardownStandardFixture(bst);
+   }
+
+
+
+
+   /***************************************
+    * Insert Move
+    *    BST::insert(T &&)
+    ***************************************/
+
+    // insert an element to the right of a single-element tree
+   void test_insertMove_oneRight()
+   {  // setup
+      //            (50) 
+      custom::BST <Spy> bst;
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      bst.root = p50;
+      bst.numElements = 1;
+      Spy s(60);
+      Spy::reset();
+      // exercise
+      auto pairBST = bst.insert(std::move(s));
+      // verify
+      assertUnit(Spy::numLessthan() == 1);    // compare [50]
+      assertUnit(Spy::numCopyMove() == 1);    // assign move [60]
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numDestructor() == 0);
+      assertUnit(Spy::numDelete() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numNondefault() == 0);
+      assertUnit(pairBST.first != bst.end());
+      assertUnit(pairBST.second = true);
+      if (pairBST.first != bst.end())
+         assertUnit(*(pairBST.first) == Spy(60));
+      //           (50) 
+      //             +----+
+      //                 (60) 
+      assertUnit(bst.size() == 2);
+      assertUnit(bst.numElements == 2);
+      assertUnit(bst.root == p50);
+
+      assertUnit(p50 != nullptr);
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->pLeft == nullptr);
+         assertUnit(p50->pRight != nullptr);
+         assertUnit(p50->pParent == nullptr);
+      }
+      if (p50 && p50->pRight)
+      {
+         assertUnit(p50->pRight->data == Spy(60));
+         assertUnit(p50->pRight->pLeft == nullptr);
+         assertUnit(p50->pRight->pRight == nullptr);
+         assertUnit(p50->pRight->pParent == p50);
+      }
+      // teardown
+      if (p50 && p50->pRight && p50->pRight != p50)
+         delete p50->pRight;
+      if (p50)
+         delete p50;
+      bst.root = nullptr;
+      bst.numElements = 0;
    }
 
-   // increment where the next node is the parent
-   void test_iterator_increment_standardToParent()
+   // insert an element to the left of a single-element tree
+   void test_insertMove_oneLeft()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //  [[20]]      40    60        80  
+      //            (50) 
       custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
-      it.pNode = bst.root->pLeft->pLeft;
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      bst.root = p50;
+      bst.numElements = 1;
+      Spy s(40);
       Spy::reset();
       // exercise
-      ++it;
+      auto pairBST = bst.insert(std::move(s));
       // verify
-      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
-      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numLessthan() == 1);    // compare [50]
+      assertUnit(Spy::numCopyMove() == 1);    // assign move [40]
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);   
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
-      assertUnit(Spy::numCopyMove() == 0);
-      assertUnit(Spy::numAssignMove() == 0);
-      //                 50 
-      //          +-------+-------+
-      //       [[30]]            70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
-      assertUnit(it.pNode != nullptr);
-      assertUnit(bst.root != nullptr);
-      if (bst.root)
-         assertUnit(it.pNode == bst.root->pLeft);
-      if (it.pNode)
-         assertUnit(it.pNode->data == Spy(30));
-      assertStandardFixture(bst);
+      assertUnit(s.empty() == true);
+      assertUnit(pairBST.first != bst.end());
+      assertUnit(pairBST.second = true);
+      if (pairBST.first != bst.end())
+         assertUnit(*(pairBST.first) == Spy(40));
+
+      //           (50) 
+      //        +----+
+      //      (40) 
+      assertUnit(bst.size() == 2);
+      assertUnit(bst.numElements == 2);
+      assertUnit(bst.root == p50);
+
+      assertUnit(p50 != nullptr);
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->pLeft != nullptr);
+         assertUnit(p50->pRight == nullptr);
+         assertUnit(p50->pParent == nullptr);
+      }
+
+      if (p50 && p50->pLeft)
+      {
+         assertUnit(p50->pLeft->data == Spy(40));
+         assertUnit(p50->pLeft->pLeft == nullptr);
+         assertUnit(p50->pLeft->pRight == nullptr);
+         assertUnit(p50->pLeft->pParent == p50);
+      }
+
       // teardown
-      teardownStandardFixture(bst);
+      if (p50 && p50->pLeft && p50->pLeft != p50)
+         delete p50->pLeft;
+      if (p50)
+         delete p50;
+      bst.root = nullptr;
+      bst.numElements = 0;
    }
 
-
-   // increment where the next node is the right child
-   void test_iterator_increment_standardToChild()
+   // insert a duplicate item in a BST
+   void test_insertMove_duplicate()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //       [[30]]            70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
+      //            (50) 
       custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
-      it.pNode = bst.root->pLeft; // 30
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      bst.root = p50;
+      bst.numElements = 1;
+      Spy s(50);
       Spy::reset();
       // exercise
-      ++it;
+      auto pairBST = bst.insert(std::move(s), false /* keepUnique */);
       // verify
-      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
-      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numLessthan() == 1);    // compare [50]
+      assertUnit(Spy::numCopyMove() == 1);    // assign move [50]
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
-      assertUnit(Spy::numCopyMove() == 0);
-      assertUnit(Spy::numAssignMove() == 0);
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20      [[40]]  60        80  
-      assertUnit(it.pNode != nullptr);
-      assertUnit(bst.root != nullptr && bst.root->pLeft != nullptr);
-      if (bst.root && bst.root->pLeft)
-         assertUnit(it.pNode == bst.root->pLeft->pRight);
-      if (it.pNode)
-         assertUnit(it.pNode->data == Spy(40));
-      assertStandardFixture(bst);
+      assertUnit(s.empty() == true);
+      assertUnit(pairBST.first != bst.end());
+      assertUnit(pairBST.second = true);
+      if (pairBST.first != bst.end())
+         assertUnit(*(pairBST.first) == Spy(50));
+      //           (50) 
+      //        +----+
+      //      (50r)
+      assertUnit(bst.size() == 2);
+      assertUnit(bst.numElements == 2);
+      assertUnit(bst.root == p50);
+
+      assertUnit(p50 != nullptr);
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->pLeft == nullptr);
+         assertUnit(p50->pRight != nullptr);
+         assertUnit(p50->pParent == nullptr);
+      }
+
+      if (p50 && p50->pRight)
+      {
+         assertUnit(p50->pRight->data == Spy(50));
+         assertUnit(p50->pRight->pLeft == nullptr);
+         assertUnit(p50->pRight->pRight == nullptr);
+         assertUnit(p50->pRight->pParent == p50);
+      }
+
       // teardown
-      teardownStandardFixture(bst);
+      if (p50 && p50->pRight && p50->pRight != p50)
+         delete p50->pRight;
+      if (p50)
+         delete p50;
+      bst.root = nullptr;
+      bst.numElements = 0;
    }
 
-   // increment where the next node is grandma
-   void test_iterator_increment_standardToGrandma()
+   // insert an item when it already exists
+   void test_insertMove_keepUnique()
    {  // setup
       //                 50 
       //          +-------+-------+
       //         30              70  
       //     +----+----+     +----+----+
-      //    20      [[40]]  60        80  
+      //    20        40    60        80  
       custom::BST <Spy> bst;
       setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
-      it.pNode = bst.root->pLeft->pRight; // 40
+      Spy s(40);
       Spy::reset();
       // exercise
-      ++it;
+      auto pairBST = bst.insert(std::move(s), true /* keepUnique */);
       // verify
-      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
-      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numLessthan() == 5);    // try [80], compare [50][30][40] and check [40]
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      //               [[50]] 
+      assertUnit(s.empty() == false);
+      assertUnit(pairBST.first != bst.end());
+      assertUnit(pairBST.second == false);
+      if (pairBST.first != bst.end())
+         assertUnit(*(pairBST.first) == Spy(40));
+      //                 50 
       //          +-------+-------+
       //         30              70  
       //     +----+----+     +----+----+
       //    20        40    60        80  
-      assertUnit(it.pNode == bst.root);
-      if (it.pNode)
-         assertUnit(it.pNode->data == Spy(50));
       assertStandardFixture(bst);
       // teardown
       teardownStandardFixture(bst);
    }
 
-   // increment where the next node is the right grandchild
-   void test_iterator_increment_standardToGrandchild()
+
+   /***************************************
+    * Insert Balancing
+    ***************************************/
+   
+   // Red/Black balancing - Case 1
+   void test_insert_case1()
    {  // setup
-      //               [[50]] 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
       custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
-      it.pNode = bst.root; // 50
+      Spy s(50);
       Spy::reset();
       // exercise
-      ++it;
+      bst.insert(s);
       // verify
-      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
-      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numCopy() == 1);        // copy-create [50]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [50]
+      assertUnit(Spy::numLessthan() == 0); 
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40  [[60]]      80  
-      assertUnit(it.pNode != nullptr);
-      assertUnit(bst.root != nullptr && bst.root->pRight != nullptr);
-      if (bst.root && bst.root->pRight)
-         assertUnit(it.pNode == bst.root->pRight->pLeft);
-      if (it.pNode)
-         assertUnit(it.pNode->data == Spy(60));
-      assertStandardFixture(bst);
+      //            (50b)
+      assertUnit(bst.root != nullptr);
+      assertUnit(bst.numElements == 1);
+
+      if (bst.root)
+      { 
+         assertUnit(bst.root->data == Spy(50));
+         assertUnit(bst.root->isRed() == false);
+         assertUnit(bst.root->pLeft == nullptr);
+         assertUnit(bst.root->pRight == nullptr);
+         assertUnit(bst.root->pParent == nullptr);
+      }
       // teardown
-      teardownStandardFixture(bst);
+      delete bst.root;
+      bst.root = nullptr;
+      bst.numElements = 0;
    }
 
-   // increment where we are already at the last node
-   void test_iterator_increment_standardToDone()
+   // Red/Black balancing - Case 2
+   void test_insert_case2()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60      [[80]]  
+      //            (50b)
       custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
-      it.pNode = bst.root->pRight->pRight; // 80
+      custom::BST<Spy>::BNode *p50 = new custom::BST<Spy>::BNode(Spy(50));
+      p50->setRed(false);
+      bst.root = p50;
+      bst.numElements = 1;
+      Spy s(30);
       Spy::reset();
       // exercise
-      ++it;
+      bst.insert(s);
       // verify
-      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
-      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numLessthan() == 1);    // compare [50]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [30]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [30]
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
-      assertUnit(it.pNode == nullptr);
-      assertUnit(it == bst.end());
-      assertStandardFixture(bst);
+      //              (50b)
+      //            +---+
+      //          (30r)
+      assertUnit(bst.empty() == false);
+      assertUnit(bst.size() == 2);        
+      assertUnit(bst.root == p50);
+      assertUnit(bst.numElements == 2);
+
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->isRed() == false);
+         assertUnit(p50->pLeft != nullptr);
+         assertUnit(p50->pRight == nullptr);
+         assertUnit(p50->pParent == nullptr);
+      }
+
+      if (p50 && p50->pLeft)
+      {
+         assertUnit(p50->pLeft->isRed() == true);
+         assertUnit(p50->pLeft->data == Spy(30));
+         assertUnit(p50->pLeft->pLeft == nullptr);
+         assertUnit(p50->pLeft->pLeft == nullptr);
+         assertUnit(p50->pLeft->pParent == bst.root);
+      }
+
       // teardown
-      teardownStandardFixture(bst);
+      if (p50 && p50->pLeft && p50->pLeft != p50)
+         delete p50->pLeft;
+      if (p50)
+         delete p50;
+      bst.root = nullptr;
+      bst.numElements = 0;
    }
 
-   // increment where we are already at the end
-   void test_iterator_increment_standardEnd()
+   // Red/Black balancing - Case 3
+   void test_insert_case3()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
+      //           (50b)
+      //        +----+----+
+      //      (30r)     (70r)
+      custom::BST<Spy>::BNode* p30 = new custom::BST<Spy>::BNode(Spy(30));
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p70 = new custom::BST<Spy>::BNode(Spy(70));
+
+      p50->pLeft  = p30;
+      p50->pRight = p70;
+      p70->pParent = p30->pParent = p50;
+
+      p50->setRed(false);
+      p30->setRed(true);
+      p70->setRed(true);
+
       custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
-      it.pNode = nullptr; 
+      bst.root = p50;
+      bst.numElements = 3;
+
+      Spy s(20);
       Spy::reset();
+
       // exercise
-      ++it;
+      bst.insert(s);
+
       // verify
-      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
-      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numLessthan() == 2);    // compare [50][30]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [20]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [20]
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
-      assertUnit(it.pNode == nullptr);
-      assertUnit(it == bst.end());
-      assertStandardFixture(bst);
+      //              (50b)
+      //           +----+----+
+      //         (30b)     (70b)
+      //       +---+
+      //     (20r)
+      assertUnit(bst.empty() == false);
+      assertUnit(bst.size() == 4);
+      assertUnit(bst.root == p50);
+      assertUnit(bst.numElements == 4);
+
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->isRed() == false);
+         assertUnit(p50->pLeft == p30);
+         assertUnit(p50->pRight == p70);
+         assertUnit(p50->pParent == nullptr);
+      }
+
+      if (p30)
+      {
+         assertUnit(p30->data == Spy(30));
+         assertUnit(p30->isRed() == false);
+         assertUnit(p30->pLeft != nullptr);
+         assertUnit(p30->pRight == nullptr);
+         assertUnit(p30->pParent == p50);
+      }
+
+      if (p70)
+      {
+         assertUnit(p70->data == Spy(70));
+         assertUnit(p70->isRed() == false);
+         assertUnit(p70->pLeft == nullptr);
+         assertUnit(p70->pRight == nullptr);
+         assertUnit(p70->pParent == p50);
+      }
+
+      if (p30 && p30->pLeft)
+      {
+         assertUnit(p30->pLeft->data == Spy(20));
+         assertUnit(p30->pLeft->isRed() == true);
+         assertUnit(p30->pLeft->pLeft == nullptr);
+         assertUnit(p30->pLeft->pRight == nullptr);
+         assertUnit(p30->pLeft->pParent == p30);
+      }
       // teardown
-      teardownStandardFixture(bst);
+      if (p30->pLeft && p30->pLeft != p30)
+         delete p30->pLeft;
+      if (p30)
+         delete p30;
+      if (p70)
+         delete p70;
+      if (p50)
+         delete p50;
+      bst.root = nullptr;
+      bst.numElements = 0;
    }
 
-   // itereator dereference were we just read
-   void test_iterator_dereference_standardRead()
+   // Red/Black balancing - Case 4a Simplest case
+   void test_insert_case4aSimple()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20      [[40]]  60        80  
+      //              (50b)
+      //           +----+
+      //         (30r)    
+      custom::BST<Spy>::BNode* p30 = new custom::BST<Spy>::BNode(Spy(30));
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+
+      p50->pLeft   = p30;
+      p30->pParent = p50;
+
+      p50->setRed(false);
+      p30->setRed(true);
+
       custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
-      it.pNode = bst.root->pLeft->pRight;
-      Spy s(99);
+      bst.root = p50;
+      bst.numElements = 2;
+
+      Spy s(10);
       Spy::reset();
+
       // exercise
-      s = *it;
+      bst.insert(s);
+
       // verify
-      assertUnit(Spy::numAssign() == 1);      // assign the results to s
-      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
-      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numLessthan() == 2);    // compare [50][30]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [10]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [10]
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numAssign() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(s == Spy(40));
-      assertStandardFixture(bst);
+      //              (30b)
+      //           +----+----+
+      //         (10r)     (50r)
+      assertUnit(bst.empty() == false);
+      assertUnit(bst.size() == 3);
+      assertUnit(bst.root == p30);
+      assertUnit(bst.numElements == 3);
+
+      if (p30)
+      {
+         assertUnit(p30->data == Spy(30));
+         assertUnit(p30->isRed() == false);
+         assertUnit(p30->pLeft != nullptr);
+         assertUnit(p30->pRight == p50);
+         assertUnit(p30->pParent == nullptr);
+      }
+
+      if (p30 && p30->pLeft)
+      {
+         assertUnit(p30->pLeft->data == Spy(10));
+         assertUnit(p30->pLeft->isRed() == true);
+         assertUnit(p30->pLeft->pLeft == nullptr);
+         assertUnit(p30->pLeft->pRight == nullptr);
+         assertUnit(p30->pLeft->pParent == p30);
+      }
+
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->isRed() == true);
+         assertUnit(p50->pLeft == nullptr);
+         assertUnit(p50->pRight == nullptr);
+         assertUnit(p50->pParent == p30);
+      }
+
       // teardown
-      teardownStandardFixture(bst);
+      if (p30 && p30->pLeft && p30->pLeft != p30)
+         delete p30->pLeft;
+      if (p50)
+         delete p50;
+      if (p30)
+         delete p30;
+      bst.root = nullptr;
+      bst.numElements = 0;
    }
 
-   /***************************************
-    * Find
-    *    BST::find(const T &)
-    ***************************************/
-
-   // attempt to find something in an empty BST
-   void test_find_empty()
+   // Red/Black balancing - Case 4b Simplest case
+   void test_insert_case4bSimple()
    {  // setup
-      custom::BST<Spy> bst;
-      custom::BST<Spy>::iterator it;
-      Spy s(50);
+      //              (50b)
+      //                +----+
+      //                   (70r)    
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p70 = new custom::BST<Spy>::BNode(Spy(70));
+
+      p50->pRight = p70;
+      p70->pParent = p50;
+
+      p50->setRed(false);
+      p70->setRed(true);
+
+      custom::BST <Spy> bst;
+      bst.root = p50;
+      bst.numElements = 2;
+
+      Spy s(90);
       Spy::reset();
+
       // exercise
-      it = bst.find(s);
+      bst.insert(s);
+
       // verify
-      assertUnit(Spy::numLessthan() == 0);    // does not look at any element
-      assertUnit(Spy::numEquals() == 0);      // does not look at any element
+      assertUnit(Spy::numLessthan() == 2);    // compare [50][70]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [90]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [90]
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(it == bst.end());
-      assertEmptyFixture(bst);
-   }  // teardown
-   
-   // attemp to find something where it is at the beginning
-   void test_find_standardBegin()
+      //              (70b)
+      //           +----+----+
+      //         (50r)     (90r)
+      assertUnit(bst.empty() == false);
+      assertUnit(bst.size() == 3);
+      assertUnit(bst.root == p70);
+      assertUnit(bst.numElements == 3);
+
+      if (p70)
+      {
+         assertUnit(p70->data == Spy(70));
+         assertUnit(p70->isRed() == false);
+         assertUnit(p70->pLeft == p50);
+         assertUnit(p70->pRight != nullptr);
+         assertUnit(p70->pParent == nullptr);
+      }
+
+      if (p70->pRight)
+      {
+         assertUnit(p70->pRight->data == Spy(90));
+         assertUnit(p70->pRight->isRed() == true);
+         assertUnit(p70->pRight->pLeft == nullptr);
+         assertUnit(p70->pRight->pRight == nullptr);
+         assertUnit(p70->pRight->pParent == p70);
+      }
+
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->isRed() == true);
+         assertUnit(p50->pLeft == nullptr);
+         assertUnit(p50->pRight == nullptr);
+         assertUnit(p50->pParent == p70);
+      }
+      
+      // teardown
+      if (p70->pRight && p70->pRight != p70)
+         delete p70->pRight;
+      if (p50)
+         delete p50;
+      if (p70)
+         delete p70;
+      bst.root = nullptr;
+      bst.numElements = 0;
+   }
+
+   // Red/Black balancing - Case 4c Simplest case
+   void test_insert_case4cSimple()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
+      //                   (50b)
+      //           +---------+
+      //         (30r)     
+      custom::BST<Spy>::BNode* p30 = new custom::BST<Spy>::BNode(Spy(30));
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+
+      p50->pLeft = p30;
+      p30->pParent = p50;
+
+      p30->setRed(true);
+      p50->setRed(false);
+
       custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
-      Spy s(20);
+      bst.root = p50;
+      bst.numElements = 2;
+
+      Spy s(40);
       Spy::reset();
+
       // exercise
-      it = bst.find(s);
+      bst.insert(s);
+
       // verify
-      assertUnit(Spy::numEquals() == 3);      // check [50][30][20]
       assertUnit(Spy::numLessthan() == 2);    // compare [50][30]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [40]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [40]
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
-      assertUnit(Spy::numCopyMove() == 0);
-      assertUnit(Spy::numAssignMove() == 0);
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //  [[20]]      40    60        80  
-      assertUnit(it.pNode != nullptr);
-      if (it.pNode)
-         assertUnit(*it == Spy(20));
-      assertUnit(bst.root != nullptr && bst.root->pLeft != nullptr);
-      if (bst.root && bst.root->pLeft)
-         assertUnit(it.pNode == bst.root->pLeft->pLeft);
-      assertStandardFixture(bst);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      //                   (40b)
+      //           +---------+---------+
+      //         (30r)               (50r)
+      assertUnit(bst.empty() == false);
+      assertUnit(bst.size() == 3);
+      assertUnit(bst.root != nullptr);
+      assertUnit(bst.numElements == 3);
+
+      if (bst.root)
+      {
+         assertUnit(bst.root->data == Spy(40));
+         assertUnit(bst.root->isRed() == false);
+         assertUnit(bst.root->pLeft == p30);
+         assertUnit(bst.root->pRight == p50);
+         assertUnit(bst.root->pParent == nullptr);
+      }
+
+      if (p30)
+      {
+         assertUnit(p30->data == Spy(30));
+         assertUnit(p30->isRed() == true);
+         assertUnit(p30->pLeft == nullptr);
+         assertUnit(p30->pRight == nullptr);
+         assertUnit(p30->pParent == bst.root);
+      }
+
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->isRed() == true);
+         assertUnit(p50->pLeft == nullptr);
+         assertUnit(p50->pRight == nullptr);
+         assertUnit(p50->pParent == bst.root);
+      }
+
       // teardown
-      teardownStandardFixture(bst);
+      if (bst.root && bst.root != p50 && bst.root != p30)
+         delete bst.root;
+      if (p50)
+         delete p50;
+      if (p30)
+         delete p30;
+      bst.numElements = 0;
+      bst.root = nullptr;
    }
-   
-   // attempt to find something where it is the last element
-   void test_find_standardLast()
+
+   // Red/Black balancing - Case 4d Simplest Case
+   void test_insert_case4dSimple()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
+      //         (50b)
+      //           +---------+
+      //                   (70r)     
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p70 = new custom::BST<Spy>::BNode(Spy(70));
+
+      p50->pRight = p70;
+      p70->pParent = p50;
+
+      p70->setRed(true);
+      p50->setRed(false);
+
       custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
-      Spy s(80);
+      bst.root = p50;
+      bst.numElements = 2;
+
+      Spy s(60);
       Spy::reset();
+
       // exercise
-      it = bst.find(s);
+      bst.insert(s);
+
       // verify
-      assertUnit(Spy::numEquals() == 3);      // check [50][70][80]
       assertUnit(Spy::numLessthan() == 2);    // compare [50][70]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [60]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [60]
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60      [[80]]
-      assertUnit(it.pNode != nullptr);
-      if (it.pNode)
-         assertUnit(*it == Spy(80));
-      assertUnit(bst.root != nullptr && bst.root->pRight != nullptr);
-      if (bst.root && bst.root->pRight)
-         assertUnit(it.pNode == bst.root->pRight->pRight);
-      assertStandardFixture(bst);
+      //                   (60b)
+      //           +---------+---------+
+      //         (50r)               (70r)
+      assertUnit(bst.empty() == false);
+      assertUnit(bst.size() == 3);
+      assertUnit(bst.root != nullptr);
+      assertUnit(bst.numElements == 3);
+
+      if (bst.root)
+      {
+         assertUnit(bst.root->data == Spy(60));
+         assertUnit(bst.root->isRed() == false);
+         assertUnit(bst.root->pLeft == p50);
+         assertUnit(bst.root->pRight == p70);
+         assertUnit(bst.root->pParent == nullptr);
+      }
+
+      if (p50)
+      {
+
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->isRed() == true);
+         assertUnit(p50->pLeft == nullptr);
+         assertUnit(p50->pRight == nullptr);
+         assertUnit(p50->pParent == bst.root);
+      }
+
+      if (p70)
+      {
+         assertUnit(p70->data == Spy(70));
+         assertUnit(p70->isRed() == true);
+         assertUnit(p70->pLeft == nullptr);
+         assertUnit(p70->pRight == nullptr);
+         assertUnit(p70->pParent == bst.root);
+      }
       // teardown
-      teardownStandardFixture(bst);
+      if (bst.root && bst.root != p50 && bst.root != p70)
+         delete bst.root;
+      if (p50)
+         delete p50;
+      if (p70)
+         delete p70;
+      bst.numElements = 0;
+      bst.root = nullptr;
    }
 
-   // attempt to find something where it is not there
-   void test_find_standardMissing()
+   // Red/Black balancing - Case 4a Complex
+   void test_insert_case4aComplex()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
+      //              (50b)
+      //           +----+----+
+      //         (30b)     (70b)
+      //       +---+
+      //     (20r)    
+      custom::BST<Spy>::BNode* p20 = new custom::BST<Spy>::BNode(Spy(20));
+      custom::BST<Spy>::BNode* p30 = new custom::BST<Spy>::BNode(Spy(30));
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p70 = new custom::BST<Spy>::BNode(Spy(70));
+
+      p50->pLeft  = p30;
+      p50->pRight = p70;
+      p30->pLeft  = p20;
+      p70->pParent = p30->pParent = p50;
+      p20->pParent = p30;
+
+      p20->setRed(true);
+      p30->setRed(false);
+      p70->setRed(false);
+      p50->setRed(false);
+
       custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      custom::BST<Spy>::iterator it;
-      Spy s(42);
+      bst.root = p50;
+      bst.numElements = 4;
+
+      Spy s(10);
       Spy::reset();
+
       // exercise
-      it = bst.find(s);
+      bst.insert(s);
+
       // verify
-      assertUnit(Spy::numEquals() == 3);      // check [50][30][40]
-      assertUnit(Spy::numLessthan() == 3);    // compare [50][30][40]
+      assertUnit(Spy::numLessthan() == 3);    // compare [50][30][20]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [10]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [10]
+      assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
       assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
       assertUnit(Spy::numDefault() == 0);
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(it == bst.end());
-      assertStandardFixture(bst);
+      //              (50b)
+      //           +----+----+
+      //         (20b)     (70b)
+      //       +---+---+
+      //     (10r)   (30r)
+      assertUnit(bst.empty() == false);
+      assertUnit(bst.size() == 5);
+      assertUnit(bst.root == p50);
+      assertUnit(bst.numElements == 5);
+
+      if (p50)
+      {
+         assertUnit(p50->data == Spy(50));
+         assertUnit(p50->isRed() == false);
+         assertUnit(p50->pLeft == p20);
+         assertUnit(p50->pRight == p70);
+         assertUnit(p50->pParent == nullptr);
+      }
+
+      if (p20)
+      {
+         assertUnit(p20->data == Spy(20));
+         assertUnit(p20->isRed() == false);
+         assertUnit(p20->pLeft != nullptr);
+         assertUnit(p20->pRight == p30);
+         assertUnit(p20->pParent == p50);
+      }
+
+      if (p70)
+      {
+         assertUnit(p70->data == Spy(70));
+         assertUnit(p70->isRed() == false);
+         assertUnit(p70->pLeft == nullptr);
+         assertUnit(p70->pRight == nullptr);
+         assertUnit(p70->pParent == p50);
+      }
+
+      if (p30)
+      {
+         assertUnit(p30->data == Spy(30));
+         assertUnit(p30->isRed() == true);
+         assertUnit(p30->pLeft == nullptr);
+         assertUnit(p30->pRight == nullptr);
+         assertUnit(p30->pParent == p20);
+      }
+
+      if (p20 && p20->pLeft)
+      {
+         assertUnit(p20->pLeft->data == Spy(10));
+         assertUnit(p20->pLeft->isRed() == true);
+         assertUnit(p20->pLeft->pLeft == nullptr);
+         assertUnit(p20->pLeft->pRight == nullptr);
+         assertUnit(p20->pLeft->pParent == p20);
+      }
+
       // teardown
-      teardownStandardFixture(bst);
+      if (p20 && p20->pLeft && p20->pLeft != p20)
+        delete p20->pLeft;
+      if (p30)
+         delete p30;
+      if (p70)
+         delete p70;
+      if (p20)
+         delete p20;
+      if (p50)
+         delete p50;
+      bst.root = nullptr;
+      bst.numElements = 0;
    }
 
+   // Red/Black balancing - Case 4b
+   void test_insert_case4bComplex()
+   {  // setup
+      //              (50b)
+      //           +----+----+
+      //         (30b)     (70b)
+      //                     +---+
+      //                       (80r)    
+      custom::BST<Spy>::BNode* p30 = new custom::BST<Spy>::BNode(Spy(30));
+      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
+      custom::BST<Spy>::BNode* p70 = new custom::BST<Spy>::BNode(Spy(70));
+      custom::BST<Spy>::BNode* p80 = new custom::BST<Spy>::BNode(Spy(80));
 
+      p50->pLeft = p30;
+      p50->pRight = p70;
+      p70->pRight = p80;
+      p70->pParent = p30->pParent = p50;
+      p80->pParent = p70;
 
-   /***************************************
-    * Insert
-    *    BST::insert(const T &)
-    ***************************************/
+      p80->setRed(true);
+      p30->setRed(false);
+      p70->setRed(false);
+      p50->setRed(false);
 
-   // insert an element to the right of a single-element tree
-   void test_insert_oneRight()
-   {  // setup
-      //            (50) 
       custom::BST <Spy> bst;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
       bst.root = p50;
-      bst.numElements = 1;
-      Spy s(60);
+      bst.numElements = 4;
+
+      Spy s(90);
       Spy::reset();
+
       // exercise
-      auto pairBST = bst.insert(s);
+      bst.insert(s);
+
       // verify
-      assertUnit(Spy::numLessthan() == 1);    // compare [50]
-      assertUnit(Spy::numCopy() == 1);        // copy-create [60]
-      assertUnit(Spy::numAlloc() == 1);       // allocate [60]
+      assertUnit(Spy::numLessthan() == 3);    // compare [50][70][80]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [90]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [90]
       assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
@@ -1692,55 +4579,124 @@ public:
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(pairBST.first != bst.end());
-      assertUnit(pairBST.second = true);
-      if (pairBST.first != bst.end())
-         assertUnit(*(pairBST.first) == Spy(60));
-      //           (50) 
-      //             +----+
-      //                 (60) 
-      assertUnit(bst.size() == 2);
-      assertUnit(bst.numElements == 2);
+      //              (50b)
+      //           +----+----+
+      //         (30b)     (80b)
+      //                 +---+---+
+      //               (70r)   (90r)
+      assertUnit(bst.empty() == false);
+      assertUnit(bst.size() == 5);
       assertUnit(bst.root == p50);
+      assertUnit(bst.numElements == 5);
 
-      assertUnit(p50 != nullptr);
       if (p50)
       {
          assertUnit(p50->data == Spy(50));
-         assertUnit(p50->pLeft == nullptr);
-         assertUnit(p50->pRight != nullptr);
+         assertUnit(p50->isRed() == false);
+         assertUnit(p50->pLeft == p30);
+         assertUnit(p50->pRight == p80);
          assertUnit(p50->pParent == nullptr);
       }
-      if (p50 && p50->pRight)
+
+      if (p30)
       {
-         assertUnit(p50->pRight->data == Spy(60));
-         assertUnit(p50->pRight->pLeft == nullptr);
-         assertUnit(p50->pRight->pRight == nullptr);
-         assertUnit(p50->pRight->pParent == p50);
+         assertUnit(p30->data == Spy(30));
+         assertUnit(p30->isRed() == false);
+         assertUnit(p30->pLeft == nullptr);
+         assertUnit(p30->pRight == nullptr);
+         assertUnit(p30->pParent == p50);
+      }
+
+      if (p80)
+      {
+         assertUnit(p80->data == Spy(80));
+         assertUnit(p80->isRed() == false);
+         assertUnit(p80->pLeft == p70);
+         assertUnit(p80->pRight != nullptr);
+         assertUnit(p80->pParent == p50);
+      }
+
+      if (p70)
+      {
+         assertUnit(p70->data == Spy(70));
+         assertUnit(p70->isRed() == true);
+         assertUnit(p70->pLeft == nullptr);
+         assertUnit(p70->pRight == nullptr);
+         assertUnit(p70->pParent == p80);
+      }
+
+      if (p80 && p80->pRight)
+      {
+         assertUnit(p80->pRight->data == Spy(90));
+         assertUnit(p80->pRight->isRed() == true);
+         assertUnit(p80->pRight->pLeft == nullptr);
+         assertUnit(p80->pRight->pRight == nullptr);
+         assertUnit(p80->pRight->pParent == p80);
       }
+
       // teardown
-      if (p50 && p50->pRight && p50->pRight != p50)
-         delete p50->pRight;
+      if (p80 && p80->pRight && p80->pRight != p80)
+         delete p80->pRight;
+      if (p70)
+         delete p70;
+      if (p30)
+         delete p30;
+      if (p80)
+         delete p80;
       if (p50)
          delete p50;
       bst.root = nullptr;
       bst.numElements = 0;
    }
 
-   // insert an element to the left of a single-element tree
-   void test_insert_oneLeft()
+   // Red/Black balancing - Case 4c Complex case
+   void test_insert_case4cComplex()
    {  // setup
-      //            (50) 
-      custom::BST <Spy> bst;
+      //                   (70b)
+      //           +---------+---------+
+      //         (20r)               (80b)  
+      //     +-----+-----+
+      //   (10b)       (50b)
+      //            +----+----+
+      //          (30r)     (60r)
+      custom::BST<Spy>::BNode* p10 = new custom::BST<Spy>::BNode(Spy(10));
+      custom::BST<Spy>::BNode* p20 = new custom::BST<Spy>::BNode(Spy(20));
+      custom::BST<Spy>::BNode* p30 = new custom::BST<Spy>::BNode(Spy(30));
       custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
-      bst.root = p50;
-      bst.numElements = 1;
+      custom::BST<Spy>::BNode* p60 = new custom::BST<Spy>::BNode(Spy(60));
+      custom::BST<Spy>::BNode* p70 = new custom::BST<Spy>::BNode(Spy(70));
+      custom::BST<Spy>::BNode* p80 = new custom::BST<Spy>::BNode(Spy(80));
+
+      p20->pLeft  = p10;
+      p20->pRight = p50;
+      p50->pLeft  = p30;
+      p50->pRight = p60;
+      p70->pLeft  = p20;
+      p70->pRight = p80;
+      p30->pParent = p60->pParent = p50;
+      p10->pParent = p50->pParent = p20;
+      p20->pParent = p80->pParent = p70;
+
+      p20->setRed(true);
+      p30->setRed(true);
+      p60->setRed(true);
+      p10->setRed(false);
+      p50->setRed(false);
+      p70->setRed(false);
+      p80->setRed(false);
+
+      custom::BST <Spy> bst;
+      bst.root = p70;
+      bst.numElements = 7;
+
       Spy s(40);
       Spy::reset();
+
       // exercise
-      auto pairBST = bst.insert(s);
+      bst.insert(s);
+
       // verify
-      assertUnit(Spy::numLessthan() == 1);    // compare [50]
+      assertUnit(Spy::numLessthan() == 4);    // compare [70][20][50][30]
       assertUnit(Spy::numCopy() == 1);        // copy-create [40]
       assertUnit(Spy::numAlloc() == 1);       // allocate [40]
       assertUnit(Spy::numEquals() == 0);
@@ -1751,60 +4707,160 @@ public:
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(pairBST.first != bst.end());
-      assertUnit(pairBST.second = true);
-      if (pairBST.first != bst.end())
-         assertUnit(*(pairBST.first) == Spy(40));
-
-      //           (50) 
-      //        +----+
-      //      (40) 
-      assertUnit(bst.size() == 2);
-      assertUnit(bst.numElements == 2);
+      //                   (50b)
+      //           +---------+---------+
+      //         (20r)               (70r)  
+      //     +-----+-----+       +-----+-----+
+      //   (10b)       (30b)   (60b)       (80b)
+      //                 +--+
+      //                  (40r)
+      assertUnit(bst.empty() == false);
+      assertUnit(bst.size() == 8);
       assertUnit(bst.root == p50);
+      assertUnit(bst.numElements == 8);
+
+      if (p10)
+      {
+         assertUnit(p10->data == Spy(10));
+         assertUnit(p10->isRed() == false);
+         assertUnit(p10->pLeft == nullptr);
+         assertUnit(p10->pRight == nullptr);
+         assertUnit(p10->pParent == p20);
+      }
+
+      if (p20)
+      {
+         assertUnit(p20->data == Spy(20));
+         assertUnit(p20->isRed() == true);
+         assertUnit(p20->pLeft == p10);
+         assertUnit(p20->pRight == p30);
+         assertUnit(p20->pParent == p50);
+      }
+
+      if (p30)
+      {
+         assertUnit(p30->data == Spy(30));
+         assertUnit(p30->isRed() == false);
+         assertUnit(p30->pLeft == nullptr);
+         assertUnit(p30->pRight != nullptr);
+         assertUnit(p30->pParent == p20);
+      }
+
+      if (p30 && p30->pRight)
+      {
+         assertUnit(p30->pRight->data == Spy(40));
+         assertUnit(p30->pRight->isRed() == true);
+         assertUnit(p30->pRight->pLeft == nullptr);
+         assertUnit(p30->pRight->pRight == nullptr);
+         assertUnit(p30->pRight->pParent == p30);
+      }
 
-      assertUnit(p50 != nullptr);
       if (p50)
       {
          assertUnit(p50->data == Spy(50));
-         assertUnit(p50->pLeft != nullptr);
-         assertUnit(p50->pRight == nullptr);
+         assertUnit(p50->isRed() == false);
+         assertUnit(p50->pLeft == p20);
+         assertUnit(p50->pRight == p70);
          assertUnit(p50->pParent == nullptr);
       }
 
-      if (p50 && p50->pLeft)
+      if (p60)
       {
-         assertUnit(p50->pLeft->data == Spy(40));
-         assertUnit(p50->pLeft->pLeft == nullptr);
-         assertUnit(p50->pLeft->pRight == nullptr);
-         assertUnit(p50->pLeft->pParent == p50);
+         assertUnit(p60->data == Spy(60));
+         assertUnit(p60->isRed() == false);
+         assertUnit(p60->pLeft == nullptr);
+         assertUnit(p60->pRight == nullptr);
+         assertUnit(p60->pParent == p70);
+      }
+
+      if (p70)
+      {
+         assertUnit(p70->data == Spy(70));
+         assertUnit(p70->isRed() == true);
+         assertUnit(p70->pLeft == p60);
+         assertUnit(p70->pRight == p80);
+         assertUnit(p70->pParent == p50);
       }
 
+      if (p80)
+      {
+         assertUnit(p80->data == Spy(80));
+         assertUnit(p80->isRed() == false);
+         assertUnit(p80->pLeft == nullptr);
+         assertUnit(p80->pRight == nullptr);
+         assertUnit(p80->pParent == p70);
+      }
       // teardown
-      if (p50 && p50->pLeft && p50->pLeft != p50)
-         delete p50->pLeft;
+      if (p30 && p30->pRight && p30->pRight != p30)
+         delete p30->pRight;
+      if (p10)
+         delete p10;
+      if (p20)
+         delete p20;
+      if (p30)
+         delete p30;
       if (p50)
          delete p50;
-      bst.root = nullptr;
+      if (p60)
+         delete p60;
+      if (p70)
+         delete p70;
+      if (p80)
+         delete p80;
       bst.numElements = 0;
+      bst.root = nullptr;
    }
 
-   // insert a duplicate item in a BST
-   void test_insert_duplicate()
+   // Red/Black balancing - Case 4d Complex Case
+   void test_insert_case4dComplex()
    {  // setup
-      //            (50) 
-      custom::BST <Spy> bst;
+      //                   (30b)
+      //           +---------+---------+
+      //         (20b)               (80r)  
+      //                         +-----+-----+
+      //                       (50b)       (90b)
+      //                    +----+----+
+      //                  (40r)     (70r)
+      custom::BST<Spy>::BNode* p20 = new custom::BST<Spy>::BNode(Spy(20));
+      custom::BST<Spy>::BNode* p30 = new custom::BST<Spy>::BNode(Spy(30));
+      custom::BST<Spy>::BNode* p40 = new custom::BST<Spy>::BNode(Spy(40));
       custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
-      bst.root = p50;
-      bst.numElements = 1;
-      Spy s(50);
+      custom::BST<Spy>::BNode* p70 = new custom::BST<Spy>::BNode(Spy(70));
+      custom::BST<Spy>::BNode* p80 = new custom::BST<Spy>::BNode(Spy(80));
+      custom::BST<Spy>::BNode* p90 = new custom::BST<Spy>::BNode(Spy(90));
+
+      p30->pLeft  = p20;
+      p30->pRight = p80;
+      p50->pLeft  = p40;
+      p50->pRight = p70;
+      p80->pLeft  = p50;
+      p80->pRight = p90;
+      p40->pParent = p70->pParent = p50;
+      p50->pParent = p90->pParent = p80;
+      p20->pParent = p80->pParent = p30;
+
+      p40->setRed(true);
+      p70->setRed(true);
+      p80->setRed(true);
+      p20->setRed(false);
+      p30->setRed(false);
+      p50->setRed(false);
+      p90->setRed(false);
+
+      custom::BST <Spy> bst;
+      bst.root = p30;
+      bst.numElements = 7;
+
+      Spy s(60);
       Spy::reset();
+
       // exercise
-      auto pairBST = bst.insert(s, false /* keepUnique */);
+      bst.insert(s);
+
       // verify
-      assertUnit(Spy::numLessthan() == 1);    // compare [50]
-      assertUnit(Spy::numCopy() == 1);        // copy-create [50]
-      assertUnit(Spy::numAlloc() == 1);       // allocate [50]
+      assertUnit(Spy::numLessthan() == 4);    // compare [30][80][50][70]
+      assertUnit(Spy::numCopy() == 1);        // copy-create [60]
+      assertUnit(Spy::numAlloc() == 1);       // allocate [60]
       assertUnit(Spy::numEquals() == 0);
       assertUnit(Spy::numDestructor() == 0);
       assertUnit(Spy::numDelete() == 0);
@@ -1813,316 +4869,679 @@ public:
       assertUnit(Spy::numNondefault() == 0);
       assertUnit(Spy::numCopyMove() == 0);
       assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(pairBST.first != bst.end());
-      assertUnit(pairBST.second = true);
-      if (pairBST.first != bst.end())
-         assertUnit(*(pairBST.first) == Spy(50));
-      //           (50) 
-      //        +----+
-      //      (50r)
-      assertUnit(bst.size() == 2);
-      assertUnit(bst.numElements == 2);
+      //                   (50b)
+      //           +---------+---------+
+      //         (30r)               (80r)  
+      //     +-----+-----+       +-----+-----+
+      //   (20b)       (40b)   (70b)       (90b)
+      //                      +--+
+      //                    (60r)
+      assertUnit(bst.empty() == false);
+      assertUnit(bst.size() == 8);
       assertUnit(bst.root == p50);
+      assertUnit(bst.numElements == 8);
+
+      if (p20)
+      {
+         assertUnit(p20->data == Spy(20));
+         assertUnit(p20->isRed() == false);
+         assertUnit(p20->pLeft == nullptr);
+         assertUnit(p20->pRight == nullptr);
+         assertUnit(p20->pParent == p30);
+      }
+
+      if (p30)
+      {
+         assertUnit(p30->data == Spy(30));
+         assertUnit(p30->isRed() == true);
+         assertUnit(p30->pLeft == p20);
+         assertUnit(p30->pRight == p40);
+         assertUnit(p30->pParent == p50);
+      }
+
+      if (p40)
+      {
+         assertUnit(p40->data == Spy(40));
+         assertUnit(p40->isRed() == false);
+         assertUnit(p40->pLeft == nullptr);
+         assertUnit(p40->pRight == nullptr);
+         assertUnit(p40->pParent == p30);
+      }
 
-      assertUnit(p50 != nullptr);
       if (p50)
       {
          assertUnit(p50->data == Spy(50));
-         assertUnit(p50->pLeft == nullptr);
-         assertUnit(p50->pRight != nullptr);
+         assertUnit(p50->isRed() == false);
+         assertUnit(p50->pLeft == p30);
+         assertUnit(p50->pRight == p80);
          assertUnit(p50->pParent == nullptr);
       }
 
-      if (p50 && p50->pRight)
+      if (p70 && p70->pLeft)
       {
-         assertUnit(p50->pRight->data == Spy(50));
-         assertUnit(p50->pRight->pLeft == nullptr);
-         assertUnit(p50->pRight->pRight == nullptr);
-         assertUnit(p50->pRight->pParent == p50);
+         assertUnit(p70->pLeft->data == Spy(60));
+         assertUnit(p70->pLeft->isRed() == true);
+         assertUnit(p70->pLeft->pLeft == nullptr);
+         assertUnit(p70->pLeft->pRight == nullptr);
+         assertUnit(p70->pLeft->pParent == p70);
+      }
+
+      if (p70)
+      {
+         assertUnit(p70->data == Spy(70));
+         assertUnit(p70->isRed() == false);
+         assertUnit(p70->pLeft != nullptr);
+         assertUnit(p70->pRight == nullptr);
+         assertUnit(p70->pParent == p80);
+      }
+
+      if (p80)
+      {
+         assertUnit(p80->data == Spy(80));
+         assertUnit(p80->isRed() == true);
+         assertUnit(p80->pLeft == p70);
+         assertUnit(p80->pRight == p90);
+         assertUnit(p80->pParent == p50);
+      }
+
+      if (p90)
+      {
+         assertUnit(p90->data == Spy(90));
+         assertUnit(p90->isRed() == false);
+         assertUnit(p90->pLeft == nullptr);
+         assertUnit(p90->pRight == nullptr);
+         assertUnit(p90->pParent == p80);
       }
 
       // teardown
-      if (p50 && p50->pRight && p50->pRight != p50)
-         delete p50->pRight;
+      if (p70 && p70->pLeft && p70->pLeft != p70)
+         delete p70->pLeft;
+      if (p20)
+         delete p20;
+      if (p30)
+         delete p30;
+      if (p40)
+         delete p40;
       if (p50)
          delete p50;
-      bst.root = nullptr;
+      if (p70)
+         delete p70;
+      if (p80)
+         delete p80;
+      if (p90)
+         delete p90;
       bst.numElements = 0;
+      bst.root = nullptr;
    }
 
-   // insert an item when it already exists
-   void test_insert_keepUnique()
+   /***************************************
+    * Insert Balancing Cost
+    *    BST::balanceStats()
+    ***************************************/
+
+   // a straight line of three is one single rotation
+   void test_insert_statsSingle()
    {  // setup
-      //                 50 
+      custom::BST <int> bst;
+      // exercise
+      bst.insert(10);
+      bst.insert(20);
+      bst.insert(30);
+      // verify
+      assertUnit(bst.balanceStats().singleRotations == 1);
+      assertUnit(bst.balanceStats().doubleRotations == 0);
+      assertUnit(bst.balanceStats().recolors == 0);
+      assertUnit(bst.root && bst.root->data == 20);
+   }  // teardown
+
+   // a zig-zag of three is one double rotation
+   void test_insert_statsDouble()
+   {  // setup
+      custom::BST <int> bst;
+      // exercise
+      bst.insert(10);
+      bst.insert(30);
+      bst.insert(20);
+      // verify
+      assertUnit(bst.balanceStats().singleRotations == 0);
+      assertUnit(bst.balanceStats().doubleRotations == 1);
+      assertUnit(bst.balanceStats().recolors == 0);
+      assertUnit(bst.root && bst.root->data == 20);
+   }  // teardown
+
+   // a red aunt is a recolor, and the counters can start over
+   void test_insert_statsRecolor()
+   {  // setup
+      custom::BST <int> bst;
+      bst.insert(50);
+      bst.insert(30);
+      bst.insert(70);
+      bst.resetBalanceStats();
+      // exercise
+      bst.insert(20);
+      // verify
+      assertUnit(bst.balanceStats().recolors == 1);
+      assertUnit(bst.balanceStats().singleRotations == 0);
+      assertUnit(bst.balanceStats().doubleRotations == 0);
+   }  // teardown
+
+   // ascending keys no longer make a linked list
+   void test_insert_sortedStaysBalanced()
+   {  // setup
+      custom::BST <int> bst;
+      // exercise
+      for (int i = 0; i < 10000; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(bst.size() == 10000);
+      assertUnit(bst.root && bst.root->verifyRedBlack(bst.root->findDepth()));
+      if (bst.root)
+         bst.root->verifyBTree();
+      // black height of a red-black tree of n nodes is at most log2(n + 1)
+      assertUnit(bst.root && bst.root->findDepth() <= 14);
+      assertUnit(bst.balanceStats().singleRotations > 0);
+      assertUnit(bst.balanceStats().doubleRotations == 0);
+      int expected = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         assertUnit(*it == expected++);
+   }  // teardown
+
+   // each new largest is one comparison with the last, not a walk down
+   void test_insert_appendSkipsDescent()
+   {  // setup
+      custom::BST <Spy> bst;
+      std::vector<Spy> values;
+      for (int i = 0; i < 1000; i++)
+         values.push_back(Spy(i));
+      Spy::reset();
+      // exercise
+      for (const Spy & s : values)
+         bst.insert(s);
+      // verify
+      assertUnit(Spy::numLessthan() == 999);   // try the largest, once each
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(bst.size() == 1000);
+      assertUnit(bst.root && bst.root->verifyRedBlack(bst.root->findDepth()));
+      assertUnit(bst.pMax && bst.pMax->data == Spy(999));
+      int expected = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         assertUnit(*it == Spy(expected++));
+   }  // teardown
+
+   // the largest is remembered through erase, clear, swap, and copy
+   void test_insert_appendAfterErase()
+   {  // setup
+      custom::BST <int> bst;
+      for (int i = 0; i < 100; i += 2)
+         bst.insert(i);
+      // exercise and verify
+      auto it = bst.find(98);
+      bst.erase(it);
+      assertUnit(bst.pMax && bst.pMax->data == 96);
+      bst.insert(97);
+      assertUnit(bst.pMax && bst.pMax->data == 97);
+      assertUnit(std::is_sorted(bst.begin(), bst.end()));
+
+      custom::BST <int> bstOther;
+      bstOther.swap(bst);
+      assertUnit(bst.pMax == nullptr);
+      assertUnit(bstOther.pMax && bstOther.pMax->data == 97);
+
+      custom::BST <int> bstCopy(bstOther);
+      assertUnit(bstCopy.pMax && bstCopy.pMax->data == 97);
+      bstCopy.insert(200);
+      assertUnit(bstCopy.pMax && bstCopy.pMax->data == 200);
+
+      bstOther.clear();
+      assertUnit(bstOther.pMax == nullptr);
+      bstOther.insert(5);
+      assertUnit(bstOther.pMax && bstOther.pMax->data == 5);
+   }  // teardown
+
+   // between the hint and the one before it, the hint has room on the left
+   void test_insertHint_beforeHint()
+   {  // setup
+      //                 50
       //          +-------+-------+
-      //         30              70  
+      //         30              70
       //     +----+----+     +----+----+
-      //    20        40    60        80  
+      //    20        40    60        80
       custom::BST <Spy> bst;
       setupStandardFixture(bst);
-      Spy s(40);
+      auto itHint = bst.find(Spy(40));
+      Spy s(35);
       Spy::reset();
       // exercise
-      auto pairBST = bst.insert(s, true /* keepUnique */);
+      auto it = bst.insert(itHint, s);
       // verify
-      assertUnit(Spy::numLessthan() == 2);    // compare [50][30]
-      assertUnit(Spy::numEquals() == 3);      // compare [50][30][40]
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
-      assertUnit(Spy::numDestructor() == 0);
-      assertUnit(Spy::numDelete() == 0);
-      assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numDefault() == 0);
-      assertUnit(Spy::numNondefault() == 0);
-      assertUnit(Spy::numCopyMove() == 0);
-      assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(pairBST.first != bst.end());
-      assertUnit(pairBST.second == false);
-      if (pairBST.first != bst.end())
-         assertUnit(*(pairBST.first) == Spy(40));
-      //                 50 
+      assertUnit(Spy::numLessthan() == 2);    // check [30] and [40]
+      assertUnit(Spy::numCopy() == 1);
+      assertUnit(Spy::numAlloc() == 1);
+      assertUnit(it != bst.end() && *it == Spy(35));
+      //                 50
       //          +-------+-------+
-      //         30              70  
+      //         30              70
       //     +----+----+     +----+----+
-      //    20        40    60        80  
-      assertStandardFixture(bst);
+      //    20        40    60        80
+      //            +--+
+      //           35
+      assertUnit(bst.size() == 8);
+      assertUnit(it.pNode->pParent == itHint.pNode);
+      assertUnit(itHint.pNode->pLeft == it.pNode);
       // teardown
-      teardownStandardFixture(bst);
+      bst.clear();
    }
 
+   // the hint has a left child, so the one before it has room on the right
+   void test_insertHint_afterPrevious()
+   {  // setup
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      //     +----+----+     +----+----+
+      //    20        40    60        80
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      auto itHint = bst.find(Spy(50));
+      auto it40 = bst.find(Spy(40));
+      Spy s(45);
+      Spy::reset();
+      // exercise
+      auto it = bst.insert(itHint, s);
+      // verify
+      assertUnit(Spy::numLessthan() == 2);    // check [40] and [50]
+      assertUnit(it != bst.end() && *it == Spy(45));
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      //     +----+----+     +----+----+
+      //    20        40    60        80
+      //               +--+
+      //                 45
+      assertUnit(bst.size() == 8);
+      assertUnit(it.pNode->pParent == it40.pNode);
+      assertUnit(it40.pNode->pRight == it.pNode);
+      // teardown
+      bst.clear();
+   }
 
+   // a hint of end() is an append after the largest
+   void test_insertHint_end()
+   {  // setup
+      custom::BST <Spy> bst;
+      setupStandardFixture(bst);
+      auto it80 = bst.find(Spy(80));
+      Spy s(90);
+      Spy::reset();
+      // exercise
+      auto it = bst.insert(bst.end(), s);
+      // verify
+      assertUnit(Spy::numLessthan() == 1);    // check [80]
+      assertUnit(it != bst.end() && *it == Spy(90));
+      assertUnit(it.pNode->pParent == it80.pNode);
+      assertUnit(bst.pMax == it.pNode);
+      assertUnit(bst.size() == 8);
+      // teardown
+      bst.clear();
+   }
 
+   // a hint in the wrong place still puts the element where it belongs
+   void test_insertHint_wrongHint()
+   {  // setup
+      custom::BST <int> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(value);
+      // exercise
+      auto it65 = bst.insert(bst.find(20), 65);
+      auto it10 = bst.insert(bst.end(), 10);
+      auto it55 = bst.insert(bst.begin(), 55);
+      // verify
+      assertUnit(it65 != bst.end() && *it65 == 65);
+      assertUnit(it10 != bst.end() && *it10 == 10);
+      assertUnit(it55 != bst.end() && *it55 == 55);
+      assertUnit(bst.size() == 10);
+      assertUnit(std::is_sorted(bst.begin(), bst.end()));
+      assertUnit(bst.root && bst.root->verifyRedBlack(bst.root->findDepth()));
+   }  // teardown
 
-   /***************************************
-    * Insert Move
-    *    BST::insert(T &&)
-    ***************************************/
+   // an element already on either side of the hint is not added again
+   void test_insertHint_keepUnique()
+   {  // setup
+      custom::BST <int> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(value);
+      auto it40 = bst.find(40);
+      auto it50 = bst.find(50);
+      // exercise
+      auto itBefore = bst.insert(it50, 40, true /* keepUnique */);
+      auto itAt     = bst.insert(it50, 50, true /* keepUnique */);
+      auto itDup    = bst.insert(it50, 50);
+      // verify
+      assertUnit(itBefore == it40);
+      assertUnit(itAt == it50);
+      assertUnit(itDup != it50 && itDup != bst.end() && *itDup == 50);
+      assertUnit(bst.size() == 8);
+      assertUnit(std::is_sorted(bst.begin(), bst.end()));
+   }  // teardown
 
-    // insert an element to the right of a single-element tree
-   void test_insertMove_oneRight()
+   // each element before the last one inserted: nothing is before it,
+   // so one comparison apiece
+   void test_insertHint_descending()
    {  // setup
-      //            (50) 
       custom::BST <Spy> bst;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
-      bst.root = p50;
-      bst.numElements = 1;
-      Spy s(60);
+      std::vector<Spy> values;
+      for (int i = 999; i >= 0; i--)
+         values.push_back(Spy(i));
       Spy::reset();
       // exercise
-      auto pairBST = bst.insert(std::move(s));
+      auto itHint = bst.end();
+      for (const Spy & s : values)
+         itHint = bst.insert(itHint, s);
       // verify
-      assertUnit(Spy::numLessthan() == 1);    // compare [50]
-      assertUnit(Spy::numCopyMove() == 1);    // assign move [60]
-      assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
-      assertUnit(Spy::numEquals() == 0);
-      assertUnit(Spy::numDestructor() == 0);
-      assertUnit(Spy::numDelete() == 0);
-      assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numDefault() == 0);
-      assertUnit(Spy::numNondefault() == 0);
-      assertUnit(pairBST.first != bst.end());
-      assertUnit(pairBST.second = true);
-      if (pairBST.first != bst.end())
-         assertUnit(*(pairBST.first) == Spy(60));
-      //           (50) 
-      //             +----+
-      //                 (60) 
-      assertUnit(bst.size() == 2);
-      assertUnit(bst.numElements == 2);
-      assertUnit(bst.root == p50);
+      assertUnit(Spy::numLessthan() == 999);   // check the hint, once each
+      assertUnit(bst.size() == 1000);
+      assertUnit(bst.root && bst.root->verifyRedBlack(bst.root->findDepth()));
+      int expected = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         assertUnit(*it == Spy(expected++));
+   }  // teardown
 
-      assertUnit(p50 != nullptr);
-      if (p50)
-      {
-         assertUnit(p50->data == Spy(50));
-         assertUnit(p50->pLeft == nullptr);
-         assertUnit(p50->pRight != nullptr);
-         assertUnit(p50->pParent == nullptr);
-      }
-      if (p50 && p50->pRight)
+   // hinted inserts keep the subtree sizes of a ranked tree
+   void test_insertHint_ranked()
+   {  // setup
+      custom::ranked::BST <int, custom::AVL> bst;
+      // exercise
+      for (int i = 0; i < 1000; i++)
+         bst.insert(bst.end(), i * 2);
+      for (int i = 0; i < 1000; i++)
+         bst.insert(bst.find(i * 2), i * 2 - 1);
+      // verify
+      assertUnit(bst.size() == 2000);
+      assertUnit(sizesAgree(bst));
+      assertUnit(verifyAVL(bst.root) >= 0);
+      assertUnit(bst.rank(1000) == 1001);
+      assertUnit(bst.select(0) != bst.end() && *bst.select(0) == -1);
+   }  // teardown
+
+   /***************************************
+    * Balance Policy
+    *    BST<T, A, AVL>, BST<T, A, WAVL>, BST<T, A, Treap>,
+    *    BST<T, A, Scapegoat>, BST<T, A, Unbalanced>
+    ***************************************/
+
+   // ascending keys make a perfect AVL tree: the rotations keep up
+   void test_policy_avlSorted()
+   {  // setup
+      custom::BST <int, std::allocator<int>, custom::AVL> bst;
+      // exercise
+      for (int i = 0; i < 10000; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(bst.size() == 10000);
+      assertUnit(verifyAVL(bst.root) == 14);   // ceil(log2(10001))
+      assertUnit(bst.balanceStats().singleRotations > 0);
+      assertUnit(bst.balanceStats().recolors == 0);
+      int expected = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         assertUnit(*it == expected++);
+   }  // teardown
+
+   // erasing and re-inserting in a scattered order keeps the leans right
+   void test_policy_avlChurn()
+   {  // setup
+      custom::BST <int, std::allocator<int>, custom::AVL> bst;
+      for (int i = 0; i < 5000; i++)
+         bst.insert((i * 7919) % 5000);
+      // exercise
+      for (int i = 0; i < 5000; i++)
       {
-         assertUnit(p50->pRight->data == Spy(60));
-         assertUnit(p50->pRight->pLeft == nullptr);
-         assertUnit(p50->pRight->pRight == nullptr);
-         assertUnit(p50->pRight->pParent == p50);
+         int key = (i * 104729) % 5000;
+         if (key % 3 == 0)
+            continue;
+         auto it = bst.find(key);
+         bst.erase(it);
       }
-      // teardown
-      if (p50 && p50->pRight && p50->pRight != p50)
-         delete p50->pRight;
-      if (p50)
-         delete p50;
-      bst.root = nullptr;
-      bst.numElements = 0;
-   }
-
-   // insert an element to the left of a single-element tree
-   void test_insertMove_oneLeft()
+      for (int key = 1; key < 5000; key += 3)
+         bst.insert(key);
+      // verify
+      assertUnit(bst.size() == 3334);
+      assertUnit(bst.root && bst.root->computeSize() == 3334);
+      int height = verifyAVL(bst.root);
+      assertUnit(height > 0 && height <= 17);  // 1.44 log2(3336)
+      if (bst.root)
+         bst.root->verifyBTree();
+   }  // teardown
+
+   // a sorted build labels every node with its lean, and a copy keeps
+   // them, so the next insert rebalances correctly
+   void test_policy_avlBuild()
    {  // setup
-      //            (50) 
-      custom::BST <Spy> bst;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
-      bst.root = p50;
-      bst.numElements = 1;
-      Spy s(40);
-      Spy::reset();
+      std::vector<int> values;
+      for (int i = 0; i < 1000; i++)
+         values.push_back(i);
       // exercise
-      auto pairBST = bst.insert(std::move(s));
+      custom::BST <int, std::allocator<int>, custom::AVL> bst(values.begin(), values.end(),
+                                                              custom::sorted_tag);
+      custom::BST <int, std::allocator<int>, custom::AVL> bstCopy(bst);
+      bstCopy.insert(1000);
       // verify
-      assertUnit(Spy::numLessthan() == 1);    // compare [50]
-      assertUnit(Spy::numCopyMove() == 1);    // assign move [40]
-      assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);   
-      assertUnit(Spy::numEquals() == 0);
-      assertUnit(Spy::numDestructor() == 0);
-      assertUnit(Spy::numDelete() == 0);
-      assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numDefault() == 0);
-      assertUnit(Spy::numNondefault() == 0);
-      assertUnit(s.empty() == true);
-      assertUnit(pairBST.first != bst.end());
-      assertUnit(pairBST.second = true);
-      if (pairBST.first != bst.end())
-         assertUnit(*(pairBST.first) == Spy(40));
+      assertUnit(verifyAVL(bst.root) == 10);
+      assertUnit(verifyAVL(bstCopy.root) == 11);   // the right edge was full
+      assertUnit(bst.balanceStats().singleRotations == 0);
+      assertUnit(bstCopy.size() == 1001);
+   }  // teardown
 
-      //           (50) 
-      //        +----+
-      //      (40) 
-      assertUnit(bst.size() == 2);
-      assertUnit(bst.numElements == 2);
-      assertUnit(bst.root == p50);
+   // with inserts only a WAVL tree is an AVL tree
+   void test_policy_wavlSorted()
+   {  // setup
+      custom::BST <int, std::allocator<int>, custom::WAVL> bst;
+      // exercise
+      for (int i = 0; i < 10000; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(bst.size() == 10000);
+      assertUnit(verifyWAVL(bst.root) == 13);  // the rank is the height less one
+      assertUnit(heightOf(bst) == 14);
+      assertUnit(bst.balanceStats().singleRotations > 0);
+      int expected = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         assertUnit(*it == expected++);
+   }  // teardown
 
-      assertUnit(p50 != nullptr);
-      if (p50)
+   // erasing and re-inserting in a scattered order keeps the ranks right
+   void test_policy_wavlChurn()
+   {  // setup
+      custom::BST <int, std::allocator<int>, custom::WAVL> bst;
+      for (int i = 0; i < 5000; i++)
+         bst.insert((i * 7919) % 5000);
+      // exercise
+      for (int i = 0; i < 5000; i++)
       {
-         assertUnit(p50->data == Spy(50));
-         assertUnit(p50->pLeft != nullptr);
-         assertUnit(p50->pRight == nullptr);
-         assertUnit(p50->pParent == nullptr);
+         int key = (i * 104729) % 5000;
+         if (key % 3 == 0)
+            continue;
+         auto it = bst.find(key);
+         bst.erase(it);
+         if (i % 500 == 0)
+            assertUnit(verifyWAVL(bst.root) >= 0);
       }
+      for (int key = 1; key < 5000; key += 3)
+         bst.insert(key);
+      // verify
+      assertUnit(bst.size() == 3334);
+      assertUnit(bst.root && bst.root->computeSize() == 3334);
+      int rank = verifyWAVL(bst.root);
+      assertUnit(rank >= 0 && rank <= 24);     // 2 log2(n)
+      if (bst.root)
+         bst.root->verifyBTree();
+   }  // teardown
 
-      if (p50 && p50->pLeft)
+   // a sorted build sets the ranks, and everything can then be erased
+   void test_policy_wavlBuild()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 1000; i++)
+         values.push_back(i);
+      custom::BST <int, std::allocator<int>, custom::WAVL> bst(values.begin(), values.end(),
+                                                               custom::sorted_tag);
+      assertUnit(verifyWAVL(bst.root) == 9);
+      // exercise
+      for (int i = 0; i < 1000; i++)
       {
-         assertUnit(p50->pLeft->data == Spy(40));
-         assertUnit(p50->pLeft->pLeft == nullptr);
-         assertUnit(p50->pLeft->pRight == nullptr);
-         assertUnit(p50->pLeft->pParent == p50);
+         auto it = bst.find((i * 7919) % 1000);
+         bst.erase(it);
+         assertUnit(verifyWAVL(bst.root) >= -1);
       }
+      // verify
+      assertUnit(bst.empty());
+      assertUnit(bst.root == nullptr);
+   }  // teardown
 
-      // teardown
-      if (p50 && p50->pLeft && p50->pLeft != p50)
-         delete p50->pLeft;
-      if (p50)
-         delete p50;
-      bst.root = nullptr;
-      bst.numElements = 0;
-   }
+   // a treap stays a heap on its priorities through inserts and erases
+   void test_policy_treapChurn()
+   {  // setup
+      custom::BST <int, std::allocator<int>, custom::Treap> bst;
+      for (int i = 0; i < 10000; i++)
+         bst.insert(i);
+      // exercise
+      for (int key = 0; key < 10000; key += 2)
+      {
+         auto it = bst.find(key);
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(bst.size() == 5000);
+      assertUnit(bst.root && bst.root->computeSize() == 5000);
+      assertUnit(verifyTreap(bst.root));
+      assertUnit(heightOf(bst) <= 4 * 13);
+      int expected = 1;
+      for (auto it = bst.begin(); it != bst.end(); ++it, expected += 2)
+         assertUnit(*it == expected);
+   }  // teardown
 
-   // insert a duplicate item in a BST
-   void test_insertMove_duplicate()
+   // the copy's nodes are somewhere else, so they are re-heaped
+   void test_policy_treapCopy()
    {  // setup
-      //            (50) 
-      custom::BST <Spy> bst;
-      custom::BST<Spy>::BNode* p50 = new custom::BST<Spy>::BNode(Spy(50));
-      bst.root = p50;
-      bst.numElements = 1;
-      Spy s(50);
-      Spy::reset();
+      custom::BST <int, std::allocator<int>, custom::Treap> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert(i);
       // exercise
-      auto pairBST = bst.insert(std::move(s), false /* keepUnique */);
+      custom::BST <int, std::allocator<int>, custom::Treap> bstCopy(bst);
+      std::vector<int> values;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         values.push_back(*it);
+      custom::BST <int, std::allocator<int>, custom::Treap> bstSorted;
+      bstSorted.assign_sorted(values.begin(), values.end());
       // verify
-      assertUnit(Spy::numLessthan() == 1);    // compare [50]
-      assertUnit(Spy::numCopyMove() == 1);    // assign move [50]
-      assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
-      assertUnit(Spy::numEquals() == 0);
-      assertUnit(Spy::numDestructor() == 0);
-      assertUnit(Spy::numDelete() == 0);
-      assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numDefault() == 0);
-      assertUnit(Spy::numNondefault() == 0);
-      assertUnit(s.empty() == true);
-      assertUnit(pairBST.first != bst.end());
-      assertUnit(pairBST.second = true);
-      if (pairBST.first != bst.end())
-         assertUnit(*(pairBST.first) == Spy(50));
-      //           (50) 
-      //        +----+
-      //      (50r)
-      assertUnit(bst.size() == 2);
-      assertUnit(bst.numElements == 2);
-      assertUnit(bst.root == p50);
+      assertUnit(verifyTreap(bstCopy.root));
+      assertUnit(verifyTreap(bstSorted.root));
+      assertUnit(bstCopy.size() == 1000);
+      assertUnit(bstCopy.root && bstCopy.root->computeSize() == 1000);
+      assertUnit(bstSorted.root && bstSorted.root->computeSize() == 1000);
+   }  // teardown
 
-      assertUnit(p50 != nullptr);
-      if (p50)
-      {
-         assertUnit(p50->data == Spy(50));
-         assertUnit(p50->pLeft == nullptr);
-         assertUnit(p50->pRight != nullptr);
-         assertUnit(p50->pParent == nullptr);
-      }
+   // ascending keys keep making lopsided subtrees that are rebuilt
+   void test_policy_scapegoatSorted()
+   {  // setup
+      custom::ranked::BST <int, custom::Scapegoat> bst;
+      // exercise
+      for (int i = 0; i < 10000; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(bst.size() == 10000);
+      assertUnit(heightOf(bst) <= 24);         // log3/2(n) + 1
+      assertUnit(bst.balanceStats().rebuilds > 0);
+      assertUnit(bst.balanceStats().singleRotations == 0);
+      assertUnit(sizesAgree(bst));
+      int expected = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         assertUnit(*it == expected++);
+      if (bst.root)
+         bst.root->verifyBTree();
+   }  // teardown
 
-      if (p50 && p50->pRight)
+   // erasing two thirds of the most it held rebuilds the whole tree
+   void test_policy_scapegoatErase()
+   {  // setup
+      custom::BST <int, std::allocator<int>, custom::Scapegoat> bst;
+      for (int i = 0; i < 3000; i++)
+         bst.insert((i * 7919) % 3000);
+      bst.resetBalanceStats();
+      // exercise
+      for (int key = 0; key < 1000; key++)
       {
-         assertUnit(p50->pRight->data == Spy(50));
-         assertUnit(p50->pRight->pLeft == nullptr);
-         assertUnit(p50->pRight->pRight == nullptr);
-         assertUnit(p50->pRight->pParent == p50);
+         auto it = bst.find(key);
+         bst.erase(it);
       }
+      // verify: the last erase left 2000, not below 2/3 of 3000
+      assertUnit(bst.balanceStats().rebuilds == 0);
+      auto it = bst.find(1000);
+      bst.erase(it);
+      assertUnit(bst.balanceStats().rebuilds == 1);
+      assertUnit(bst.maxElements == 1999);
+      assertUnit(heightOf(bst) == 11);         // perfectly balanced
+      if (bst.root)
+         bst.root->verifyBTree();
+   }  // teardown
 
-      // teardown
-      if (p50 && p50->pRight && p50->pRight != p50)
-         delete p50->pRight;
-      if (p50)
-         delete p50;
-      bst.root = nullptr;
-      bst.numElements = 0;
-   }
-
-   // insert an item when it already exists
-   void test_insertMove_keepUnique()
+   // no balancing at all: ascending keys make a linked list, and
+   // erase still takes any node out
+   void test_policy_unbalancedSorted()
    {  // setup
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
-      custom::BST <Spy> bst;
-      setupStandardFixture(bst);
-      Spy s(40);
-      Spy::reset();
+      custom::BST <int, std::allocator<int>, custom::Unbalanced> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert(i);
+      assertUnit(heightOf(bst) == 1000);
+      bst.insert(500);
       // exercise
-      auto pairBST = bst.insert(std::move(s), true /* keepUnique */);
+      auto it = bst.find(499);
+      bst.erase(it);
       // verify
-      assertUnit(Spy::numLessthan() == 2);    // compare [50][30]
-      assertUnit(Spy::numEquals() == 3);      // compare [50][30][40]
-      assertUnit(Spy::numCopy() == 0);
-      assertUnit(Spy::numAlloc() == 0);
-      assertUnit(Spy::numDestructor() == 0);
-      assertUnit(Spy::numDelete() == 0);
-      assertUnit(Spy::numAssign() == 0);
-      assertUnit(Spy::numDefault() == 0);
-      assertUnit(Spy::numNondefault() == 0);
-      assertUnit(Spy::numCopyMove() == 0);
-      assertUnit(Spy::numAssignMove() == 0);
-      assertUnit(s.empty() == false);
-      assertUnit(pairBST.first != bst.end());
-      assertUnit(pairBST.second == false);
-      if (pairBST.first != bst.end())
-         assertUnit(*(pairBST.first) == Spy(40));
-      //                 50 
-      //          +-------+-------+
-      //         30              70  
-      //     +----+----+     +----+----+
-      //    20        40    60        80  
-      assertStandardFixture(bst);
-      // teardown
-      teardownStandardFixture(bst);
-   }
+      assertUnit(bst.size() == 1000);
+      assertUnit(bst.balanceStats().singleRotations == 0);
+      assertUnit(bst.find(499) == bst.end());
+      if (bst.root)
+         bst.root->verifyBTree();
+   }  // teardown
 
+   // the benchmark: the same ascending inserts and scattered erases in
+   // every policy. AVL is the shallowest, red-black, WAVL and scapegoat
+   // close behind, the treap within a small factor, and no balancing
+   // at all is a list.
+   void test_policy_compareHeights()
+   {  // setup
+      custom::BST <int>                                       bstRedBlack;
+      custom::BST <int, std::allocator<int>, custom::AVL>        bstAVL;
+      custom::BST <int, std::allocator<int>, custom::WAVL>       bstWAVL;
+      custom::BST <int, std::allocator<int>, custom::Treap>      bstTreap;
+      custom::BST <int, std::allocator<int>, custom::Scapegoat>  bstScapegoat;
+      custom::BST <int, std::allocator<int>, custom::Unbalanced> bstUnbalanced;
+      // exercise
+      int heightRedBlack = churn(bstRedBlack);
+      int heightAVL = churn(bstAVL);
+      int heightWAVL = churn(bstWAVL);
+      int heightTreap = churn(bstTreap);
+      int heightScapegoat = churn(bstScapegoat);
+      int heightUnbalanced = churn(bstUnbalanced);
+      // verify: 10000 inserted, 5000 left, log2(5001) is about 12.3
+      assertUnit(heightAVL <= 17);            // 1.44 log2(n)
+      assertUnit(heightRedBlack <= 24);       // 2 log2(n)
+      assertUnit(heightAVL < heightRedBlack);
+      assertUnit(heightWAVL <= 24);           // 2 log2(n)
+      assertUnit(heightTreap <= 4 * 13);
+      assertUnit(heightScapegoat <= 24);      // log3/2(n) + 1
+      assertUnit(heightUnbalanced > 1000);
+      assertUnit(bstRedBlack.root && bstRedBlack.root->verifyRedBlack(bstRedBlack.root->findDepth()));
+      assertUnit(verifyAVL(bstAVL.root) == heightAVL);
+      assertUnit(verifyTreap(bstTreap.root));
+      assertUnit(verifyWAVL(bstWAVL.root) >= 0);
+      // WAVL erases with fewer rotations than AVL
+      assertUnit(bstWAVL.balanceStats().singleRotations + bstWAVL.balanceStats().doubleRotations <
+                 bstAVL.balanceStats().singleRotations + bstAVL.balanceStats().doubleRotations);
+      // a treap does no bookkeeping, but rotates more
+      assertUnit(bstTreap.balanceStats().singleRotations >
+                 bstAVL.balanceStats().singleRotations + bstAVL.balanceStats().doubleRotations);
+   }  // teardown
 
    /***************************************
     * Erase
@@ -2359,6 +5778,275 @@ public:
       bst.root = nullptr;
    }
 
+   /***************************************
+    * Order statistics
+    *    BST::select(k)
+    *    BST::rank(t)
+    *    BST::count_range(lo, hi)
+    *    BST::distance(first, last)
+    ***************************************/
+
+   // the k-th smallest, counting from 0
+   void test_select_standard()
+   {  // setup
+      custom::ranked::BST <int> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(value);
+      // exercise
+      auto it0 = bst.select(0);
+      auto it3 = bst.select(3);
+      auto it6 = bst.select(6);
+      auto it7 = bst.select(7);
+      // verify
+      assertUnit(it0 == bst.begin());
+      assertUnit(it3 != bst.end() && *it3 == 50);
+      assertUnit(it6 != bst.end() && *it6 == 80);
+      assertUnit(it7 == bst.end());
+   }  // teardown
+
+   // how many are less, one comparison a level
+   void test_rank_standard()
+   {  // setup
+      custom::ranked::BST <Spy> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(Spy(value));
+      Spy s20(20);
+      Spy s42(42);
+      Spy s90(90);
+      Spy::reset();
+      // exercise
+      size_t rank20 = bst.rank(s20);
+      size_t rank42 = bst.rank(s42);
+      size_t rank90 = bst.rank(s90);
+      // verify
+      assertUnit(Spy::numLessthan() == 3 + 3 + 3);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(rank20 == 0);
+      assertUnit(rank42 == 3);
+      assertUnit(rank90 == 7);
+   }  // teardown
+
+   // counting a window visits none of it
+   void test_countRange_window()
+   {  // setup
+      custom::ranked::BST <int> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert((i * 7919) % 1000);
+      // exercise and verify
+      assertUnit(bst.count_range(100, 200) == 100);
+      assertUnit(bst.count_range(-50, 50) == 50);
+      assertUnit(bst.count_range(990, 2000) == 10);
+      assertUnit(bst.count_range(200, 100) == 0);
+      assertUnit(bst.count_range(5, 5) == 0);
+   }  // teardown
+
+   // the number of steps between two iterators
+   void test_distance_standard()
+   {  // setup
+      custom::ranked::BST <int> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert((i * 7919) % 1000);
+      // exercise and verify
+      assertUnit(bst.distance(bst.begin(), bst.end()) == 1000);
+      assertUnit(bst.distance(bst.end(), bst.begin()) == -1000);
+      assertUnit(bst.distance(bst.find(250), bst.find(750)) == 500);
+      assertUnit(bst.distance(bst.find(999), bst.end()) == 1);
+      assertUnit(bst.distance(bst.select(123), bst.select(123)) == 0);
+   }  // teardown
+
+   // sizes stay right through the rotations of every policy
+   void test_sizes_churn()
+   {  // setup
+      custom::ranked::BST <int>                     bstRedBlack;
+      custom::ranked::BST <int, custom::AVL>        bstAVL;
+      custom::ranked::BST <int, custom::WAVL>       bstWAVL;
+      custom::ranked::BST <int, custom::Treap>      bstTreap;
+      custom::ranked::BST <int, custom::Scapegoat>  bstScapegoat;
+      custom::ranked::BST <int, custom::Unbalanced> bstUnbalanced;
+      // exercise
+      churn(bstRedBlack);
+      churn(bstAVL);
+      churn(bstWAVL);
+      churn(bstTreap);
+      churn(bstScapegoat);
+      churn(bstUnbalanced);
+      // verify: the odd keys are left
+      assertUnit(sizesAgree(bstRedBlack));
+      assertUnit(sizesAgree(bstAVL));
+      assertUnit(sizesAgree(bstWAVL));
+      assertUnit(sizesAgree(bstTreap));
+      assertUnit(sizesAgree(bstScapegoat));
+      assertUnit(sizesAgree(bstUnbalanced));
+      assertUnit(bstRedBlack.select(2500) != bstRedBlack.end() && *bstRedBlack.select(2500) == 5001);
+      assertUnit(bstTreap.rank(5001) == 2500);
+   }  // teardown
+
+   // trees built or copied wholesale are counted
+   void test_sizes_build()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 5000; i++)
+         values.push_back((i * 7919) % 5000);
+      custom::ranked::BST <int, custom::Treap> bstBuilt;
+      custom::ranked::BST <int, custom::Treap> bstAssigned;
+      // exercise
+      bstBuilt.build(values.begin(), values.end(), std::execution::par);
+      custom::ranked::BST <int, custom::Treap> bstCopy(bstBuilt);
+      bstAssigned = bstCopy;
+      // verify
+      assertUnit(sizesAgree(bstBuilt));
+      assertUnit(sizesAgree(bstCopy));
+      assertUnit(sizesAgree(bstAssigned));
+      assertUnit(*bstAssigned.select(4321) == 4321);
+   }  // teardown
+
+   // a node moved between trees is counted in its new one
+   void test_sizes_extract()
+   {  // setup
+      custom::ranked::BST <int> bstSrc;
+      custom::ranked::BST <int> bstDest;
+      for (int i = 0; i < 100; i++)
+      {
+         bstSrc.insert(i * 2);
+         bstDest.insert(i * 2 + 1);
+      }
+      // exercise
+      for (int i = 0; i < 50; i++)
+         bstDest.insert(bstSrc.extract(bstSrc.find(i * 4)));
+      // verify
+      assertUnit(sizesAgree(bstSrc));
+      assertUnit(sizesAgree(bstDest));
+      assertUnit(bstSrc.size() == 50);
+      assertUnit(bstDest.size() == 150);
+      assertUnit(bstDest.rank(100) == 75);
+   }  // teardown
+
+   // a tree that does not ask for sizes does not pay for them
+   void test_sizes_unranked()
+   {  // setup
+      // exercise
+      // verify
+      assertUnit(sizeof(custom::BST<void*>::BNode) == 4 * sizeof(void*));
+      assertUnit(sizeof(custom::ranked::BST<void*>::BNode) == 5 * sizeof(void*));
+   }  // teardown
+
+   /**************************************************************
+    * SIZES AGREE
+    * Every node's subtree size is its children's and one
+    *************************************************************/
+   template <class Tree>
+   bool sizesAgree(const Tree & bst)
+   {
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+      {
+         auto pNode = it.pNode;
+         size_t numLeft  = pNode->pLeft  ? pNode->pLeft->numNodes  : 0;
+         size_t numRight = pNode->pRight ? pNode->pRight->numNodes : 0;
+         if (pNode->numNodes != 1 + numLeft + numRight)
+            return false;
+      }
+      return bst.root == nullptr ? bst.size() == 0 : bst.root->numNodes == bst.size();
+   }
+
+   /**************************************************************
+    * CHURN
+    * Insert 0..9999 in order, then erase every other key in a
+    * scattered order. Returns the height of what is left.
+    *************************************************************/
+   template <class Tree>
+   int churn(Tree & bst)
+   {
+      for (int i = 0; i < 10000; i++)
+         bst.insert(i);
+      for (int i = 0; i < 10000; i++)
+      {
+         int key = (i * 7919) % 10000;
+         if (key % 2 == 0)
+         {
+            auto it = bst.find(key);
+            bst.erase(it);
+         }
+      }
+      assertUnit(bst.size() == 5000);
+      return heightOf(bst);
+   }
+
+   /**************************************************************
+    * HEIGHT OF
+    * The number of nodes on the longest path down the tree,
+    * without recursing: an unbalanced tree may be very deep
+    *************************************************************/
+   template <class Tree>
+   int heightOf(const Tree & bst)
+   {
+      int height = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+      {
+         if (it.pNode->pLeft || it.pNode->pRight)
+            continue;
+         int depth = 0;
+         for (auto p = it.pNode; p; p = p->pParent)
+            depth++;
+         height = std::max(height, depth);
+      }
+      return height;
+   }
+
+   /**************************************************************
+    * VERIFY AVL
+    * The height of the subtree, or -1 if a lean is wrong
+    *************************************************************/
+   template <class Node>
+   int verifyAVL(const Node * pNode)
+   {
+      if (pNode == nullptr)
+         return 0;
+      int left  = verifyAVL((const Node *)pNode->pLeft);
+      int right = verifyAVL((const Node *)pNode->pRight);
+      if (left < 0 || right < 0 || right - left != custom::AVL::lean(pNode))
+         return -1;
+      return std::max(left, right) + 1;
+   }
+
+   /**************************************************************
+    * VERIFY WAVL
+    * The rank of the subtree, -1 if empty, or -2 if a parity
+    * does not fit: every rank difference is 1 or 2, and a
+    * leaf's rank is 0
+    *************************************************************/
+   template <class Node>
+   int verifyWAVL(const Node * pNode)
+   {
+      if (pNode == nullptr)
+         return -1;
+      int left  = verifyWAVL((const Node *)pNode->pLeft);
+      int right = verifyWAVL((const Node *)pNode->pRight);
+      if (left < -1 || right < -1)
+         return -2;
+      int rank = std::max(left, right) + 1;
+      if ((unsigned)(rank & 1) != custom::WAVL::parity(pNode))
+         rank++;
+      if (rank - std::min(left, right) > 2 || (!pNode->pLeft && !pNode->pRight && rank != 0))
+         return -2;
+      return rank;
+   }
+
+   /**************************************************************
+    * VERIFY TREAP
+    * No node has a higher priority than its parent
+    *************************************************************/
+   template <class Node>
+   bool verifyTreap(const Node * pNode)
+   {
+      if (pNode == nullptr)
+         return true;
+      for (const Node * pChild : { (const Node *)pNode->pLeft, (const Node *)pNode->pRight })
+         if (pChild && (pChild->pParent != pNode ||
+                        custom::Treap::priority(pChild) > custom::Treap::priority(pNode)))
+            return false;
+      return verifyTreap((const Node *)pNode->pLeft) && verifyTreap((const Node *)pNode->pRight);
+   }
+
    /**************************************************************
     * SETUP STANDARD FIXTURE
     *                (50) 
@@ -2398,6 +6086,7 @@ public:
       // now assign everything to the bst
       bst.root = p50;
       bst.numElements = 7;
+      bst.pMax = p80;
    }
 
    /**************************************************************
@@ -2510,6 +6199,7 @@ public:
       }
       bst.root = nullptr;
       bst.numElements = 0;
+      bst.pMax = nullptr;
    }
 
   
@@ -0,0 +1,346 @@
+/***********************************************************************
+ * Header:
+ *    TEST FROZEN SET
+ * Summary:
+ *    Unit tests for frozenSet
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "frozenSet.h"
+#include "bst.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <algorithm>
+#include <vector>
+
+ /***********************************************
+  * TEST FROZEN SET
+  * Unit tests for the frozen_set class
+  ***********************************************/
+class TestFrozenSet : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_empty();
+      test_freeze_standard();
+      test_freeze_sizes();
+
+      // Iterator
+      test_iterator_forward();
+      test_iterator_backward();
+
+      // Find
+      test_find_standard();
+      test_find_missing();
+      test_find_fewComparisons();
+      test_lowerBound_sizes();
+      test_lowerBound_duplicates();
+
+      // Status
+      test_memory_packed();
+
+      report("FrozenSet");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // default constructor, nothing at all
+   void test_construct_default()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::frozen_set<Spy> set;
+      // verify
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(set.size() == 0);
+      assertUnit(set.empty());
+      assertUnit(set.begin() == set.end());
+   }  // teardown
+
+   // freezing an empty tree
+   void test_construct_empty()
+   {  // setup
+      custom::BST<Spy> bst;
+      Spy::reset();
+      // exercise
+      custom::frozen_set<Spy> set = bst.freeze();
+      // verify
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(set.empty());
+      assertUnit(set.begin() == set.end());
+      assertUnit(set.find(Spy(50)) == set.end());
+   }  // teardown
+
+   // the standard tree is laid out level by level
+   void test_freeze_standard()
+   {  // setup
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      //     +----+----+     +----+----+
+      //    20        40    60        80
+      custom::BST<Spy> bst;
+      setupStandard(bst);
+      Spy::reset();
+      // exercise
+      custom::frozen_set<Spy> set = bst.freeze();
+      // verify
+      assertUnit(Spy::numCopy() == 7);      // copy [20][30][40][50][60][70][80]
+      assertUnit(Spy::numLessthan() == 0);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      //    [50][30][70][20][40][60][80]
+      assertUnit(set.size() == 7);
+      assertUnit(isLayout(set, { 50, 30, 70, 20, 40, 60, 80 }));
+      assertUnit(bst.size() == 7);
+   }  // teardown
+
+   // every size from 0 to 100 comes out in order, and is a search tree
+   void test_freeze_sizes()
+   {
+      for (int n = 0; n <= 100; n++)
+      {  // setup
+         custom::BST<int> bst;
+         for (int i = 0; i < n; i++)
+            bst.insert(i);
+         // exercise
+         custom::frozen_set<int> set = bst.freeze();
+         // verify
+         assertUnit(set.size() == (size_t)n);
+         assertUnit(isSearchTree(set));
+         assertUnit(isRange(set, 0, n));
+      }  // teardown
+   }
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk forward through every shape of the bottom level
+   void test_iterator_forward()
+   {  // setup
+      custom::BST<int> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert((i * 7919) % 1000);
+      custom::frozen_set<int> set = bst.freeze();
+      std::vector<int> values;
+      // exercise
+      for (auto it = set.begin(); it != set.end(); it++)
+         values.push_back(*it);
+      // verify
+      assertUnit(values.size() == 1000);
+      for (int i = 0; i < (int)values.size(); i++)
+         assertUnit(values[i] == i);
+   }  // teardown
+
+   // walk backward from the end
+   void test_iterator_backward()
+   {
+      for (int n = 0; n <= 40; n++)
+      {  // setup
+         custom::BST<int> bst;
+         for (int i = 0; i < n; i++)
+            bst.insert(i);
+         custom::frozen_set<int> set = bst.freeze();
+         std::vector<int> values;
+         // exercise
+         auto it = set.end();
+         while (it != set.begin())
+            values.push_back(*--it);
+         // verify
+         assertUnit(values.size() == (size_t)n);
+         for (int i = 0; i < (int)values.size(); i++)
+            assertUnit(values[i] == n - 1 - i);
+      }  // teardown
+   }
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // every element can be found
+   void test_find_standard()
+   {  // setup
+      custom::BST<int> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert(i * 2);
+      custom::frozen_set<int> set = bst.freeze();
+      // exercise and verify
+      for (int i = 0; i < 1000; i++)
+      {
+         auto it = set.find(i * 2);
+         assertUnit(it != set.end());
+         if (it != set.end())
+            assertUnit(*it == i * 2);
+      }
+   }  // teardown
+
+   // the gaps, and both sides of the ends, are not found
+   void test_find_missing()
+   {  // setup
+      custom::BST<int> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert(i * 2);
+      custom::frozen_set<int> set = bst.freeze();
+      // exercise and verify
+      assertUnit(set.find(-1) == set.end());
+      assertUnit(set.find(2000) == set.end());
+      for (int i = 0; i < 1000; i++)
+         assertUnit(set.find(i * 2 + 1) == set.end());
+   }  // teardown
+
+   // one less-than per level and a single equals at the end
+   void test_find_fewComparisons()
+   {  // setup
+      //    [50][30][70][20][40][60][80]
+      custom::BST<Spy> bst;
+      setupStandard(bst);
+      custom::frozen_set<Spy> set = bst.freeze();
+      Spy s(20);
+      Spy::reset();
+      // exercise
+      auto it = set.find(s);
+      // verify
+      assertUnit(Spy::numLessthan() == 3);    // compare [50][30][20]
+      assertUnit(Spy::numEquals() == 1);      // check [20]
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(it != set.end());
+      if (it != set.end())
+         assertUnit(*it == Spy(20));
+   }  // teardown
+
+   // agrees with std::lower_bound for every size and every value
+   void test_lowerBound_sizes()
+   {
+      for (int n = 0; n <= 50; n++)
+      {  // setup
+         custom::BST<int> bst;
+         std::vector<int> sorted;
+         for (int i = 0; i < n; i++)
+         {
+            bst.insert(i * 3);
+            sorted.push_back(i * 3);
+         }
+         custom::frozen_set<int> set = bst.freeze();
+         // exercise and verify
+         for (int value = -1; value <= n * 3; value++)
+         {
+            auto itExpected = std::lower_bound(sorted.begin(), sorted.end(), value);
+            auto it = set.lower_bound(value);
+            if (itExpected == sorted.end())
+               assertUnit(it == set.end());
+            else
+               assertUnit(it != set.end() && *it == *itExpected);
+         }
+      }  // teardown
+   }
+
+   // a tree that allows duplicates keeps them, and lower_bound
+   // finds the first one
+   void test_lowerBound_duplicates()
+   {  // setup
+      custom::BST<int> bst;
+      for (int i = 0; i < 100; i++)
+         bst.insert(i / 4);
+      custom::frozen_set<int> set = bst.freeze();
+      // exercise
+      auto it = set.lower_bound(10);
+      // verify
+      assertUnit(set.size() == 100);
+      int numBefore = 0;
+      for (auto itCount = set.begin(); itCount != it; ++itCount)
+         numBefore++;
+      assertUnit(numBefore == 40);
+      assertUnit(it != set.end() && *it == 10);
+   }  // teardown
+
+   /***************************************
+    * STATUS
+    ***************************************/
+
+   // one element after another, no pointers
+   void test_memory_packed()
+   {  // setup
+      custom::BST<int> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert(i);
+      // exercise
+      custom::frozen_set<int> set = bst.freeze();
+      // verify
+      assertUnit(set.elements.capacity() == 1000);
+      assertUnit(sizeof(set) == sizeof(std::vector<int>));
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD
+    *************************************************************/
+   void setupStandard(custom::BST<Spy> & bst)
+   {
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(Spy(value));
+   }
+
+   /*************************************************************
+    * IS LAYOUT
+    * The array holds exactly these values, in this order
+    *************************************************************/
+   template <class T>
+   bool isLayout(const custom::frozen_set<T> & set, std::initializer_list<int> values)
+   {
+      if (set.elements.size() != values.size())
+         return false;
+      size_t i = 0;
+      for (int value : values)
+         if (!(set.elements[i++] == T(value)))
+            return false;
+      return true;
+   }
+
+   /*************************************************************
+    * IS SEARCH TREE
+    * Each element is between its children
+    *************************************************************/
+   template <class T>
+   bool isSearchTree(const custom::frozen_set<T> & set)
+   {
+      size_t n = set.elements.size();
+      for (size_t k = 1; k <= n; k++)
+      {
+         if (2 * k <= n && set.elements[k - 1] < set.elements[2 * k - 1])
+            return false;
+         if (2 * k + 1 <= n && set.elements[2 * k] < set.elements[k - 1])
+            return false;
+      }
+      return true;
+   }
+
+   /*************************************************************
+    * IS RANGE
+    * In order, the elements are first, first + 1, ... last - 1
+    *************************************************************/
+   bool isRange(const custom::frozen_set<int> & set, int first, int last)
+   {
+      int expected = first;
+      for (auto it = set.begin(); it != set.end(); ++it)
+         if (*it != expected++)
+            return false;
+      return expected == last;
+   }
+};
+
+#endif // DEBUG
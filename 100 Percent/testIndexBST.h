@@ -0,0 +1,428 @@
+/***********************************************************************
+ * Header:
+ *    TEST INDEX BST
+ * Summary:
+ *    Unit tests for indexBST
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "indexBST.h"
+#include "unitTest.h"
+#include "spy.h"
+
+#include <algorithm>  // for std::max
+#include <vector>
+
+ /***********************************************
+  * TEST INDEX BST
+  * Unit tests for the IndexBST class
+  ***********************************************/
+class TestIndexBST : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_fromBST();
+      test_construct_fromBSTSizes();
+      test_constructCopy_standard();
+
+      // Iterator
+      test_iterator_forward();
+      test_iterator_backward();
+
+      // Find
+      test_find_standard();
+      test_find_missing();
+
+      // Insert
+      test_insert_leftRight();
+      test_insert_keepUnique();
+      test_insert_sortedStaysBalanced();
+
+      // Remove
+      test_erase_noChildren();
+      test_erase_twoChildren();
+      test_erase_relocatesLast();
+      test_erase_churnStaysRedBlack();
+
+      // Status
+      test_node_size();
+
+      report("IndexBST");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // default constructor, no allocations
+   void test_construct_default()
+   {  // setup
+      Spy::reset();
+      // exercise
+      custom::IndexBST<Spy> bst;
+      // verify
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(bst.root == custom::IndexBST<Spy>::NIL);
+      assertUnit(bst.nodes.empty());
+      assertUnit(bst.nodes.capacity() == 0);
+      assertUnit(bst.size() == 0);
+      assertUnit(bst.empty());
+   }  // teardown
+
+   // a pointer tree becomes a balanced index tree in sorted order
+   void test_construct_fromBST()
+   {  // setup
+      custom::BST<int> src;
+      for (int i = 10; i <= 70; i += 10)
+         src.insert(i);   // in order
+      // exercise
+      custom::IndexBST<int> bst(src);
+      // verify
+      //                (40)
+      //          +-------+-------+
+      //        (20)            (60)
+      //     +----+----+     +----+----+
+      //   (10)      (30)  (50)      (70)
+      assertUnit(bst.size() == 7);
+      assertStandard(bst);
+      for (int i = 0; i < 7; i++)
+         assertUnit(bst.nodes[i].data == (i + 1) * 10);
+   }  // teardown
+
+   // every size is built as a valid red-black tree
+   void test_construct_fromBSTSizes()
+   {
+      for (int n = 0; n <= 100; n++)
+      {  // setup
+         custom::BST<int> src;
+         for (int i = 0; i < n; i++)
+            src.insert(i);
+         // exercise
+         custom::IndexBST<int> bst(src);
+         // verify
+         assertUnit(bst.size() == (size_t)n);
+         assertUnit(blackHeight(bst, bst.root) >= 0);
+      }  // teardown
+   }
+
+   // copying the tree copies the vector and nothing else
+   void test_constructCopy_standard()
+   {  // setup
+      custom::IndexBST<int> bstSrc;
+      setupStandard(bstSrc);
+      // exercise
+      custom::IndexBST<int> bstDest(bstSrc);
+      // verify
+      assertStandard(bstSrc);
+      assertStandard(bstDest);
+      assertUnit(bstSrc.nodes.data() != bstDest.nodes.data());
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk forward through the standard fixture
+   void test_iterator_forward()
+   {  // setup
+      custom::IndexBST<int> bst;
+      setupStandard(bst);
+      std::vector<int> values;
+      // exercise
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         values.push_back(*it);
+      // verify
+      assertUnit(values == std::vector<int>({ 10, 20, 30, 40, 50, 60, 70 }));
+   }  // teardown
+
+   // walk backward from the end
+   void test_iterator_backward()
+   {  // setup
+      custom::IndexBST<int> bst;
+      setupStandard(bst);
+      std::vector<int> values;
+      auto it = bst.end();
+      // exercise
+      while (it != bst.begin())
+         values.push_back(*--it);
+      // verify
+      assertUnit(values == std::vector<int>({ 70, 60, 50, 40, 30, 20, 10 }));
+   }  // teardown
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // find a leaf of the standard fixture
+   void test_find_standard()
+   {  // setup
+      custom::IndexBST<int> bst;
+      setupStandard(bst);
+      // exercise
+      auto it = bst.find(50);
+      // verify
+      assertUnit(it != bst.end());
+      if (it != bst.end())
+         assertUnit(*it == 50);
+   }  // teardown
+
+   // look for something that is not there
+   void test_find_missing()
+   {  // setup
+      custom::IndexBST<int> bst;
+      setupStandard(bst);
+      // exercise
+      auto it = bst.find(55);
+      // verify
+      assertUnit(it == bst.end());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // new nodes are appended and linked by index
+   void test_insert_leftRight()
+   {  // setup
+      custom::IndexBST<Spy> bst;
+      Spy::reset();
+      // exercise
+      bst.insert(Spy(50));
+      bst.insert(Spy(40));
+      auto pairBST = bst.insert(Spy(60));
+      // verify
+      //            (50)
+      //        +----+----+
+      //      (40)      (60)
+      assertUnit(Spy::numLessthan() == 2);
+      assertUnit(Spy::numEquals() == 0);
+      assertUnit(pairBST.second == true);
+      assertUnit(pairBST.first.index == 2);
+      assertUnit(bst.size() == 3);
+      assertUnit(bst.root == 0);
+      assertUnit(bst.nodes[0].left == 1);
+      assertUnit(bst.nodes[0].right == 2);
+      assertUnit(bst.nodes[1].parent == 0);
+      assertUnit(bst.nodes[2].parent == 0);
+      assertUnit(bst.nodes[1].data == Spy(40));
+      assertUnit(bst.nodes[2].data == Spy(60));
+   }  // teardown
+
+   // a duplicate is refused when asked to keep things unique
+   void test_insert_keepUnique()
+   {  // setup
+      custom::IndexBST<int> bst;
+      setupStandard(bst);
+      // exercise
+      auto pairBST = bst.insert(30, true /* keepUnique */);
+      // verify
+      assertUnit(pairBST.second == false);
+      assertUnit(pairBST.first == bst.find(30));
+      assertStandard(bst);
+   }  // teardown
+
+   // ascending keys no longer make a stick
+   void test_insert_sortedStaysBalanced()
+   {  // setup
+      custom::IndexBST<int> bst;
+      // exercise
+      for (int i = 0; i < 10000; i++)
+         bst.insert(i);
+      // verify
+      assertUnit(bst.size() == 10000);
+      assertUnit(blackHeight(bst, bst.root) >= 0);
+      assertUnit(height(bst, bst.root) <= 2 * 14);   // 2 log2(n + 1)
+      int expected = 0;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         assertUnit(*it == expected++);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // remove a leaf
+   void test_erase_noChildren()
+   {  // setup
+      custom::IndexBST<int> bst;
+      setupStandard(bst);
+      auto it = bst.find(50);
+      // exercise
+      auto itReturn = bst.erase(it);
+      // verify
+      assertUnit(itReturn != bst.end());
+      if (itReturn != bst.end())
+         assertUnit(*itReturn == 60);
+      assertUnit(bst.size() == 6);
+      assertUnit(bst.find(50) == bst.end());
+      assertValues(bst, { 10, 20, 30, 40, 60, 70 });
+   }  // teardown
+
+   // remove the root, which has two children
+   void test_erase_twoChildren()
+   {  // setup
+      custom::IndexBST<int> bst;
+      setupStandard(bst);
+      auto it = bst.find(40);
+      // exercise
+      auto itReturn = bst.erase(it);
+      // verify
+      assertUnit(itReturn != bst.end());
+      if (itReturn != bst.end())
+         assertUnit(*itReturn == 50);
+      assertUnit(bst.size() == 6);
+      assertUnit(bst.nodes[bst.root].data == 50);
+      assertValues(bst, { 10, 20, 30, 50, 60, 70 });
+   }  // teardown
+
+   // the last node in the vector fills the hole
+   void test_erase_relocatesLast()
+   {  // setup
+      custom::IndexBST<int> bst;
+      setupStandard(bst);
+      assertUnit(bst.nodes.back().data == 70);
+      auto it = bst.find(10);      // the fourth node inserted
+      assertUnit(it.index == 3);
+      // exercise
+      bst.erase(it);
+      // verify
+      assertUnit(bst.nodes.size() == 6);
+      assertUnit(bst.nodes[3].data == 70);
+      assertUnit(bst.find(70).index == 3);
+      assertValues(bst, { 20, 30, 40, 50, 60, 70 });
+   }  // teardown
+
+   // erasing in a scattered order keeps the tree red-black while the
+   // last node keeps moving into the holes
+   void test_erase_churnStaysRedBlack()
+   {  // setup
+      custom::IndexBST<int> bst;
+      for (int i = 0; i < 2000; i++)
+         bst.insert((i * 7919) % 2000);
+      // exercise
+      for (int i = 0; i < 2000; i += 2)
+      {
+         auto it = bst.find((i * 7919) % 2000);
+         bst.erase(it);
+      }
+      // verify
+      assertUnit(bst.size() == 1000);
+      assertUnit(blackHeight(bst, bst.root) >= 0);
+      assertUnit(height(bst, bst.root) <= 2 * 10);   // 2 log2(n + 1)
+      std::vector<bool> erased(2000, false);
+      for (int i = 0; i < 2000; i += 2)
+         erased[(i * 7919) % 2000] = true;
+      std::vector<int> expected;
+      for (int value = 0; value < 2000; value++)
+         if (!erased[value])
+            expected.push_back(value);
+      assertValues(bst, expected);
+   }  // teardown
+
+   /***************************************
+    * STATUS
+    ***************************************/
+
+   // three 32-bit links instead of three pointers
+   void test_node_size()
+   {
+      assertUnit(sizeof(custom::IndexBST<int>::Node) == 16);
+   }
+
+   /**************************************************************
+    * SETUP STANDARD FIXTURE
+    *                (40)
+    *          +-------+-------+
+    *        (20)            (60)
+    *     +----+----+     +----+----+
+    *   (10)      (30)  (50)      (70)
+    *************************************************************/
+   void setupStandard(custom::IndexBST<int> & bst)
+   {
+      for (int value : { 40, 20, 60, 10, 30, 50, 70 })
+         bst.insert(value);
+   }
+
+   /**************************************************************
+    * VERIFY STANDARD FIXTURE
+    *************************************************************/
+   void assertStandard(const custom::IndexBST<int> & bst)
+   {
+      assertUnit(bst.size() == 7);
+      assertUnit(bst.root != custom::IndexBST<int>::NIL);
+      if (bst.root == custom::IndexBST<int>::NIL)
+         return;
+      auto & n = bst.nodes;
+      auto p40 = bst.root;
+      assertUnit(n[p40].data == 40);
+      assertUnit(n[p40].parent == custom::IndexBST<int>::NIL);
+      auto p20 = n[p40].left;
+      auto p60 = n[p40].right;
+      assertUnit(n[p20].data == 20 && n[p20].parent == p40);
+      assertUnit(n[p60].data == 60 && n[p60].parent == p40);
+      assertUnit(n[n[p20].left].data  == 10 && n[n[p20].left].parent  == p20);
+      assertUnit(n[n[p20].right].data == 30 && n[n[p20].right].parent == p20);
+      assertUnit(n[n[p60].left].data  == 50 && n[n[p60].left].parent  == p60);
+      assertUnit(n[n[p60].right].data == 70 && n[n[p60].right].parent == p60);
+      assertValues(bst, { 10, 20, 30, 40, 50, 60, 70 });
+   }
+
+   /**************************************************************
+    * BLACK HEIGHT
+    * The black height below i, or -1 if a red node has a red
+    * child, the paths disagree, or a parent link is wrong
+    *************************************************************/
+   int blackHeight(const custom::IndexBST<int> & bst, std::uint32_t i)
+   {
+      if (i == custom::IndexBST<int>::NIL)
+         return 0;
+      auto & n = bst.nodes;
+      if (i == bst.root && n[i].parent.isRed())
+         return -1;
+      for (std::uint32_t child : { n[i].left, n[i].right })
+         if (child != custom::IndexBST<int>::NIL &&
+             (n[child].parent != i || (n[i].parent.isRed() && n[child].parent.isRed())))
+            return -1;
+      int left  = blackHeight(bst, n[i].left);
+      int right = blackHeight(bst, n[i].right);
+      if (left < 0 || left != right)
+         return -1;
+      return left + (n[i].parent.isRed() ? 0 : 1);
+   }
+
+   /**************************************************************
+    * HEIGHT
+    * Levels from i to the deepest leaf below it
+    *************************************************************/
+   int height(const custom::IndexBST<int> & bst, std::uint32_t i)
+   {
+      if (i == custom::IndexBST<int>::NIL)
+         return 0;
+      return 1 + std::max(height(bst, bst.nodes[i].left), height(bst, bst.nodes[i].right));
+   }
+
+   /**************************************************************
+    * VERIFY VALUES
+    * In-order walk matches the expected values
+    *************************************************************/
+   void assertValues(const custom::IndexBST<int> & bst, const std::vector<int> & expected)
+   {
+      std::vector<int> values;
+      for (auto it = bst.begin(); it != bst.end(); ++it)
+         values.push_back(*it);
+      assertUnit(values == expected);
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,482 @@
+/***********************************************************************
+ * Header:
+ *    TEST MAPPED BST
+ * Summary:
+ *    Unit tests for mappedBST
+ * Author
+ *    Jonathan Gunderson and Sulav Dahal
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mappedBST.h"
+#include "unitTest.h"
+
+#include <cstddef>    // for offsetof
+#include <cstdio>     // for std::remove
+#include <cstring>    // for std::memcpy
+#include <fstream>
+#include <vector>
+
+ /***********************************************
+  * TEST MAPPED BST
+  * Unit tests for the MappedBST class
+  ***********************************************/
+class TestMappedBST : public UnitTest
+{
+   // orders ints largest first, all in one call
+   struct Descending
+   {
+      typedef void is_three_way;
+      int operator () (int lhs, int rhs) const
+      {
+         return lhs > rhs ? -1 : (rhs > lhs ? 1 : 0);
+      }
+   };
+
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructMove_standard();
+
+      // Save and load
+      test_save_standard();
+      test_save_empty();
+      test_save_ranked();
+      test_save_comparator();
+      test_open_missing();
+      test_open_wrongType();
+      test_open_truncated();
+      test_open_notAnImage();
+      test_open_wrongRoot();
+      test_close_standard();
+
+      // Iterator
+      test_iterator_forward();
+      test_iterator_backward();
+
+      // Find
+      test_find_standard();
+      test_find_missing();
+      test_find_scrambled();
+
+      report("MappedBST");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // default constructor, nothing mapped
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::MappedBST<int> tree;
+      // verify
+      assertUnit(!tree.is_open());
+      assertUnit(tree.pImage == nullptr);
+      assertUnit(tree.size() == 0);
+      assertUnit(tree.empty());
+      assertUnit(tree.begin() == tree.end());
+      assertUnit(tree.find(50) == tree.end());
+   }  // teardown
+
+   // moving hands over the mapping
+   void test_constructMove_standard()
+   {  // setup
+      saveStandard();
+      custom::MappedBST<int> src(PATH);
+      const unsigned char * pImage = src.pImage;
+      // exercise
+      custom::MappedBST<int> dest(std::move(src));
+      // verify
+      assertUnit(!src.is_open());
+      assertUnit(src.empty());
+      assertUnit(dest.is_open());
+      assertUnit(dest.pImage == pImage);
+      assertUnit(dest.size() == 7);
+      assertUnit(dest.find(40) != dest.end());
+      // teardown
+      dest.close();
+      std::remove(PATH);
+   }
+
+   /***************************************
+    * SAVE AND LOAD
+    ***************************************/
+
+   // the nodes are in order with a balanced tree over them
+   void test_save_standard()
+   {  // setup
+      //                 50
+      //          +-------+-------+
+      //         30              70
+      //     +----+----+     +----+----+
+      //    20        40    60        80
+      custom::BST<int> bst;
+      for (int value : { 80, 70, 60, 50, 40, 30, 20 })
+         bst.insert(value);
+      // exercise
+      bool saved = custom::MappedBST<int>::save(bst, PATH);
+      custom::MappedBST<int> tree(PATH);
+      // verify
+      assertUnit(saved);
+      assertUnit(tree.is_open());
+      assertUnit(tree.size() == 7);
+      assertUnit(tree.numBytes == 64 + 7 * sizeof(custom::MappedBST<int>::Node));
+      //    [20][30][40][50][60][70][80]
+      //     0   1   2   3   4   5   6
+      assertUnit(sizeof(custom::MappedBST<int>::Node) == sizeof(int));
+      assertUnit(rootOf(tree) == 3);
+      assertUnit(isNode(tree, 3, 50));
+      assertUnit(isNode(tree, 1, 30));
+      assertUnit(isNode(tree, 5, 70));
+      assertUnit(isNode(tree, 0, 20));
+      assertUnit(isNode(tree, 2, 40));
+      assertUnit(isNode(tree, 4, 60));
+      assertUnit(isNode(tree, 6, 80));
+      // the nodes are read from the file, not copied
+      assertUnit((const unsigned char *)tree.pNodes == tree.pImage + 64);
+      // teardown
+      tree.close();
+      std::remove(PATH);
+   }
+
+   // an empty tree is just the header
+   void test_save_empty()
+   {  // setup
+      custom::BST<int> bst;
+      // exercise
+      bool saved = custom::MappedBST<int>::save(bst, PATH);
+      custom::MappedBST<int> tree(PATH);
+      // verify
+      assertUnit(saved);
+      assertUnit(tree.is_open());
+      assertUnit(tree.empty());
+      assertUnit(tree.numBytes == 64);
+      assertUnit(rootOf(tree) == NIL);
+      assertUnit(tree.begin() == tree.end());
+      assertUnit(tree.find(50) == tree.end());
+      // teardown
+      tree.close();
+      std::remove(PATH);
+   }
+
+   // a tree that counts its subtrees saves the same nodes
+   void test_save_ranked()
+   {  // setup
+      custom::ranked::BST<int> bst;
+      for (int value : { 80, 70, 60, 50, 40, 30, 20 })
+         bst.insert(value);
+      // exercise
+      bool saved = custom::MappedBST<int>::save(bst, PATH);
+      custom::MappedBST<int> tree(PATH);
+      // verify
+      assertUnit(saved);
+      assertUnit(tree.size() == 7);
+      assertUnit(tree.numBytes == 64 + 7 * sizeof(int));
+      assertUnit(isNode(tree, 0, 20));
+      assertUnit(isNode(tree, 3, 50));
+      assertUnit(isNode(tree, 6, 80));
+      assertUnit(tree.find(40) != tree.end());
+      assertUnit(tree.find(45) == tree.end());
+      // teardown
+      tree.close();
+      std::remove(PATH);
+   }
+
+   // the nodes keep the tree's order and are searched with its comparator
+   void test_save_comparator()
+   {  // setup
+      custom::BST<int, std::allocator<int>, custom::RedBlack, Descending> bst;
+      for (int value : { 20, 30, 40, 50, 60, 70, 80 })
+         bst.insert(value);
+      // exercise
+      bool saved = custom::MappedBST<int, Descending>::save(bst, PATH);
+      custom::MappedBST<int, Descending> tree(PATH);
+      // verify
+      assertUnit(saved);
+      assertUnit(tree.size() == 7);
+      //    [80][70][60][50][40][30][20]
+      //     0   1   2   3   4   5   6
+      assertUnit(tree.pNodes[0].data == 80);
+      assertUnit(tree.pNodes[3].data == 50);
+      assertUnit(tree.pNodes[6].data == 20);
+      for (int value : { 20, 30, 40, 50, 60, 70, 80 })
+      {
+         auto it = tree.find(value);
+         assertUnit(it != tree.end());
+         if (it != tree.end())
+            assertUnit(*it == value);
+      }
+      assertUnit(tree.find(45) == tree.end());
+      assertUnit(tree.find(90) == tree.end());
+      assertUnit(tree.find(10) == tree.end());
+      // teardown
+      tree.close();
+      std::remove(PATH);
+   }
+
+   // there is no such file
+   void test_open_missing()
+   {  // setup
+      std::remove(PATH);
+      custom::MappedBST<int> tree;
+      // exercise
+      bool opened = tree.open(PATH);
+      // verify
+      assertUnit(!opened);
+      assertUnit(!tree.is_open());
+      assertUnit(tree.empty());
+   }  // teardown
+
+   // a tree of doubles does not open as a tree of ints
+   void test_open_wrongType()
+   {  // setup
+      custom::BST<double> bst;
+      bst.insert(3.14);
+      custom::MappedBST<double>::save(bst, PATH);
+      custom::MappedBST<int> tree;
+      // exercise
+      bool opened = tree.open(PATH);
+      // verify
+      assertUnit(!opened);
+      assertUnit(!tree.is_open());
+      assertUnit(tree.empty());
+      // teardown
+      std::remove(PATH);
+   }
+
+   // a file cut short in the middle of the nodes
+   void test_open_truncated()
+   {  // setup
+      saveStandard();
+      std::vector<char> bytes = readFile();
+      bytes.resize(bytes.size() - 4);
+      writeFile(bytes);
+      custom::MappedBST<int> tree;
+      // exercise
+      bool opened = tree.open(PATH);
+      // verify
+      assertUnit(!opened);
+      assertUnit(!tree.is_open());
+      // teardown
+      std::remove(PATH);
+   }
+
+   // some other file entirely
+   void test_open_notAnImage()
+   {  // setup
+      writeFile(std::vector<char>(200, 'x'));
+      custom::MappedBST<int> tree;
+      // exercise
+      bool opened = tree.open(PATH);
+      // verify
+      assertUnit(!opened);
+      assertUnit(!tree.is_open());
+      // teardown
+      std::remove(PATH);
+   }
+
+   // a root that is not the middle node is refused
+   void test_open_wrongRoot()
+   {  // setup
+      saveStandard();
+      std::vector<char> bytes = readFile();
+      std::uint32_t root = 0x7FFFFFFF;
+      std::memcpy(bytes.data() + offsetof(Header, root), &root, sizeof(root));
+      writeFile(bytes);
+      custom::MappedBST<int> tree;
+      // exercise
+      bool opened = tree.open(PATH);
+      // verify
+      assertUnit(!opened);
+      assertUnit(!tree.is_open());
+      // teardown
+      std::remove(PATH);
+   }
+
+   // closing unmaps and empties
+   void test_close_standard()
+   {  // setup
+      saveStandard();
+      custom::MappedBST<int> tree(PATH);
+      // exercise
+      tree.close();
+      // verify
+      assertUnit(!tree.is_open());
+      assertUnit(tree.pImage == nullptr);
+      assertUnit(tree.empty());
+      assertUnit(tree.begin() == tree.end());
+      // teardown
+      std::remove(PATH);
+   }
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // walk forward
+   void test_iterator_forward()
+   {  // setup
+      saveThousand();
+      custom::MappedBST<int> tree(PATH);
+      std::vector<int> values;
+      // exercise
+      for (auto it = tree.begin(); it != tree.end(); it++)
+         values.push_back(*it);
+      // verify
+      assertUnit(values.size() == 1000);
+      for (int i = 0; i < (int)values.size(); i++)
+         assertUnit(values[i] == i * 2);
+      // teardown
+      tree.close();
+      std::remove(PATH);
+   }
+
+   // walk backward
+   void test_iterator_backward()
+   {  // setup
+      saveThousand();
+      custom::MappedBST<int> tree(PATH);
+      std::vector<int> values;
+      // exercise
+      auto it = tree.end();
+      while (it != tree.begin())
+         values.push_back(*--it);
+      // verify
+      assertUnit(values.size() == 1000);
+      for (int i = 0; i < (int)values.size(); i++)
+         assertUnit(values[i] == (999 - i) * 2);
+      // teardown
+      tree.close();
+      std::remove(PATH);
+   }
+
+   /***************************************
+    * FIND
+    ***************************************/
+
+   // every element can be found
+   void test_find_standard()
+   {  // setup
+      saveThousand();
+      custom::MappedBST<int> tree(PATH);
+      // exercise and verify
+      for (int i = 0; i < 1000; i++)
+      {
+         auto it = tree.find(i * 2);
+         assertUnit(it != tree.end());
+         if (it != tree.end())
+            assertUnit(*it == i * 2);
+      }
+      // teardown
+      tree.close();
+      std::remove(PATH);
+   }
+
+   // the gaps are not found
+   void test_find_missing()
+   {  // setup
+      saveThousand();
+      custom::MappedBST<int> tree(PATH);
+      // exercise and verify
+      assertUnit(tree.find(-1) == tree.end());
+      assertUnit(tree.find(2000) == tree.end());
+      for (int i = 0; i < 1000; i++)
+         assertUnit(tree.find(i * 2 + 1) == tree.end());
+      // teardown
+      tree.close();
+      std::remove(PATH);
+   }
+
+   // nodes overwritten out of order cannot send a search out of the file
+   void test_find_scrambled()
+   {  // setup
+      saveThousand();
+      std::vector<char> bytes = readFile();
+      for (size_t i = 64; i + sizeof(int) <= bytes.size(); i += sizeof(int))
+      {
+         int garbage = (int)((i * 2654435761u) % 4000) - 1000;
+         std::memcpy(bytes.data() + i, &garbage, sizeof(garbage));
+      }
+      writeFile(bytes);
+      custom::MappedBST<int> tree(PATH);
+      assertUnit(tree.is_open());
+      // exercise and verify
+      for (int i = -1000; i < 3000; i++)
+      {
+         auto it = tree.find(i);
+         assertUnit(it == tree.end() || (it.pNode >= tree.pNodes &&
+                                         it.pNode < tree.pNodes + tree.size() &&
+                                         *it == i));
+      }
+      // teardown
+      tree.close();
+      std::remove(PATH);
+   }
+
+   /*************************************************************
+    * SETUP
+    *************************************************************/
+   static constexpr const char * PATH = "testMappedBST.img";
+   static constexpr std::uint32_t NIL = 0xFFFFFFFF;
+   typedef custom::MappedBST<int>::Header Header;
+
+   void saveStandard()
+   {
+      custom::BST<int> bst;
+      for (int value : { 50, 30, 70, 20, 40, 60, 80 })
+         bst.insert(value);
+      custom::MappedBST<int>::save(bst, PATH);
+   }
+
+   void saveThousand()
+   {
+      custom::BST<int> bst;
+      for (int i = 0; i < 1000; i++)
+         bst.insert(((i * 7919) % 1000) * 2);
+      custom::MappedBST<int>::save(bst, PATH);
+   }
+
+   std::vector<char> readFile()
+   {
+      std::ifstream fin(PATH, std::ios::binary);
+      return std::vector<char>(std::istreambuf_iterator<char>(fin),
+                               std::istreambuf_iterator<char>());
+   }
+
+   void writeFile(const std::vector<char> & bytes)
+   {
+      std::ofstream fout(PATH, std::ios::binary | std::ios::trunc);
+      fout.write(bytes.data(), bytes.size());
+   }
+
+   /*************************************************************
+    * IS NODE
+    * The node at i holds this value
+    *************************************************************/
+   bool isNode(const custom::MappedBST<int> & tree, size_t i, int value)
+   {
+      return i < tree.size() && tree.pNodes[i].data == value;
+   }
+
+   /*************************************************************
+    * ROOT OF
+    * The root recorded in the header of the open file
+    *************************************************************/
+   std::uint32_t rootOf(const custom::MappedBST<int> & tree)
+   {
+      Header h;
+      std::memcpy(&h, tree.pImage, sizeof(h));
+      return h.root;
+   }
+};
+
+#endif // DEBUG